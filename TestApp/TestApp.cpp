@@ -14,6 +14,7 @@
 #include "biome_core/SystemInfo/SystemInfo.h"
 #include "biome_core/Memory/VirtualMemoryAllocator.h"
 #include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Memory/AllocationTrace.h"
 #include "biome_core/Threading/WorkerThread.h"
 #include "biome_core/Threading/WorkerTask.h"
 #include "biome_core/Threading/WorkerThreadPool.h"
@@ -307,6 +308,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
     while (!biome::rhi::events::PumpMessages())
     {
+        BIOME_ALLOCATION_TAG("Frame");
+
         camera.FrameMove(timer.GetElapsedSecondsSinceLastCall());
 
         device::StartFrame(deviceHdl);
@@ -380,6 +383,13 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     device::DestroyGfxPipeline(gfxPipeHdl);
     device::DestroyShaderResourceLayout(rscLayoutHdl);
     device::DestroySwapChain(swapChainHdl);
+    device::DestroyTexture(deviceHdl, depthBufferHdl);
+    device::DestroyTexture(deviceHdl, textureHdl);
+    device::DestroyBuffer(deviceHdl, constantBufferHdl);
+    device::DestroyBuffer(deviceHdl, vertexBufferUvHdl);
+    device::DestroyBuffer(deviceHdl, vertexBufferNormalHdl);
+    device::DestroyBuffer(deviceHdl, vertexBufferPosHdl);
+    device::DestroyBuffer(deviceHdl, indexBufferHdl);
     device::DestroyDevice(deviceHdl);
 
     return 0;
@@ -2,7 +2,12 @@
 #include "AssetDatabaseBuilder.h"
 #include "biome_core/Memory/ThreadHeapAllocator.h"
 #include "biome_core/Memory/ThreadHeapSmartPointer.h"
+#include "biome_core/Memory/AllocationTrace.h"
+#include "biome_core/Memory/ScopedArena.h"
 #include "biome_core/FileSystem/FileSystem.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+#include "biome_core/Threading/TaskCounter.h"
+#include "biome_core/Threading/Parallel.h"
 #include "biome_core/Assets/AssetDatabase.h"
 #include "biome_core/Assets/Texture.h"
 #include "rapidjson/document.h"
@@ -14,6 +19,7 @@ using namespace biome;
 using namespace biome::asset;
 using namespace biome::memory;
 using namespace biome::filesystem;
+using namespace biome::threading;
 
 template<typename T>
 static bool AssetDatabaseBuilder::WriteData(const T& value, FILE* pFile)
@@ -23,9 +29,15 @@ static bool AssetDatabaseBuilder::WriteData(const T& value, FILE* pFile)
 
 bool AssetDatabaseBuilder::BuildDatabase(const char* pSrcPath, const char* pDstPath)
 {
+    static constexpr size_t cTransientArenaByteSize = MiB(16);
+    static constexpr size_t cJsonPoolByteSize = MiB(8);
+
     m_buffersMeta.Clear();
     m_texturesMeta.Clear();
 
+    // The JSON document and paths only live for the build, the arena drops them all at once
+    ScopedArena arena(cTransientArenaByteSize);
+
     size_t jsonContentSize;
     char* pJsonContent = reinterpret_cast<char*>(ReadFileContent<ThreadHeapAllocator>(pSrcPath, jsonContentSize));
 
@@ -34,7 +46,9 @@ bool AssetDatabaseBuilder::BuildDatabase(const char* pSrcPath, const char* pDstP
         return false;
     }
 
-    Document json;
+    // Values that outgrow the first pool chunk are allocated by rapidjson itself
+    MemoryPoolAllocator<> jsonAllocator(arena.Allocate(cJsonPoolByteSize), cJsonPoolByteSize);
+    Document json(&jsonAllocator);
     json.Parse(pJsonContent);
 
     // Pack data
@@ -54,8 +68,8 @@ bool AssetDatabaseBuilder::BuildDatabase(const char* pSrcPath, const char* pDstP
         size_t srcRootFolderStrLen =
             static_cast<size_t>(reinterpret_cast<uintptr_t>(pSrcRootPathEnd) - reinterpret_cast<uintptr_t>(pSrcPath)) + 1;
 
-        char* pDstRootPath = static_cast<char*>(biome::memory::StackAlloc(dstRootFolderStrLen + 1));
-        char* pSrcRootPath = static_cast<char*>(biome::memory::StackAlloc(srcRootFolderStrLen + 1));
+        char* pDstRootPath = arena.Allocate<char>(dstRootFolderStrLen + 1);
+        char* pSrcRootPath = arena.Allocate<char>(srcRootFolderStrLen + 1);
 
         pDstRootPath[dstRootFolderStrLen] = 0;
         pSrcRootPath[srcRootFolderStrLen] = 0;
@@ -105,9 +119,19 @@ bool AssetDatabaseBuilder::PackData(
     const char* pSrcRootPath,
     const char* pDestRootPath)
 {
-    return
-        PackTextures(json, pSrcRootPath, pDestRootPath) &&
-        PackBuffers(json, pSrcRootPath, pDestRootPath);
+    // Textures and buffers go to separate files and metadata arrays, pack them concurrently
+    TaskCounter packCounter;
+    PackTask packTextures(this, &AssetDatabaseBuilder::PackTextures, json, pSrcRootPath, pDestRootPath);
+    PackTask packBuffers(this, &AssetDatabaseBuilder::PackBuffers, json, pSrcRootPath, pDestRootPath);
+
+    packTextures.SetCounter(&packCounter);
+    packBuffers.SetCounter(&packCounter);
+
+    m_threadPool.QueueTask(&packTextures);
+    m_threadPool.QueueTask(&packBuffers);
+    m_threadPool.WaitFor(packCounter);
+
+    return packTextures.m_succeeded && packBuffers.m_succeeded;
 }
 
 bool AssetDatabaseBuilder::PackTextures(const Document &json, const char *pSrcRootPath, const char *pDestRootPath)
@@ -117,6 +141,8 @@ bool AssetDatabaseBuilder::PackTextures(const Document &json, const char *pSrcRo
     static constexpr const char s_pImgProperty[] = "images";
     static constexpr const char s_pUriProperty[] = "uri";
 
+    BIOME_ALLOCATION_TAG("PackTextures");
+
     if (json.HasMember(s_pImgProperty) && json[s_pImgProperty].IsArray())
     {
         const Value &images = json[s_pImgProperty];
@@ -167,6 +193,8 @@ bool AssetDatabaseBuilder::PackBuffers(const Document &json, const char *pSrcRoo
     static constexpr const char cpBuffersProperty[] = "buffers";
     static constexpr const char cpUriProperty[] = "uri";
 
+    BIOME_ALLOCATION_TAG("PackBuffers");
+
     if (json.HasMember(cpBuffersProperty) && json[cpBuffersProperty].IsArray())
     {
         const Value &buffers = json[cpBuffersProperty];
@@ -218,6 +246,8 @@ bool AssetDatabaseBuilder::PackBuffers(const Document &json, const char *pSrcRoo
 
 bool AssetDatabaseBuilder::InsertMeta(const Document& json, FILE* pDBFile)
 {
+    BIOME_ALLOCATION_TAG("InsertMeta");
+
     return
         InsertTexturesMeta(json, pDBFile) &&
         InsertMeshesMeta(json, pDBFile);
@@ -537,18 +567,19 @@ AssetDatabaseBuilder::TextureInfo AssetDatabaseBuilder::CompressTexture(const ch
     }
     //*/
 
-    //ThreadHeapSmartPointer<unsigned char> bcDest(ThreadHeapAllocator::Allocate(byteSize));
-    unsigned char bcDest[blockByteSize];
+    ThreadHeapSmartPointer<unsigned char> bcDest(ThreadHeapAllocator::Allocate(byteSize));
 
-    unsigned char blockData[16][4];
-    const unsigned char* pBlockData = &blockData[0][0];
-    for (uint32_t blockY = 0; blockY < blockHeight; ++blockY)
+    // Blocks are compressed independently, spread the block rows over the thread pool
+    ParallelFor(m_threadPool, blockHeight, AutomaticGrainSize, [&](uint32_t blockY)
     {
+        unsigned char blockData[16][4];
+        const unsigned char* pBlockData = &blockData[0][0];
+
         for (uint32_t blockX = 0; blockX < blockWidth; ++blockX)
         {
             const uint32_t pixelBlockStartOffset = (blockY * rowStride + blockX * componentCount) * 4;
             const uint32_t destBlockOffset = blockY * blockWidth + blockX;
-            unsigned char* pDest = bcDest;
+            unsigned char* pDest = bcDest + destBlockOffset * blockByteSize;
 
             for (uint32_t y = 0; y < blockPixelSize; ++y)
             {
@@ -574,12 +605,10 @@ AssetDatabaseBuilder::TextureInfo AssetDatabaseBuilder::CompressTexture(const ch
 
             constexpr int alpha = 1;
             stb_compress_dxt_block(pDest, pBlockData, alpha, STB_DXT_NORMAL);
-
-            BIOME_ASSERT_ALWAYS_EXEC(fwrite(pDest, sizeof(uint8_t), blockByteSize, pDestFile) == blockByteSize);
         }
-    }
+    });
 
-    //BIOME_ASSERT_ALWAYS_EXEC(fwrite(bcDest, sizeof(uint8_t), byteSize, pDestFile) == byteSize);
+    BIOME_ASSERT_ALWAYS_EXEC(fwrite(bcDest, sizeof(uint8_t), byteSize, pDestFile) == byteSize);
     
     return TextureInfo { byteSize, pixelWidth, pixelHeight };
 }
@@ -6,6 +6,12 @@
 #include "asset_assembler/rapidjson/fwd.h"
 #include "biome_core/DataStructures/Vector.h"
 #include "biome_core/Assets/Mesh.h"
+#include "biome_core/Threading/WorkerTask.h"
+
+namespace biome::threading
+{
+    class WorkerThreadPool;
+}
 
 using namespace rapidjson;
 using namespace biome::data;
@@ -37,7 +43,7 @@ namespace asset_assembler
         {
         public:
 
-            AssetDatabaseBuilder() = default;
+            AssetDatabaseBuilder(biome::threading::WorkerThreadPool &threadPool) : m_threadPool(threadPool) {}
             ~AssetDatabaseBuilder() = default;
 
             bool BuildDatabase(const char *pSrcPath, const char *pDstPath);
@@ -67,6 +73,27 @@ namespace asset_assembler
                 uint32_t m_pixelHeight;
             };
 
+            using PackFunction = bool (AssetDatabaseBuilder::*)(const Document&, const char*, const char*);
+
+            // Runs one pack stage on the thread pool
+            class PackTask : public biome::threading::WorkerTask
+            {
+            public:
+
+                PackTask(AssetDatabaseBuilder* pBuilder, PackFunction packFunction, const Document& json, const char* pSrcRootPath, const char* pDestRootPath)
+                    : m_pBuilder(pBuilder), m_packFunction(packFunction), m_json(json), m_pSrcRootPath(pSrcRootPath), m_pDestRootPath(pDestRootPath) {}
+
+                void DoWork() noexcept override { m_succeeded = (m_pBuilder->*m_packFunction)(m_json, m_pSrcRootPath, m_pDestRootPath); }
+                void OnWorkDone() noexcept override {}
+
+                AssetDatabaseBuilder*   m_pBuilder;
+                PackFunction            m_packFunction;
+                const Document&         m_json;
+                const char*             m_pSrcRootPath;
+                const char*             m_pDestRootPath;
+                bool                    m_succeeded { false };
+            };
+
             static constexpr uint32_t   cInvalidIndex = std::numeric_limits<uint32_t>::max();
             static constexpr const char cpBuffersBinFileName[] = "Buffers.bin";
             static constexpr const char cpTexturesBinFileName[] = "Textures.bin";
@@ -89,6 +116,7 @@ namespace asset_assembler
 
         private:
 
+            biome::threading::WorkerThreadPool& m_threadPool;
             Vector<PackedTextureMeta> m_texturesMeta { 100 };
             Vector<PackedBufferMeta> m_buffersMeta { 100 };
         };
@@ -1,7 +1,11 @@
 #include "asset_assembler/database/AssetDatabaseBuilder.h"
 #include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Memory/AllocationTrace.h"
+#include "biome_core/Memory/MemoryRegistry.h"
 #include "biome_core/Core/Defines.h"
 #include "biome_core/FileSystem/FileSystem.h"
+#include "biome_core/SystemInfo/SystemInfo.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
 
 using namespace asset_assembler::database;
 using namespace biome::memory;
@@ -11,17 +15,47 @@ int main(int argc, char* argv[])
 {
     BIOME_ASSERT_ALWAYS_EXEC(ThreadHeapAllocator::Initialize(GiB(1), MiB(100)));
 
-    // All heavy memory allocations must go through biome::memory::VirtualMemoryAllocator.
-    AssetDatabaseBuilder builder;
+#if BIOME_ALLOCATION_TRACE
+    AllocationTrace::Start(1u << 20);
+#endif
 
-//     BIOME_ASSERT(argc >= 3);
-//     const char* pGltfFilePath = argv[1];
-//     const char* pDbFilePath = argv[2];
+    bool success = false;
 
-    bool success = builder.BuildDatabase(
-        "../TestApp/Media/star_trek_danube_class/scene.gltf", 
-        "../TestApp/Media/builds/star_trek_danube_class/StartTrek.db");
-    //bool success = builder.BuildDatabase(pGltfFilePath, pDbFilePath);
+    {
+        // Must outlive the builder, whose metadata arrays can be grown on the workers' heaps
+        const biome::system::SystemInfo systemInfo = biome::system::GetSystemInfo();
+        biome::threading::WorkerThreadPool threadPool(systemInfo.m_LogicalCpuCoreCount, GiB(1), MiB(100));
+
+        // All heavy memory allocations must go through biome::memory::VirtualMemoryAllocator.
+        AssetDatabaseBuilder builder(threadPool);
+
+//         BIOME_ASSERT(argc >= 3);
+//         const char* pGltfFilePath = argv[1];
+//         const char* pDbFilePath = argv[2];
+
+        success = builder.BuildDatabase(
+            "../TestApp/Media/star_trek_danube_class/scene.gltf", 
+            "../TestApp/Media/builds/star_trek_danube_class/StartTrek.db");
+        //success = builder.BuildDatabase(pGltfFilePath, pDbFilePath);
+    }
+
+    // Kept by the waits on the pool, not a leak
+    biome::threading::WorkerThreadPool::ReleaseThreadScratchArena();
+
+#if BIOME_ALLOCATION_TRACE
+    AllocationTrace::Stop();
+    AllocationTrace::DumpToFile("../TestApp/Media/builds/star_trek_danube_class/AssetAssembler.alloctrace");
+#endif
+
+    const AllocatorStats heapStats = ThreadHeapAllocator::GetStats();
+    printf_s("Heap: %zu bytes peak, %zu bytes committed, %llu allocations\n",
+        heapStats.m_PeakUsedByteCount,
+        heapStats.m_CommittedByteCount,
+        static_cast<unsigned long long>(heapStats.m_AllocationCount));
+
+    // The builder and the workers are gone, anything but the main thread heap is a leak
+    const uint32_t liveRangeCount = ReportLiveOwners();
+    printf_s("%u memory ranges still registered\n", liveRangeCount);
 
     if (success)
     {
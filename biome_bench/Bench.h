@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <stdio.h>
+#include <thread>
+
+// Fails the running test, in every build, unlike `BIOME_ASSERT`
+#define BENCH_CHECK(x)                                                          \
+    {                                                                           \
+        if (!(x))                                                               \
+        {                                                                       \
+            printf("%s(%d): Check failed: %s\n", __FILE__, __LINE__, #x);       \
+            return false;                                                       \
+        }                                                                       \
+    }
+
+namespace biome
+{
+    namespace bench
+    {
+        // Entry point of a test or benchmark, returns false when a check failed.
+        // Benchmarks print their measures and only fail on broken results.
+        using BenchFunction = bool(*)();
+
+        struct BenchEntry
+        {
+            const char*     m_pName;
+            BenchFunction   m_pFunction;
+        };
+
+        class BenchTimer
+        {
+        public:
+
+            BenchTimer() : m_Start(std::chrono::steady_clock::now()) {}
+
+            double ElapsedMilliseconds() const
+            {
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+            }
+
+            void Reset() { m_Start = std::chrono::steady_clock::now(); }
+
+        private:
+
+            std::chrono::steady_clock::time_point m_Start;
+        };
+
+        // Small and fast generator, so that randomized runs are reproducible from their seed
+        class Random
+        {
+        public:
+
+            Random(uint64_t seed) : m_State(seed != 0 ? seed : 1) {}
+
+            uint64_t Next()
+            {
+                // xorshift64*
+                m_State ^= m_State >> 12;
+                m_State ^= m_State << 25;
+                m_State ^= m_State >> 27;
+                return m_State * 0x2545F4914F6CDD1Dull;
+            }
+
+            uint32_t NextBelow(uint32_t bound) { return static_cast<uint32_t>(Next() % bound); }
+
+        private:
+
+            uint64_t m_State;
+        };
+
+        // Runs `function(threadIndex)` on `threadCount` new threads and waits for them.
+        // The threads have no thread heap, the function must not allocate.
+        template<typename Function>
+        void RunThreads(uint32_t threadCount, Function function)
+        {
+            constexpr uint32_t MaxThreadCount = 64;
+            std::thread threads[MaxThreadCount];
+
+            threadCount = threadCount < MaxThreadCount ? threadCount : MaxThreadCount;
+
+            for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+            {
+                threads[threadIndex] = std::thread(function, threadIndex);
+            }
+
+            for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+            {
+                threads[threadIndex].join();
+            }
+        }
+
+        // Memory
+        bool RunOffsetAllocatorFuzz();
+        bool RunOffsetAllocatorBench();
+        bool RunSmallObjectAllocatorBench();
+        bool RunMemoryRegistryBench();
+        bool RunLargePageBench();
+        bool RunVirtualMemoryStressBench();
+
+        // Data structures
+        bool RunSlotMapBench();
+        bool RunHandleTableTest();
+
+        // Threading
+        bool RunMpmcQueueBench();
+        bool RunSpscRingBench();
+        bool RunThreadPoolBench();
+        bool RunParallelLoopsBench();
+        bool RunWorkerThreadBench();
+        bool RunTaskBurstBench();
+        bool RunCoroutineTaskTest();
+    }
+}
@@ -0,0 +1,170 @@
+#include <atomic>
+#include "Bench.h"
+#include "biome_core/DataStructures/HandleTable.h"
+
+using namespace biome;
+using namespace biome::bench;
+using namespace biome::data;
+
+namespace
+{
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t LiveObjectsPerThread = 16;
+    constexpr uint32_t OperationsPerThread = 20000;
+
+    struct TrackedObject
+    {
+        TrackedObject(uint32_t value) : m_Value(value) { s_LiveCount.fetch_add(1, std::memory_order_relaxed); }
+        ~TrackedObject() { s_LiveCount.fetch_sub(1, std::memory_order_relaxed); }
+
+        static std::atomic<int32_t> s_LiveCount;
+
+        uint32_t m_Value;
+    };
+
+    std::atomic<int32_t> TrackedObject::s_LiveCount { 0 };
+
+    using TrackedTable = HandleTable<TrackedObject, true>;
+    using TrackedHandle = TrackedTable::HandleType;
+
+    // Destroyed handles no longer validate, even once their slot holds a new object
+    bool TestStaleHandles()
+    {
+        TrackedTable table(4);
+
+        const TrackedHandle first = table.Create(1u);
+        const TrackedHandle second = table.Create(2u);
+        BENCH_CHECK(table.IsValid(first) && table.IsValid(second));
+        BENCH_CHECK(!table.IsValid(TrackedHandle()));
+
+        table.Destroy(first);
+        BENCH_CHECK(!table.IsValid(first));
+        BENCH_CHECK(table.IsValid(second) && table.Get(second)->m_Value == 2);
+
+        const TrackedHandle reused = table.Create(3u);
+        BENCH_CHECK(reused.GetIndex() == first.GetIndex());
+        BENCH_CHECK(!table.IsValid(first));
+        BENCH_CHECK(table.Get(reused)->m_Value == 3);
+
+        table.Destroy(second);
+        table.Destroy(reused);
+        BENCH_CHECK(table.Count() == 0);
+
+        return true;
+    }
+
+    // A freed slot is handed out again before untouched ones, with its generation bumped
+    bool TestSlotReuse()
+    {
+        TrackedTable table(8);
+        TrackedHandle handles[4];
+
+        for (uint32_t index = 0; index < 4; ++index)
+        {
+            handles[index] = table.Create(index);
+            BENCH_CHECK(handles[index].GetIndex() == index);
+        }
+
+        table.Destroy(handles[1]);
+        table.Destroy(handles[2]);
+
+        // Last freed, first reused
+        const TrackedHandle firstReused = table.Create(10u);
+        const TrackedHandle secondReused = table.Create(11u);
+        BENCH_CHECK(firstReused.GetIndex() == 2 && firstReused.GetGeneration() == handles[2].GetGeneration() + 1);
+        BENCH_CHECK(secondReused.GetIndex() == 1 && secondReused.GetGeneration() == handles[1].GetGeneration() + 1);
+
+        const TrackedHandle fresh = table.Create(12u);
+        BENCH_CHECK(fresh.GetIndex() == 4);
+
+        uint32_t visitedCount = 0;
+        table.ForEach([&](TrackedHandle handle, TrackedObject &object)
+        {
+            visitedCount += (table.Get(handle) == &object) ? 1 : 0;
+        });
+        BENCH_CHECK(visitedCount == 5 && table.Count() == 5);
+
+        table.Destroy(handles[0]);
+        table.Destroy(handles[3]);
+        table.Destroy(firstReused);
+        table.Destroy(secondReused);
+        table.Destroy(fresh);
+
+        return true;
+    }
+
+    // After `GenerationMask + 1` reuses, a slot hands out its first handle again
+    bool TestGenerationWrap()
+    {
+        TrackedTable table(1);
+
+        const TrackedHandle first = table.Create(0u);
+        BENCH_CHECK(first.GetGeneration() == 0);
+        table.Destroy(first);
+
+        for (uint32_t generation = 1; generation <= TrackedHandle::GenerationMask; ++generation)
+        {
+            const TrackedHandle handle = table.Create(generation);
+            BENCH_CHECK(handle.GetGeneration() == generation && !handle.IsNull());
+            BENCH_CHECK(!table.IsValid(first));
+            table.Destroy(handle);
+        }
+
+        const TrackedHandle wrapped = table.Create(0u);
+        BENCH_CHECK(wrapped == first);
+        BENCH_CHECK(table.IsValid(first));
+        table.Destroy(wrapped);
+
+        return true;
+    }
+
+    // Threads creating and destroying their own objects at once never share a slot
+    bool TestConcurrentCreateDestroy()
+    {
+        TrackedTable table(ThreadCount * LiveObjectsPerThread);
+        std::atomic<uint32_t> failureCount { 0 };
+
+        RunThreads(ThreadCount, [&](uint32_t threadIndex)
+        {
+            TrackedHandle handles[LiveObjectsPerThread];
+
+            for (uint32_t operationIndex = 0; operationIndex < OperationsPerThread; ++operationIndex)
+            {
+                const uint32_t slot = operationIndex % LiveObjectsPerThread;
+                const uint32_t stamp = (threadIndex << 24) | slot;
+
+                if (!handles[slot].IsNull())
+                {
+                    const TrackedObject* const pObject = table.Get(handles[slot]);
+                    failureCount.fetch_add((pObject == nullptr || pObject->m_Value != stamp) ? 1 : 0, std::memory_order_relaxed);
+                    table.Destroy(handles[slot]);
+                }
+
+                handles[slot] = table.Create(stamp);
+                failureCount.fetch_add(handles[slot].IsNull() ? 1 : 0, std::memory_order_relaxed);
+            }
+
+            for (TrackedHandle &handle : handles)
+            {
+                table.Destroy(handle);
+            }
+        });
+
+        BENCH_CHECK(failureCount.load() == 0);
+        BENCH_CHECK(table.Count() == 0);
+
+        return true;
+    }
+}
+
+// Handle validation, slot reuse and generation wrap of HandleTable, and concurrent use of a thread safe table
+bool biome::bench::RunHandleTableTest()
+{
+    BENCH_CHECK(TestStaleHandles());
+    BENCH_CHECK(TestSlotReuse());
+    BENCH_CHECK(TestGenerationWrap());
+    BENCH_CHECK(TestConcurrentCreateDestroy());
+    BENCH_CHECK(TrackedObject::s_LiveCount.load() == 0);
+
+    return true;
+}
@@ -0,0 +1,226 @@
+#include <unordered_map>
+#include <utility>
+#include "Bench.h"
+#include "biome_core/DataStructures/PackedArray.h"
+#include "biome_core/DataStructures/StaticArray.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+
+namespace
+{
+    constexpr uint32_t ValueCount = 50000;
+    constexpr uint32_t RoundCount = 10;
+
+    struct Particle
+    {
+        float       m_Position[3];
+        float       m_Velocity[3];
+        uint32_t    m_Id;
+        uint32_t    m_Padding;
+    };
+
+    using ParticleArray = PackedArray<Particle>;
+    using ParticleMap = std::unordered_map<uint32_t, Particle>;
+
+    enum class Operation
+    {
+        Insert,
+        Lookup,
+        Iterate,
+        Churn,
+        Count
+    };
+
+    constexpr const char* OperationNames[] = { "insert", "lookup", "iterate", "remove and insert" };
+    // Half the values are replaced by the churn
+    constexpr uint32_t OperationValueCounts[] = { ValueCount, ValueCount, ValueCount, ValueCount / 2 };
+
+    struct OperationTimes
+    {
+        double m_Milliseconds[static_cast<uint32_t>(Operation::Count)] {};
+    };
+
+    Particle MakeParticle(uint32_t id)
+    {
+        const float value = static_cast<float>(id);
+        return Particle { { value, value, value }, { 1.0f, 0.0f, 0.0f }, id, 0 };
+    }
+
+    // Visit order of the lookups and removals, shared by both containers
+    void MakeOrder(StaticArray<uint32_t> &order, Random &random)
+    {
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            order[index] = index;
+        }
+
+        for (uint32_t index = ValueCount - 1; index > 0; --index)
+        {
+            std::swap(order[index], order[random.NextBelow(index + 1)]);
+        }
+    }
+
+    // Fills `idSums` with the sum of the ids seen by each operation, so both containers can be compared
+    bool RunPackedArray(const StaticArray<uint32_t> &order, OperationTimes &times, uint64_t (&idSums)[static_cast<uint32_t>(Operation::Count)])
+    {
+        ParticleArray particles;
+        StaticArray<ParticleArray::HandleType> handles(ValueCount);
+
+        BenchTimer timer;
+
+        for (uint32_t id = 0; id < ValueCount; ++id)
+        {
+            handles[id] = particles.Add(MakeParticle(id));
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Insert)] += timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        uint64_t idSum = 0;
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            const Particle* const pParticle = particles.Get(handles[order[index]]);
+            BENCH_CHECK(pParticle != nullptr);
+            idSum += pParticle->m_Id;
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Lookup)] += timer.ElapsedMilliseconds();
+        idSums[static_cast<uint32_t>(Operation::Lookup)] = idSum;
+        timer.Reset();
+
+        idSum = 0;
+        const Particle* const pParticles = particles.GetIterator();
+        for (uint32_t index = 0; index < particles.Count(); ++index)
+        {
+            idSum += pParticles[index].m_Id;
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Iterate)] += timer.ElapsedMilliseconds();
+        idSums[static_cast<uint32_t>(Operation::Iterate)] = idSum;
+        timer.Reset();
+
+        // Half the values are replaced, in random order
+        for (uint32_t index = 0; index < ValueCount / 2; ++index)
+        {
+            const uint32_t id = order[index];
+            particles.Remove(handles[id]);
+            handles[id] = particles.Add(MakeParticle(id + ValueCount));
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Churn)] += timer.ElapsedMilliseconds();
+
+        idSum = 0;
+        for (uint32_t id = 0; id < ValueCount; ++id)
+        {
+            const Particle* const pParticle = particles.Get(handles[id]);
+            BENCH_CHECK(pParticle != nullptr);
+            idSum += pParticle->m_Id;
+        }
+
+        idSums[static_cast<uint32_t>(Operation::Churn)] = idSum;
+
+        return true;
+    }
+
+    bool RunUnorderedMap(const StaticArray<uint32_t> &order, OperationTimes &times, uint64_t (&idSums)[static_cast<uint32_t>(Operation::Count)])
+    {
+        ParticleMap particles;
+        StaticArray<uint32_t> keys(ValueCount);
+
+        BenchTimer timer;
+
+        for (uint32_t id = 0; id < ValueCount; ++id)
+        {
+            particles.emplace(id, MakeParticle(id));
+            keys[id] = id;
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Insert)] += timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        uint64_t idSum = 0;
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            const ParticleMap::const_iterator particleIt = particles.find(keys[order[index]]);
+            BENCH_CHECK(particleIt != particles.end());
+            idSum += particleIt->second.m_Id;
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Lookup)] += timer.ElapsedMilliseconds();
+        idSums[static_cast<uint32_t>(Operation::Lookup)] = idSum;
+        timer.Reset();
+
+        idSum = 0;
+        for (const std::pair<const uint32_t, Particle> &entry : particles)
+        {
+            idSum += entry.second.m_Id;
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Iterate)] += timer.ElapsedMilliseconds();
+        idSums[static_cast<uint32_t>(Operation::Iterate)] = idSum;
+        timer.Reset();
+
+        for (uint32_t index = 0; index < ValueCount / 2; ++index)
+        {
+            const uint32_t id = order[index];
+            particles.erase(keys[id]);
+            keys[id] = id + ValueCount;
+            particles.emplace(keys[id], MakeParticle(id + ValueCount));
+        }
+
+        times.m_Milliseconds[static_cast<uint32_t>(Operation::Churn)] += timer.ElapsedMilliseconds();
+
+        idSum = 0;
+        for (uint32_t id = 0; id < ValueCount; ++id)
+        {
+            const ParticleMap::const_iterator particleIt = particles.find(keys[id]);
+            BENCH_CHECK(particleIt != particles.end());
+            idSum += particleIt->second.m_Id;
+        }
+
+        idSums[static_cast<uint32_t>(Operation::Churn)] = idSum;
+
+        return true;
+    }
+}
+
+// PackedArray against a `std::unordered_map` keyed by id, on insertion, random lookups,
+// iteration and churn
+bool biome::bench::RunSlotMapBench()
+{
+    StaticArray<uint32_t> order(ValueCount);
+    OperationTimes packedTimes {};
+    OperationTimes mapTimes {};
+    Random random(0x5107);
+
+    for (uint32_t roundIndex = 0; roundIndex < RoundCount; ++roundIndex)
+    {
+        uint64_t packedIdSums[static_cast<uint32_t>(Operation::Count)] {};
+        uint64_t mapIdSums[static_cast<uint32_t>(Operation::Count)] {};
+
+        MakeOrder(order, random);
+
+        BENCH_CHECK(RunPackedArray(order, packedTimes, packedIdSums));
+        BENCH_CHECK(RunUnorderedMap(order, mapTimes, mapIdSums));
+
+        for (uint32_t operationIndex = static_cast<uint32_t>(Operation::Lookup); operationIndex < static_cast<uint32_t>(Operation::Count); ++operationIndex)
+        {
+            BENCH_CHECK(packedIdSums[operationIndex] == mapIdSums[operationIndex]);
+        }
+    }
+
+    printf("%u values of %zu bytes, %u rounds\n", ValueCount, sizeof(Particle), RoundCount);
+
+    for (uint32_t operationIndex = 0; operationIndex < static_cast<uint32_t>(Operation::Count); ++operationIndex)
+    {
+        const double operationCount = static_cast<double>(OperationValueCounts[operationIndex]) * RoundCount;
+
+        printf("%-17s PackedArray %.1f ns, std::unordered_map %.1f ns per value\n",
+            OperationNames[operationIndex],
+            packedTimes.m_Milliseconds[operationIndex] * 1000000.0 / operationCount,
+            mapTimes.m_Milliseconds[operationIndex] * 1000000.0 / operationCount);
+    }
+
+    return true;
+}
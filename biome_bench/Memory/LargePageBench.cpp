@@ -0,0 +1,81 @@
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #include <Psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace biome::bench;
+using namespace biome::memory;
+
+namespace
+{
+    constexpr size_t BlockByteSize = MiB(256);
+    // Touched at the size of a small page, so that every page of a mode without large pages faults
+    constexpr size_t TouchStride = KiB(4);
+
+    uint64_t GetPageFaultCount()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters {};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.PageFaultCount;
+#else
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt);
+#endif
+    }
+
+    const char* GetModeName(LargePageMode mode)
+    {
+        switch (mode)
+        {
+        case LargePageMode::None:           return "None";
+        case LargePageMode::Transparent:    return "Transparent";
+        case LargePageMode::Explicit:       return "Explicit";
+        default:                            return "Unknown";
+        }
+    }
+}
+
+// Page faults taken by the first touch of a heap sized block, in each large page mode
+bool biome::bench::RunLargePageBench()
+{
+    const LargePageMode modes[] = { LargePageMode::None, LargePageMode::Transparent, LargePageMode::Explicit };
+
+    for (const LargePageMode mode : modes)
+    {
+        uint8_t* const pBlock = static_cast<uint8_t*>(
+            VirtualMemoryAllocator::Allocate(BlockByteSize, BlockByteSize, VirtualMemoryAllocator::GetSystemPageSize(), mode));
+        BENCH_CHECK(pBlock != nullptr);
+
+        const uint64_t firstFaultCount = GetPageFaultCount();
+        BenchTimer timer;
+
+        for (size_t offset = 0; offset < BlockByteSize; offset += TouchStride)
+        {
+            pBlock[offset] = 1;
+        }
+
+        const double elapsedMilliseconds = timer.ElapsedMilliseconds();
+        const uint64_t faultCount = GetPageFaultCount() - firstFaultCount;
+
+        // Explicit falls back to Transparent when the hugetlbfs pool is empty
+        printf("%-11s (got %-11s): %8llu page faults, %.1f ms to touch %zu MiB\n",
+            GetModeName(mode),
+            GetModeName(VirtualMemoryAllocator::GetLargePageMode(pBlock)),
+            static_cast<unsigned long long>(faultCount),
+            elapsedMilliseconds,
+            BlockByteSize / MiB(1));
+
+        // Not kept for reuse, the next mode must reserve fresh address space
+        VirtualMemoryAllocator::ForceReleaseToOS(pBlock);
+    }
+
+    return true;
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include "Bench.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/DataStructures/Vector.h"
+#include "biome_core/Memory/MemoryOffsetAllocator.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::memory;
+
+namespace
+{
+    // Descriptor sized pages, as in the descriptor heaps
+    constexpr size_t PageSize = 64;
+
+    struct LiveAllocation
+    {
+        uint32_t m_PageIndex;
+        uint32_t m_PageCount;
+    };
+
+    // Mostly small runs, with a tail of large ones that fragments the range
+    uint32_t RandomPageCount(Random &random, uint32_t maxPageCount)
+    {
+        const uint32_t bucket = random.NextBelow(100);
+        const uint32_t pageCount =
+            bucket < 70 ? 1 + random.NextBelow(4) :
+            bucket < 95 ? 5 + random.NextBelow(60) :
+                          65 + random.NextBelow(448);
+
+        return std::min(pageCount, maxPageCount);
+    }
+
+    uint32_t LargestFreeRun(const StaticArray<uint8_t, CleanConstructDestruct> &usedPages)
+    {
+        uint32_t largestRun = 0;
+        uint32_t run = 0;
+
+        for (size_t index = 0; index < usedPages.Size(); ++index)
+        {
+            run = usedPages[index] ? 0 : run + 1;
+            largestRun = std::max(largestRun, run);
+        }
+
+        return largestRun;
+    }
+
+    void RemoveLive(Vector<LiveAllocation> &liveAllocations, uint32_t index)
+    {
+        liveAllocations[index] = liveAllocations[liveAllocations.Size() - 1];
+        liveAllocations.PopBack();
+    }
+}
+
+// Random allocations and releases checked against a shadow map of the used pages.
+// The allocator must never hand out a used page, never fail while a large enough run is free,
+// reject offsets that are not live allocations, and end with the whole range in one free run.
+bool biome::bench::RunOffsetAllocatorFuzz()
+{
+    constexpr uint32_t PageCount = 2048;
+    constexpr uint32_t OperationCount = 100000;
+    constexpr uint32_t StatsCheckInterval = 1024;
+
+    MemoryOffsetAllocator allocator;
+    allocator.Initialize(PageCount * PageSize, PageSize);
+
+    StaticArray<uint8_t, CleanConstructDestruct> usedPages(PageCount);
+    Vector<LiveAllocation> liveAllocations;
+    Random random(0xB10E);
+    uint32_t usedPageCount = 0;
+    uint32_t skippedAllocationCount = 0;
+
+    for (uint32_t operationIndex = 0; operationIndex < OperationCount; ++operationIndex)
+    {
+        const bool allocate = liveAllocations.Size() == 0 || random.NextBelow(100) < 55;
+
+        if (allocate)
+        {
+            const uint32_t pageCount = RandomPageCount(random, PageCount);
+            const uint32_t largestFreeRun = LargestFreeRun(usedPages);
+
+            BENCH_CHECK(allocator.GetStats().m_LargestFreeBlockByteCount == largestFreeRun * PageSize);
+
+            // Exhausting the allocator asserts in debug builds, the largest free run check covers it
+            if (pageCount > largestFreeRun)
+            {
+                ++skippedAllocationCount;
+                continue;
+            }
+
+            const size_t offset = allocator.AllocatePages(pageCount);
+            BENCH_CHECK(offset != MemoryOffsetAllocator::InvalidOffset);
+            BENCH_CHECK(offset % PageSize == 0);
+
+            const uint32_t pageIndex = static_cast<uint32_t>(offset / PageSize);
+            BENCH_CHECK(pageIndex + pageCount <= PageCount);
+
+            for (uint32_t index = pageIndex; index < pageIndex + pageCount; ++index)
+            {
+                BENCH_CHECK(usedPages[index] == 0);
+                usedPages[index] = 1;
+            }
+
+            liveAllocations.Add({ pageIndex, pageCount });
+            usedPageCount += pageCount;
+        }
+        else
+        {
+            const uint32_t liveIndex = random.NextBelow(liveAllocations.Size());
+            const LiveAllocation allocation = liveAllocations[liveIndex];
+
+            if (allocation.m_PageCount > 1)
+            {
+                BENCH_CHECK(!allocator.Release((allocation.m_PageIndex + 1) * PageSize));
+            }
+
+            BENCH_CHECK(allocator.Release(allocation.m_PageIndex * PageSize));
+            BENCH_CHECK(!allocator.Release(allocation.m_PageIndex * PageSize));
+
+            for (uint32_t index = allocation.m_PageIndex; index < allocation.m_PageIndex + allocation.m_PageCount; ++index)
+            {
+                usedPages[index] = 0;
+            }
+
+            RemoveLive(liveAllocations, liveIndex);
+            usedPageCount -= allocation.m_PageCount;
+        }
+
+        if (operationIndex % StatsCheckInterval == 0)
+        {
+            BENCH_CHECK(allocator.GetStats().m_UsedByteCount == usedPageCount * PageSize);
+        }
+    }
+
+    while (liveAllocations.Size() > 0)
+    {
+        BENCH_CHECK(allocator.Release(liveAllocations[liveAllocations.Size() - 1].m_PageIndex * PageSize));
+        liveAllocations.PopBack();
+    }
+
+    const AllocatorStats stats = allocator.GetStats();
+    BENCH_CHECK(stats.m_UsedByteCount == 0);
+    BENCH_CHECK(stats.m_FreeRangeCount == 1);
+    BENCH_CHECK(stats.m_LargestFreeBlockByteCount == PageCount * PageSize);
+
+    printf("%u operations, %llu allocations, %u skipped for lack of a free run, no page leaked\n",
+        OperationCount, static_cast<unsigned long long>(stats.m_AllocationCount), skippedAllocationCount);
+
+    return true;
+}
+
+// Allocate and release churn around half occupancy, the steady state of a descriptor heap
+bool biome::bench::RunOffsetAllocatorBench()
+{
+    constexpr uint32_t PageCount = 65536;
+    constexpr uint32_t OperationCount = 2000000;
+    constexpr uint32_t TargetUsedPageCount = PageCount / 2;
+
+    MemoryOffsetAllocator allocator;
+    allocator.Initialize(PageCount * PageSize, PageSize);
+
+    Vector<LiveAllocation> liveAllocations;
+    Random random(0xB10E);
+    uint32_t usedPageCount = 0;
+
+    BenchTimer timer;
+
+    for (uint32_t operationIndex = 0; operationIndex < OperationCount; ++operationIndex)
+    {
+        const uint32_t pageCount = 1 + random.NextBelow(16);
+
+        if (liveAllocations.Size() == 0 || (usedPageCount + pageCount <= TargetUsedPageCount && random.NextBelow(2) == 0))
+        {
+            const size_t offset = allocator.AllocatePages(pageCount);
+            BENCH_CHECK(offset != MemoryOffsetAllocator::InvalidOffset);
+
+            liveAllocations.Add({ static_cast<uint32_t>(offset / PageSize), pageCount });
+            usedPageCount += pageCount;
+        }
+        else
+        {
+            const uint32_t liveIndex = random.NextBelow(liveAllocations.Size());
+            const LiveAllocation allocation = liveAllocations[liveIndex];
+
+            BENCH_CHECK(allocator.Release(allocation.m_PageIndex * PageSize));
+
+            RemoveLive(liveAllocations, liveIndex);
+            usedPageCount -= allocation.m_PageCount;
+        }
+    }
+
+    const double elapsedMilliseconds = timer.ElapsedMilliseconds();
+    const AllocatorStats stats = allocator.GetStats();
+
+    printf("%u operations in %.1f ms, %.1f ns per operation, %zu free ranges, largest free block %zu pages\n",
+        OperationCount,
+        elapsedMilliseconds,
+        elapsedMilliseconds * 1000000.0 / OperationCount,
+        stats.m_FreeRangeCount,
+        stats.m_LargestFreeBlockByteCount / PageSize);
+
+    return true;
+}
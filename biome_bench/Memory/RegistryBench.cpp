@@ -0,0 +1,98 @@
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Memory/MemoryRegistry.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::memory;
+
+namespace
+{
+    constexpr size_t BlockByteSize = MiB(1);
+    constexpr uint32_t LookupCount = 1u << 20;
+
+    struct AddressRange
+    {
+        uintptr_t   m_Start;
+        uintptr_t   m_End;
+    };
+
+    // What finding a heap took before the registry, a check against every heap range
+    uint32_t FindRangeLinear(const StaticArray<AddressRange> &ranges, uint32_t rangeCount, uintptr_t address)
+    {
+        for (uint32_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex)
+        {
+            if (address >= ranges[rangeIndex].m_Start && address < ranges[rangeIndex].m_End)
+            {
+                return rangeIndex;
+            }
+        }
+
+        return UINT32_MAX;
+    }
+}
+
+// Owner lookup of pointers spread over N blocks, through the radix registry and through range checks
+bool biome::bench::RunMemoryRegistryBench()
+{
+    const uint32_t blockCounts[] = { 1, 8, 64, 256 };
+    constexpr uint32_t MaxBlockCount = 256;
+
+    StaticArray<void*> blocks(MaxBlockCount);
+    StaticArray<AddressRange> ranges(MaxBlockCount);
+    StaticArray<uintptr_t> addresses(LookupCount);
+    StaticArray<uint32_t> expectedRanges(LookupCount);
+    Random random(0x4E61);
+
+    for (const uint32_t blockCount : blockCounts)
+    {
+        for (uint32_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+        {
+            blocks[blockIndex] = VirtualMemoryAllocator::Allocate(BlockByteSize, 0);
+            BENCH_CHECK(blocks[blockIndex] != nullptr);
+
+            ranges[blockIndex].m_Start = reinterpret_cast<uintptr_t>(blocks[blockIndex]);
+            ranges[blockIndex].m_End = ranges[blockIndex].m_Start + BlockByteSize;
+        }
+
+        for (uint32_t lookupIndex = 0; lookupIndex < LookupCount; ++lookupIndex)
+        {
+            const uint32_t rangeIndex = random.NextBelow(blockCount);
+            expectedRanges[lookupIndex] = rangeIndex;
+            addresses[lookupIndex] = ranges[rangeIndex].m_Start + random.NextBelow(BlockByteSize);
+        }
+
+        BenchTimer registryTimer;
+
+        for (uint32_t lookupIndex = 0; lookupIndex < LookupCount; ++lookupIndex)
+        {
+            const MemoryOwner owner = FindOwner(reinterpret_cast<void*>(addresses[lookupIndex]));
+            BENCH_CHECK(owner.m_Type == MemoryOwnerType::VirtualMemoryBlock && owner.m_pOwner == blocks[expectedRanges[lookupIndex]]);
+        }
+
+        const double registryMilliseconds = registryTimer.ElapsedMilliseconds();
+
+        BenchTimer linearTimer;
+
+        for (uint32_t lookupIndex = 0; lookupIndex < LookupCount; ++lookupIndex)
+        {
+            BENCH_CHECK(FindRangeLinear(ranges, blockCount, addresses[lookupIndex]) == expectedRanges[lookupIndex]);
+        }
+
+        const double linearMilliseconds = linearTimer.ElapsedMilliseconds();
+
+        printf("%3u blocks: registry %.1f ns per lookup, range checks %.1f ns per lookup\n",
+            blockCount,
+            registryMilliseconds * 1000000.0 / LookupCount,
+            linearMilliseconds * 1000000.0 / LookupCount);
+
+        for (uint32_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+        {
+            VirtualMemoryAllocator::Release(blocks[blockIndex]);
+        }
+    }
+
+    return true;
+}
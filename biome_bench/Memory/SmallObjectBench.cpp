@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "Bench.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::memory;
+
+namespace
+{
+    constexpr uint32_t ObjectCount = 50000;
+    constexpr uint32_t RoundCount = 10;
+
+    // Alignments above `SmallObjectAllocator::Alignment` bypass the slabs, which gives the page path
+    constexpr size_t SmallPathAlignment = SmallObjectAllocator::Alignment;
+    constexpr size_t PagePathAlignment = 2 * SmallObjectAllocator::Alignment;
+
+    struct PathResult
+    {
+        double  m_NanosecondsPerPair;
+        size_t  m_FootprintByteCount;
+    };
+
+    // Number of distinct system pages the allocations touch
+    size_t CountTouchedPages(StaticArray<uintptr_t> &pageAddresses)
+    {
+        std::sort(pageAddresses.begin(), pageAddresses.end());
+        return std::unique(pageAddresses.begin(), pageAddresses.end()) - pageAddresses.begin();
+    }
+
+    bool RunPath(size_t byteSize, size_t alignment, PathResult &result)
+    {
+        const size_t pageSize = VirtualMemoryAllocator::GetSystemPageSize();
+        StaticArray<void*> allocations(ObjectCount);
+        StaticArray<uintptr_t> pageAddresses(ObjectCount);
+
+        BenchTimer timer;
+
+        for (uint32_t roundIndex = 0; roundIndex < RoundCount; ++roundIndex)
+        {
+            for (uint32_t index = 0; index < ObjectCount; ++index)
+            {
+                void* const pMemory = ThreadHeapAllocator::Allocate(byteSize, alignment);
+                BENCH_CHECK(pMemory != nullptr);
+
+                *static_cast<uint8_t*>(pMemory) = static_cast<uint8_t>(index);
+                allocations[index] = pMemory;
+            }
+
+            if (roundIndex == 0)
+            {
+                for (uint32_t index = 0; index < ObjectCount; ++index)
+                {
+                    BENCH_CHECK(ThreadHeapAllocator::AllocationSize(allocations[index]) >= byteSize);
+                    pageAddresses[index] = reinterpret_cast<uintptr_t>(allocations[index]) & ~(pageSize - 1);
+                }
+            }
+
+            // Released in allocation order, the slabs fill and empty like the container churn they serve
+            for (uint32_t index = 0; index < ObjectCount; ++index)
+            {
+                BENCH_CHECK(ThreadHeapAllocator::Release(allocations[index]));
+            }
+        }
+
+        const double elapsedMilliseconds = timer.ElapsedMilliseconds();
+
+        result.m_NanosecondsPerPair = elapsedMilliseconds * 1000000.0 / (static_cast<double>(ObjectCount) * RoundCount);
+        result.m_FootprintByteCount = CountTouchedPages(pageAddresses) * pageSize;
+
+        return true;
+    }
+}
+
+// Allocation and release of small objects through the size-class slabs, against whole pages
+bool biome::bench::RunSmallObjectAllocatorBench()
+{
+    const size_t byteSizes[] = { 16, 64, 256, 1024, 2032 };
+
+    printf("%u objects, %u rounds, %u bytes pages\n", ObjectCount, RoundCount, VirtualMemoryAllocator::GetSystemPageSize());
+
+    for (const size_t byteSize : byteSizes)
+    {
+        PathResult slabResult {};
+        PathResult pageResult {};
+
+        BENCH_CHECK(RunPath(byteSize, SmallPathAlignment, slabResult));
+        BENCH_CHECK(RunPath(byteSize, PagePathAlignment, pageResult));
+
+        printf("%4zu bytes: slabs %.1f ns per allocate and release, %.2f MiB; pages %.1f ns, %.2f MiB\n",
+            byteSize,
+            slabResult.m_NanosecondsPerPair,
+            slabResult.m_FootprintByteCount / (1024.0 * 1024.0),
+            pageResult.m_NanosecondsPerPair,
+            pageResult.m_FootprintByteCount / (1024.0 * 1024.0));
+    }
+
+    return true;
+}
@@ -0,0 +1,75 @@
+#include <atomic>
+#include <iterator>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+
+using namespace biome::bench;
+using namespace biome::memory;
+
+namespace
+{
+    constexpr uint32_t OperationsPerThread = 20000;
+    // Blocks alive at once on each thread, released oldest first
+    constexpr uint32_t LiveBlockCount = 8;
+}
+
+// Threads reserving and releasing blocks of mixed sizes at once, the cost of thread heap and large
+// buffer creation under contention. Every block is stamped and checked, so a block handed out twice fails.
+bool biome::bench::RunVirtualMemoryStressBench()
+{
+    const uint32_t threadCounts[] = { 1, 2, 4, 8, 16 };
+    const size_t byteSizes[] = { KiB(64), KiB(256), MiB(1), MiB(4) };
+
+    const AllocatorStats firstStats = VirtualMemoryAllocator::GetStats();
+
+    for (const uint32_t threadCount : threadCounts)
+    {
+        std::atomic<uint32_t> failureCount { 0 };
+        const uint64_t firstReservedByteCount = VirtualMemoryAllocator::GetStats().m_ReservedByteCount;
+
+        BenchTimer timer;
+
+        RunThreads(threadCount, [&](uint32_t threadIndex)
+        {
+            Random random(threadIndex + 1);
+            uint64_t* liveBlocks[LiveBlockCount] {};
+            uint64_t stamp = static_cast<uint64_t>(threadIndex) << 32;
+
+            for (uint32_t operationIndex = 0; operationIndex < OperationsPerThread; ++operationIndex)
+            {
+                const uint32_t slot = operationIndex % LiveBlockCount;
+
+                if (liveBlocks[slot] != nullptr)
+                {
+                    failureCount.fetch_add(*liveBlocks[slot] != stamp + slot ? 1 : 0, std::memory_order_relaxed);
+                    VirtualMemoryAllocator::Release(liveBlocks[slot]);
+                }
+
+                const size_t byteSize = byteSizes[random.NextBelow(static_cast<uint32_t>(std::size(byteSizes)))];
+                liveBlocks[slot] = static_cast<uint64_t*>(VirtualMemoryAllocator::Allocate(byteSize, sizeof(uint64_t)));
+                *liveBlocks[slot] = stamp + slot;
+            }
+
+            for (uint32_t slot = 0; slot < LiveBlockCount; ++slot)
+            {
+                failureCount.fetch_add(*liveBlocks[slot] != stamp + slot ? 1 : 0, std::memory_order_relaxed);
+                VirtualMemoryAllocator::Release(liveBlocks[slot]);
+            }
+        });
+
+        const double elapsedMilliseconds = timer.ElapsedMilliseconds();
+        const AllocatorStats stats = VirtualMemoryAllocator::GetStats();
+        const uint64_t operationCount = static_cast<uint64_t>(threadCount) * OperationsPerThread;
+
+        BENCH_CHECK(failureCount.load() == 0);
+        BENCH_CHECK(stats.m_UsedByteCount == firstStats.m_UsedByteCount);
+
+        printf("%2u threads: %.0f K allocate and release per second, %.2f MiB newly reserved\n",
+            threadCount,
+            operationCount / elapsedMilliseconds,
+            (stats.m_ReservedByteCount - firstReservedByteCount) / (1024.0 * 1024.0));
+    }
+
+    return true;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Threading/Parallel.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t ValueCount = 1u << 22;
+    constexpr uint32_t SortValueCount = 1u << 20;
+
+    constexpr size_t PerThreadHeapByteSize = MiB(64);
+    constexpr size_t PerThreadInitialCommitByteSize = MiB(1);
+
+    float Transform(uint32_t index)
+    {
+        const float value = static_cast<float>(index);
+        return std::sqrt(value) * std::sin(value);
+    }
+
+    struct LoopTimes
+    {
+        double  m_ForMilliseconds;
+        double  m_ReduceMilliseconds;
+        double  m_SortMilliseconds;
+    };
+
+    void RunSerial(StaticArray<float> &values, StaticArray<uint32_t> &sortValues, uint64_t &sum, LoopTimes &times)
+    {
+        BenchTimer timer;
+
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            values[index] = Transform(index);
+        }
+
+        times.m_ForMilliseconds = timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        sum = 0;
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            sum += index ^ (index >> 3);
+        }
+
+        times.m_ReduceMilliseconds = timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        std::sort(sortValues.begin(), sortValues.end());
+
+        times.m_SortMilliseconds = timer.ElapsedMilliseconds();
+    }
+
+    void RunParallel(WorkerThreadPool &threadPool, StaticArray<float> &values, StaticArray<uint32_t> &sortValues, uint64_t &sum, LoopTimes &times)
+    {
+        BenchTimer timer;
+
+        ParallelFor(threadPool, ValueCount, AutomaticGrainSize, [&](uint32_t index)
+        {
+            values[index] = Transform(index);
+        });
+
+        times.m_ForMilliseconds = timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        sum = ParallelReduce(threadPool, ValueCount, AutomaticGrainSize, uint64_t { 0 },
+            [](uint32_t index) { return static_cast<uint64_t>(index ^ (index >> 3)); },
+            [](uint64_t left, uint64_t right) { return left + right; });
+
+        times.m_ReduceMilliseconds = timer.ElapsedMilliseconds();
+        timer.Reset();
+
+        ParallelSort(threadPool, sortValues);
+
+        times.m_SortMilliseconds = timer.ElapsedMilliseconds();
+    }
+
+    void FillSortValues(StaticArray<uint32_t> &sortValues)
+    {
+        Random random(0x5027);
+
+        for (uint32_t &value : sortValues)
+        {
+            value = static_cast<uint32_t>(random.Next());
+        }
+    }
+
+    bool CheckResults(StaticArray<float> &values, StaticArray<uint32_t> &sortValues, uint64_t sum, uint64_t expectedSum)
+    {
+        for (uint32_t index = 0; index < ValueCount; ++index)
+        {
+            BENCH_CHECK(values[index] == Transform(index));
+        }
+
+        BENCH_CHECK(sum == expectedSum);
+        BENCH_CHECK(std::is_sorted(sortValues.begin(), sortValues.end()));
+
+        return true;
+    }
+}
+
+// ParallelFor, ParallelReduce and ParallelSort against their serial loops, from 1 to 16 workers
+bool biome::bench::RunParallelLoopsBench()
+{
+    const uint32_t workerCounts[] = { 1, 2, 4, 8, 16 };
+
+    StaticArray<float> values(ValueCount);
+    StaticArray<uint32_t> sortValues(SortValueCount);
+    uint64_t expectedSum = 0;
+    LoopTimes serialTimes {};
+
+    // Touched first, so that no run pays for the page faults
+    std::fill(values.begin(), values.end(), 0.0f);
+    FillSortValues(sortValues);
+    RunSerial(values, sortValues, expectedSum, serialTimes);
+
+    printf("%u values, %u sorted values, %u hardware threads\n", ValueCount, SortValueCount, std::thread::hardware_concurrency());
+    printf("    serial: for %.2f ms, reduce %.2f ms, sort %.2f ms\n",
+        serialTimes.m_ForMilliseconds,
+        serialTimes.m_ReduceMilliseconds,
+        serialTimes.m_SortMilliseconds);
+
+    for (const uint32_t workerCount : workerCounts)
+    {
+        WorkerThreadPool threadPool(workerCount, PerThreadHeapByteSize, PerThreadInitialCommitByteSize);
+        uint64_t sum = 0;
+        LoopTimes times {};
+
+        std::fill(values.begin(), values.end(), 0.0f);
+        FillSortValues(sortValues);
+
+        RunParallel(threadPool, values, sortValues, sum, times);
+        BENCH_CHECK(CheckResults(values, sortValues, sum, expectedSum));
+
+        printf("%2u workers: for %.2f ms (x%.2f), reduce %.2f ms (x%.2f), sort %.2f ms (x%.2f)\n",
+            workerCount,
+            times.m_ForMilliseconds,
+            serialTimes.m_ForMilliseconds / times.m_ForMilliseconds,
+            times.m_ReduceMilliseconds,
+            serialTimes.m_ReduceMilliseconds / times.m_ReduceMilliseconds,
+            times.m_SortMilliseconds,
+            serialTimes.m_SortMilliseconds / times.m_SortMilliseconds);
+    }
+
+    // The parallel loops waited from this thread, which made it a scratch arena
+    WorkerThreadPool::ReleaseThreadScratchArena();
+
+    return true;
+}
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Bench.h"
+#include "biome_core/Threading/MpmcQueue.h"
+#include "biome_core/Threading/SpscRing.h"
+
+using namespace biome::bench;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t QueueCapacity = 1024;
+    constexpr uint32_t ItemCount = 1u << 20;
+
+    // The hand-off the lock-free queues replaced, a bounded ring behind a mutex
+    class LockedRing
+    {
+    public:
+
+        bool TryPush(uint64_t value)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (m_WriteIndex - m_ReadIndex == QueueCapacity)
+            {
+                return false;
+            }
+
+            m_Values[m_WriteIndex++ % QueueCapacity] = value;
+            return true;
+        }
+
+        bool TryPop(uint64_t &value)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (m_WriteIndex == m_ReadIndex)
+            {
+                return false;
+            }
+
+            value = m_Values[m_ReadIndex++ % QueueCapacity];
+            return true;
+        }
+
+    private:
+
+        std::mutex  m_Mutex {};
+        uint64_t    m_Values[QueueCapacity] {};
+        size_t      m_WriteIndex { 0 };
+        size_t      m_ReadIndex { 0 };
+    };
+
+    // Pushes `ItemCount` values split between the producers, and pops them all with the consumers.
+    // Returns the elapsed time, `sum` receives the sum of the popped values.
+    template<typename QueueType>
+    double Transfer(QueueType &queue, uint32_t producerCount, uint32_t consumerCount, uint64_t &sum)
+    {
+        std::atomic<uint32_t> finishedProducerCount { 0 };
+        std::atomic<uint64_t> poppedSum { 0 };
+        const uint32_t itemsPerProducer = ItemCount / producerCount;
+
+        BenchTimer timer;
+
+        RunThreads(producerCount + consumerCount, [&](uint32_t threadIndex)
+        {
+            if (threadIndex < producerCount)
+            {
+                const uint64_t firstValue = static_cast<uint64_t>(threadIndex) * itemsPerProducer;
+
+                for (uint64_t value = firstValue; value < firstValue + itemsPerProducer; ++value)
+                {
+                    while (!queue.TryPush(value))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+
+                finishedProducerCount.fetch_add(1, std::memory_order_release);
+            }
+            else
+            {
+                uint64_t localSum = 0;
+                uint64_t value = 0;
+
+                while (true)
+                {
+                    if (queue.TryPop(value))
+                    {
+                        localSum += value;
+                    }
+                    else if (finishedProducerCount.load(std::memory_order_acquire) == producerCount)
+                    {
+                        // Every value is published, an empty queue stays empty
+                        if (!queue.TryPop(value))
+                        {
+                            break;
+                        }
+
+                        localSum += value;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+
+                poppedSum.fetch_add(localSum, std::memory_order_relaxed);
+            }
+        });
+
+        sum = poppedSum.load(std::memory_order_relaxed);
+        return timer.ElapsedMilliseconds();
+    }
+
+    uint64_t ExpectedSum(uint32_t producerCount)
+    {
+        const uint64_t valueCount = static_cast<uint64_t>(ItemCount / producerCount) * producerCount;
+        return valueCount * (valueCount - 1) / 2;
+    }
+
+    double MillionItemsPerSecond(double elapsedMilliseconds)
+    {
+        return ItemCount / (elapsedMilliseconds * 1000.0);
+    }
+}
+
+// Producers and consumers in equal numbers through one queue, against a mutex guarded ring
+bool biome::bench::RunMpmcQueueBench()
+{
+    const uint32_t threadCounts[] = { 1, 2, 4, 8 };
+
+    printf("%u items, capacity %u, %u hardware threads\n", ItemCount, QueueCapacity, std::thread::hardware_concurrency());
+
+    for (const uint32_t threadCount : threadCounts)
+    {
+        uint64_t sum = 0;
+
+        MpmcQueue<uint64_t> mpmcQueue(QueueCapacity);
+        const double mpmcMilliseconds = Transfer(mpmcQueue, threadCount, threadCount, sum);
+        BENCH_CHECK(sum == ExpectedSum(threadCount));
+
+        LockedRing lockedRing;
+        const double lockedMilliseconds = Transfer(lockedRing, threadCount, threadCount, sum);
+        BENCH_CHECK(sum == ExpectedSum(threadCount));
+
+        printf("%u producers, %u consumers: MpmcQueue %.1f M items/s, mutex ring %.1f M items/s\n",
+            threadCount,
+            threadCount,
+            MillionItemsPerSecond(mpmcMilliseconds),
+            MillionItemsPerSecond(lockedMilliseconds));
+    }
+
+    return true;
+}
+
+// One producer and one consumer, the file system watcher hand-off
+bool biome::bench::RunSpscRingBench()
+{
+    uint64_t sum = 0;
+
+    SpscRing<uint64_t> spscRing(QueueCapacity);
+    const double spscMilliseconds = Transfer(spscRing, 1, 1, sum);
+    BENCH_CHECK(sum == ExpectedSum(1));
+
+    MpmcQueue<uint64_t> mpmcQueue(QueueCapacity);
+    const double mpmcMilliseconds = Transfer(mpmcQueue, 1, 1, sum);
+    BENCH_CHECK(sum == ExpectedSum(1));
+
+    LockedRing lockedRing;
+    const double lockedMilliseconds = Transfer(lockedRing, 1, 1, sum);
+    BENCH_CHECK(sum == ExpectedSum(1));
+
+    printf("%u items, capacity %u: SpscRing %.1f M items/s, MpmcQueue %.1f M items/s, mutex ring %.1f M items/s\n",
+        ItemCount,
+        QueueCapacity,
+        MillionItemsPerSecond(spscMilliseconds),
+        MillionItemsPerSecond(mpmcMilliseconds),
+        MillionItemsPerSecond(lockedMilliseconds));
+
+    return true;
+}
@@ -0,0 +1,122 @@
+#include <span>
+#include <thread>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Threading/TaskCounter.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t BurstTaskCount = 10000;
+    constexpr uint32_t BurstCount = 20;
+
+    constexpr size_t PerThreadHeapByteSize = MiB(64);
+    constexpr size_t PerThreadInitialCommitByteSize = MiB(1);
+
+    class MarkTask : public WorkerTask
+    {
+    public:
+
+        void DoWork() noexcept override { ++m_RunCount; }
+        void OnWorkDone() noexcept override {}
+
+        uint32_t m_RunCount { 0 };
+    };
+
+    struct BurstTimes
+    {
+        double  m_SubmitMicroseconds;
+        double  m_CompleteMicroseconds;
+    };
+
+    // Average time to submit a burst and to see it completed, the main thread only waits
+    template<bool UseBatch>
+    void RunBursts(WorkerThreadPool &threadPool, StaticArray<MarkTask, CleanConstructDestruct> &tasks, StaticArray<WorkerTask*> &taskPointers, BurstTimes &times)
+    {
+        double submitMilliseconds = 0.0;
+        double completeMilliseconds = 0.0;
+
+        for (uint32_t burstIndex = 0; burstIndex < BurstCount; ++burstIndex)
+        {
+            TaskCounter counter;
+
+            for (MarkTask &task : tasks)
+            {
+                task.SetCounter(&counter);
+            }
+
+            BenchTimer timer;
+
+            if constexpr (UseBatch)
+            {
+                threadPool.QueueTasks(std::span<WorkerTask* const>(taskPointers.Data(), BurstTaskCount));
+            }
+            else
+            {
+                for (WorkerTask* const pTask : taskPointers)
+                {
+                    threadPool.QueueTask(pTask);
+                }
+            }
+
+            submitMilliseconds += timer.ElapsedMilliseconds();
+
+            counter.Wait();
+            completeMilliseconds += timer.ElapsedMilliseconds();
+        }
+
+        times.m_SubmitMicroseconds = submitMilliseconds * 1000.0 / BurstCount;
+        times.m_CompleteMicroseconds = completeMilliseconds * 1000.0 / BurstCount;
+    }
+}
+
+// Submission cost of 10k task bursts from a thread which is not a worker, one `QueueTask` per
+// task against a single `QueueTasks`, with and without overflowing the injection queue
+bool biome::bench::RunTaskBurstBench()
+{
+    const uint32_t workerCounts[] = { 4, 16 };
+    const uint32_t queueCapacities[] = { WorkerThreadPool::DefaultDequeCapacity, 16384 };
+
+    printf("%u bursts of %u tasks, %u hardware threads\n", BurstCount, BurstTaskCount, std::thread::hardware_concurrency());
+
+    for (const uint32_t queueCapacity : queueCapacities)
+    {
+        for (const uint32_t workerCount : workerCounts)
+        {
+            WorkerThreadPool threadPool(workerCount, PerThreadHeapByteSize, PerThreadInitialCommitByteSize, queueCapacity);
+            StaticArray<MarkTask, CleanConstructDestruct> tasks(BurstTaskCount);
+            StaticArray<WorkerTask*> taskPointers(BurstTaskCount);
+
+            for (uint32_t taskIndex = 0; taskIndex < BurstTaskCount; ++taskIndex)
+            {
+                taskPointers[taskIndex] = &tasks[taskIndex];
+            }
+
+            BurstTimes singleTimes {};
+            BurstTimes batchTimes {};
+
+            RunBursts<false>(threadPool, tasks, taskPointers, singleTimes);
+            RunBursts<true>(threadPool, tasks, taskPointers, batchTimes);
+
+            for (const MarkTask &task : tasks)
+            {
+                BENCH_CHECK(task.m_RunCount == 2 * BurstCount);
+            }
+
+            printf("capacity %5u, %2u workers: QueueTask submit %.0f us, done %.0f us; QueueTasks submit %.0f us, done %.0f us\n",
+                queueCapacity,
+                workerCount,
+                singleTimes.m_SubmitMicroseconds,
+                singleTimes.m_CompleteMicroseconds,
+                batchTimes.m_SubmitMicroseconds,
+                batchTimes.m_CompleteMicroseconds);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/FileSystem/AsyncFileReader.h"
+#include "biome_core/Threading/Task.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::filesystem;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t WorkerCount = 4;
+    constexpr uint32_t FileByteSize = 100000;
+    constexpr const char* TestFilePath = "biome_bench_async_read.bin";
+    constexpr const char* MissingFilePath = "biome_bench_missing.bin";
+
+    constexpr size_t PerThreadHeapByteSize = MiB(64);
+    constexpr size_t PerThreadInitialCommitByteSize = MiB(1);
+
+    uint8_t GetFileByte(uint32_t index)
+    {
+        return static_cast<uint8_t>(index * 7 + (index >> 8));
+    }
+
+    bool WriteTestFile()
+    {
+        StaticArray<uint8_t> content(FileByteSize);
+
+        for (uint32_t index = 0; index < FileByteSize; ++index)
+        {
+            content[index] = GetFileByte(index);
+        }
+
+        FILE *pFile = nullptr;
+        if (fopen_s(&pFile, TestFilePath, "wb") != 0 || pFile == nullptr)
+        {
+            return false;
+        }
+
+        const bool succeeded = fwrite(content.Data(), sizeof(uint8_t), FileByteSize, pFile) == FileByteSize;
+        fclose(pFile);
+
+        return succeeded;
+    }
+
+    Task<uint32_t> Double(uint32_t value)
+    {
+        co_return value * 2;
+    }
+
+    // Awaits a task per value, each completing inline
+    Task<uint32_t> SumOfDoubles(uint32_t firstValue, uint32_t valueCount)
+    {
+        uint32_t sum = 0;
+
+        for (uint32_t value = firstValue; value < firstValue + valueCount; ++value)
+        {
+            sum += co_await Double(value);
+        }
+
+        co_return sum;
+    }
+
+    Task<void> StoreSumOfDoubles(uint32_t firstValue, uint32_t valueCount, uint32_t &sum)
+    {
+        sum = co_await SumOfDoubles(firstValue, valueCount);
+    }
+
+    // Resumes as a pool task, which `SyncWait` may run itself, then awaits nested tasks from there
+    Task<uint32_t> SumOnPool(WorkerThreadPool &threadPool)
+    {
+        co_await ScheduleOn(threadPool);
+        co_return co_await SumOfDoubles(1, 10);
+    }
+
+    Task<bool> ReadTestFile(AsyncFileReader &reader)
+    {
+        StaticArray<uint8_t> content = co_await reader.Read(TestFilePath);
+
+        if (content.Size() != FileByteSize)
+        {
+            co_return false;
+        }
+
+        for (uint32_t index = 0; index < FileByteSize; ++index)
+        {
+            if (content[index] != GetFileByte(index))
+            {
+                co_return false;
+            }
+        }
+
+        // A file which can't be opened resumes right away, with nothing read
+        StaticArray<uint8_t> missingContent = co_await reader.Read(MissingFilePath);
+        co_return missingContent.Size() == 0;
+    }
+
+    // Submits the read from a pool task, and checks it the same way
+    Task<bool> ReadTestFileOnPool(WorkerThreadPool &threadPool, AsyncFileReader &reader)
+    {
+        co_await ScheduleOn(threadPool);
+        co_return co_await ReadTestFile(reader);
+    }
+}
+
+// Nested `co_await` of `Task`, `ScheduleOn` and `SyncWait`, and `AsyncFileReader` reads of a
+// temporary file, from the calling thread and from a pool task
+bool biome::bench::RunCoroutineTaskTest()
+{
+    WorkerThreadPool threadPool(WorkerCount, PerThreadHeapByteSize, PerThreadInitialCommitByteSize);
+
+    uint32_t sum = 0;
+    SyncWait(threadPool, StoreSumOfDoubles(0, 4, sum));
+    BENCH_CHECK(sum == 12);
+
+    BENCH_CHECK(SyncWait(threadPool, SumOfDoubles(5, 3)) == 36);
+    BENCH_CHECK(SyncWait(threadPool, SumOnPool(threadPool)) == 110);
+
+    BENCH_CHECK(WriteTestFile());
+
+    bool readSucceeded = false;
+    {
+        AsyncFileReader reader(threadPool);
+
+        readSucceeded = SyncWait(threadPool, ReadTestFile(reader))
+            && SyncWait(threadPool, ReadTestFileOnPool(threadPool, reader));
+    }
+
+    remove(TestFilePath);
+    BENCH_CHECK(readSucceeded);
+
+    // `SyncWait` ran pool tasks from this thread, which made it a scratch arena
+    WorkerThreadPool::ReleaseThreadScratchArena();
+
+    return true;
+}
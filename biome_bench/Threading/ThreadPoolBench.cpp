@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/DataStructures/Vector.h"
+#include "biome_core/Threading/TaskCounter.h"
+#include "biome_core/Threading/WorkerThread.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t TaskCount = 100000;
+    constexpr uint32_t LatencySampleCount = 2000;
+    // Enough work for a task to be more than its scheduling, far less than a typical game task
+    constexpr uint32_t WorkIterationCount = 256;
+
+    constexpr size_t PerThreadHeapByteSize = MiB(64);
+    constexpr size_t PerThreadInitialCommitByteSize = MiB(1);
+
+    class CountTask : public WorkerTask
+    {
+    public:
+
+        void DoWork() noexcept override
+        {
+            m_StartTime = std::chrono::steady_clock::now();
+
+            uint64_t value = m_Result + 1;
+
+            for (uint32_t iteration = 0; iteration < WorkIterationCount; ++iteration)
+            {
+                value = value * 6364136223846793005ull + 1442695040888963407ull;
+            }
+
+            m_Result = value;
+        }
+
+        void OnWorkDone() noexcept override {}
+
+        uint64_t                                m_Result { 0 };
+        std::chrono::steady_clock::time_point   m_StartTime {};
+    };
+
+    // Queues its children from a worker, so that they go through the worker deques and stealing
+    class SpawnTask : public WorkerTask
+    {
+    public:
+
+        SpawnTask(WorkerThreadPool &threadPool, StaticArray<CountTask, CleanConstructDestruct> &children, TaskCounter &counter)
+            : m_ThreadPool(threadPool)
+            , m_Children(children)
+            , m_Counter(counter) {}
+
+        void DoWork() noexcept override
+        {
+            for (CountTask &child : m_Children)
+            {
+                child.SetCounter(&m_Counter);
+                m_ThreadPool.QueueTask(&child);
+            }
+        }
+
+        void OnWorkDone() noexcept override {}
+
+    private:
+
+        WorkerThreadPool&                                   m_ThreadPool;
+        StaticArray<CountTask, CleanConstructDestruct>&     m_Children;
+        TaskCounter&                                        m_Counter;
+    };
+
+    // The pool `WorkerThreadPool` replaced: one dispatcher thread pops the tasks from a
+    // mutex protected queue and hands each of them to an idle worker thread
+    class DispatcherPool
+    {
+    public:
+
+        DispatcherPool(uint32_t threadCount, uint32_t taskCapacity)
+            : m_TaskCapacity(taskCapacity)
+            , m_TaskQueue(taskCapacity)
+            , m_AvailableWorkers(threadCount)
+            , m_Workers(threadCount, this)
+            , m_Thread(&DispatcherPool::DispatchTasks, this)
+        {
+            for (Worker &worker : m_Workers)
+            {
+                worker.m_WorkerThread.Init();
+                m_AvailableWorkers.Add(&worker);
+            }
+        }
+
+        ~DispatcherPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_IsRunning = false;
+            }
+
+            m_CondValue.notify_all();
+            m_Thread.join();
+        }
+
+        // `pCounter` was incremented by the caller and is decremented once the task is done.
+        // The queue never grows past its capacity, so it never reallocates.
+        void QueueTask(WorkerTask *pTask, TaskCounter *pCounter)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                BIOME_ASSERT(m_TaskQueue.Size() < m_TaskCapacity);
+                m_TaskQueue.Add(QueuedTask { pTask, pCounter });
+            }
+
+            m_CondValue.notify_all();
+        }
+
+    private:
+
+        struct QueuedTask
+        {
+            WorkerTask*     m_pTask;
+            TaskCounter*    m_pCounter;
+        };
+
+        struct Worker
+        {
+            explicit Worker(DispatcherPool *pPool)
+                : m_pPool(pPool)
+                , m_WorkerThread(&RunTask, PerThreadHeapByteSize, PerThreadInitialCommitByteSize) {}
+
+            DispatcherPool*                                 m_pPool;
+            QueuedTask                                      m_Task {};
+            WorkerThread<Worker*(Worker*) noexcept>         m_WorkerThread;
+        };
+
+        static Worker* RunTask(Worker *pWorker) noexcept
+        {
+            pWorker->m_Task.m_pTask->DoWork();
+            return pWorker;
+        }
+
+        static void OnTaskDone(const WorkerThread<Worker*(Worker*) noexcept>*, Worker *pWorker) noexcept
+        {
+            DispatcherPool* const pPool = pWorker->m_pPool;
+            const QueuedTask task = pWorker->m_Task;
+
+            task.m_pTask->OnWorkDone();
+
+            {
+                std::lock_guard<std::mutex> lock(pPool->m_Mutex);
+                pPool->m_AvailableWorkers.Add(pWorker);
+            }
+
+            pPool->m_CondValue.notify_all();
+
+            // Last, the waiter can destroy the pool once the counter drops
+            task.m_pCounter->Decrement();
+        }
+
+        void DispatchTasks()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            while (m_IsRunning)
+            {
+                if (m_TaskQueue.Size() > 0 && m_AvailableWorkers.Size() > 0)
+                {
+                    Worker* const pWorker = m_AvailableWorkers.PopBack();
+                    pWorker->m_Task = m_TaskQueue.PopBack();
+
+                    lock.unlock();
+                    pWorker->m_WorkerThread.Run(&OnTaskDone, pWorker);
+                    lock.lock();
+                }
+                else
+                {
+                    m_CondValue.wait(lock);
+                }
+            }
+        }
+
+        std::mutex                                  m_Mutex {};
+        std::condition_variable                     m_CondValue {};
+        const uint32_t                              m_TaskCapacity;
+        Vector<QueuedTask>                          m_TaskQueue;
+        Vector<Worker*>                             m_AvailableWorkers;
+        StaticArray<Worker, CleanConstructDestruct> m_Workers;
+        bool                                        m_IsRunning { true };
+        // Last, the dispatcher must only start once the other members are initialized
+        std::thread                                 m_Thread;
+    };
+
+    void QueueCountedTask(WorkerThreadPool &threadPool, CountTask &task, TaskCounter &counter)
+    {
+        task.SetCounter(&counter);
+        threadPool.QueueTask(&task);
+    }
+
+    void QueueCountedTask(DispatcherPool &threadPool, CountTask &task, TaskCounter &counter)
+    {
+        counter.Increment();
+        threadPool.QueueTask(&task, &counter);
+    }
+
+    // Clears the results, so that the next run is checked on its own
+    bool CheckTasksRan(StaticArray<CountTask, CleanConstructDestruct> &tasks)
+    {
+        for (CountTask &task : tasks)
+        {
+            if (task.m_Result == 0)
+            {
+                return false;
+            }
+
+            task.m_Result = 0;
+        }
+
+        return true;
+    }
+
+    // Tasks per second queued from the main thread, which only waits so that the workers alone run them
+    template<typename PoolType>
+    double RunInjected(PoolType &threadPool, StaticArray<CountTask, CleanConstructDestruct> &tasks)
+    {
+        TaskCounter counter;
+        BenchTimer timer;
+
+        for (CountTask &task : tasks)
+        {
+            QueueCountedTask(threadPool, task, counter);
+        }
+
+        counter.Wait();
+        return TaskCount / (timer.ElapsedMilliseconds() / 1000.0);
+    }
+
+    // Tasks per second spawned from inside a task
+    double RunSpawned(WorkerThreadPool &threadPool, StaticArray<CountTask, CleanConstructDestruct> &tasks)
+    {
+        TaskCounter counter;
+        SpawnTask spawnTask(threadPool, tasks, counter);
+        BenchTimer timer;
+
+        spawnTask.SetCounter(&counter);
+        threadPool.QueueTask(&spawnTask);
+
+        counter.Wait();
+        return TaskCount / (timer.ElapsedMilliseconds() / 1000.0);
+    }
+
+    // Median and 99th percentile, in microseconds, from queuing a task on an idle pool to its `DoWork`
+    template<typename PoolType>
+    void RunLatency(PoolType &threadPool, double &medianMicroseconds, double &slowMicroseconds)
+    {
+        StaticArray<double> samples(LatencySampleCount);
+        CountTask task;
+
+        for (double &sample : samples)
+        {
+            TaskCounter counter;
+
+            const std::chrono::steady_clock::time_point queueTime = std::chrono::steady_clock::now();
+            QueueCountedTask(threadPool, task, counter);
+            counter.Wait();
+
+            sample = std::chrono::duration<double, std::micro>(task.m_StartTime - queueTime).count();
+        }
+
+        std::sort(samples.begin(), samples.end());
+        medianMicroseconds = samples[LatencySampleCount / 2];
+        slowMicroseconds = samples[LatencySampleCount * 99 / 100];
+    }
+}
+
+// Throughput of small tasks and single task latency of the work stealing pool, against the
+// dispatcher pool it replaced, at 1, 4 and 16 workers
+bool biome::bench::RunThreadPoolBench()
+{
+    const uint32_t workerCounts[] = { 1, 4, 16 };
+
+    printf("%u tasks, %u hardware threads\n", TaskCount, std::thread::hardware_concurrency());
+
+    for (const uint32_t workerCount : workerCounts)
+    {
+        StaticArray<CountTask, CleanConstructDestruct> tasks(TaskCount);
+
+        {
+            DispatcherPool threadPool(workerCount, TaskCount);
+
+            const double injectedTasksPerSecond = RunInjected(threadPool, tasks);
+            BENCH_CHECK(CheckTasksRan(tasks));
+
+            double medianMicroseconds = 0.0;
+            double slowMicroseconds = 0.0;
+            RunLatency(threadPool, medianMicroseconds, slowMicroseconds);
+
+            printf("%2u workers, dispatcher:    queued %.2f M tasks/s,                         latency median %.1f us, 99%% %.1f us\n",
+                workerCount,
+                injectedTasksPerSecond / 1000000.0,
+                medianMicroseconds,
+                slowMicroseconds);
+        }
+
+        WorkerThreadPool threadPool(workerCount, PerThreadHeapByteSize, PerThreadInitialCommitByteSize);
+
+        const double injectedTasksPerSecond = RunInjected(threadPool, tasks);
+        BENCH_CHECK(CheckTasksRan(tasks));
+
+        const double spawnedTasksPerSecond = RunSpawned(threadPool, tasks);
+        BENCH_CHECK(CheckTasksRan(tasks));
+
+        double medianMicroseconds = 0.0;
+        double slowMicroseconds = 0.0;
+        RunLatency(threadPool, medianMicroseconds, slowMicroseconds);
+
+        printf("%2u workers, work stealing: queued %.2f M tasks/s, spawned %.2f M tasks/s, latency median %.1f us, 99%% %.1f us\n",
+            workerCount,
+            injectedTasksPerSecond / 1000000.0,
+            spawnedTasksPerSecond / 1000000.0,
+            medianMicroseconds,
+            slowMicroseconds);
+    }
+
+    return true;
+}
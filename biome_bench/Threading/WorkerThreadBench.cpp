@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Threading/WorkerThread.h"
+
+using namespace biome::bench;
+using namespace biome::data;
+using namespace biome::threading;
+
+namespace
+{
+    constexpr uint32_t RoundTripCount = 20000;
+
+    constexpr size_t HeapByteSize = MiB(16);
+    constexpr size_t InitialCommitByteSize = KiB(64);
+
+    uint64_t Increment(uint64_t value) noexcept
+    {
+        return value + 1;
+    }
+
+    // The hand-off `WorkerThread` used before its run indices, one mutex and one condition
+    // variable shared by the worker and the waiting threads
+    class LockedWorker
+    {
+    public:
+
+        LockedWorker() : m_Thread(&LockedWorker::ThreadMain, this) {}
+
+        ~LockedWorker()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_IsStopping = true;
+            }
+
+            m_CondValue.notify_all();
+            m_Thread.join();
+        }
+
+        void Run(uint64_t argument)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Argument = argument;
+                m_HasRequest = true;
+            }
+
+            m_CondValue.notify_all();
+        }
+
+        uint64_t Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_CondValue.wait(lock, [&] { return !m_HasRequest; });
+            return m_Result;
+        }
+
+    private:
+
+        void ThreadMain()
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            while (true)
+            {
+                m_CondValue.wait(lock, [&] { return m_HasRequest || m_IsStopping; });
+
+                if (m_IsStopping)
+                {
+                    return;
+                }
+
+                m_Result = Increment(m_Argument);
+                m_HasRequest = false;
+                m_CondValue.notify_all();
+            }
+        }
+
+        std::mutex              m_Mutex {};
+        std::condition_variable m_CondValue {};
+        uint64_t                m_Argument { 0 };
+        uint64_t                m_Result { 0 };
+        bool                    m_HasRequest { false };
+        bool                    m_IsStopping { false };
+        std::thread             m_Thread;
+    };
+
+    // Times `RoundTripCount` Run and Wait pairs, returns false when a result is wrong
+    template<typename WorkerType>
+    bool MeasureRoundTrips(WorkerType &worker, StaticArray<double> &samples)
+    {
+        for (uint32_t tripIndex = 0; tripIndex < RoundTripCount; ++tripIndex)
+        {
+            BenchTimer timer;
+
+            worker.Run(tripIndex);
+            const uint64_t result = worker.Wait();
+
+            samples[tripIndex] = timer.ElapsedMilliseconds() * 1000.0;
+
+            if (result != tripIndex + 1)
+            {
+                return false;
+            }
+        }
+
+        std::sort(samples.begin(), samples.end());
+        return true;
+    }
+
+    void PrintSamples(const char *pName, StaticArray<double> &samples)
+    {
+        printf("%-28s median %.2f us, 99%% %.2f us\n", pName, samples[RoundTripCount / 2], samples[RoundTripCount * 99 / 100]);
+    }
+}
+
+// Round trip latency of Run, Execute and Wait on an idle worker thread, spinning or not,
+// against a mutex and condition variable hand-off
+bool biome::bench::RunWorkerThreadBench()
+{
+    const uint32_t spinCounts[] = { 0, 64, WorkerThread<uint64_t(uint64_t) noexcept>::DefaultSpinCount, 16384 };
+
+    StaticArray<double> samples(RoundTripCount);
+
+    printf("%u round trips, %u hardware threads\n", RoundTripCount, std::thread::hardware_concurrency());
+
+    for (const uint32_t spinCount : spinCounts)
+    {
+        WorkerThread<uint64_t(uint64_t) noexcept> worker(&Increment, HeapByteSize, InitialCommitByteSize, spinCount);
+        worker.Init();
+
+        BENCH_CHECK(MeasureRoundTrips(worker, samples));
+
+        char name[64];
+        snprintf(name, sizeof(name), "WorkerThread, %u spins:", spinCount);
+        PrintSamples(name, samples);
+    }
+
+    {
+        LockedWorker worker;
+
+        BENCH_CHECK(MeasureRoundTrips(worker, samples));
+        PrintSamples("mutex and condition variable:", samples);
+    }
+
+    return true;
+}
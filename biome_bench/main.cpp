@@ -0,0 +1,73 @@
+#include <cstring>
+#include "Bench.h"
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+
+using namespace biome::bench;
+using namespace biome::memory;
+
+namespace
+{
+    const BenchEntry s_Entries[] =
+    {
+        { "offset_allocator_fuzz",  &RunOffsetAllocatorFuzz },
+        { "offset_allocator",       &RunOffsetAllocatorBench },
+        { "small_object_allocator", &RunSmallObjectAllocatorBench },
+        { "memory_registry",        &RunMemoryRegistryBench },
+        { "large_pages",            &RunLargePageBench },
+        { "virtual_memory_stress",  &RunVirtualMemoryStressBench },
+        { "slot_map",               &RunSlotMapBench },
+        { "handle_table",           &RunHandleTableTest },
+        { "mpmc_queue",             &RunMpmcQueueBench },
+        { "spsc_ring",              &RunSpscRingBench },
+        { "thread_pool",            &RunThreadPoolBench },
+        { "parallel_loops",         &RunParallelLoopsBench },
+        { "worker_thread",          &RunWorkerThreadBench },
+        { "task_burst",             &RunTaskBurstBench },
+        { "coroutine_tasks",        &RunCoroutineTaskTest },
+    };
+
+    bool IsSelected(const char *pName, int argc, char *argv[])
+    {
+        if (argc <= 1)
+        {
+            return true;
+        }
+
+        for (int argIndex = 1; argIndex < argc; ++argIndex)
+        {
+            if (strcmp(argv[argIndex], pName) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+// Runs every test and benchmark, or only the ones named on the command line.
+// Returns the number of failed runs.
+int main(int argc, char *argv[])
+{
+    BIOME_ASSERT_ALWAYS_EXEC(ThreadHeapAllocator::Initialize(GiB(1), MiB(100)));
+
+    int failedCount = 0;
+
+    for (const BenchEntry &entry : s_Entries)
+    {
+        if (!IsSelected(entry.m_pName, argc, argv))
+        {
+            continue;
+        }
+
+        printf("[%s]\n", entry.m_pName);
+
+        const bool succeeded = entry.m_pFunction();
+        failedCount += succeeded ? 0 : 1;
+
+        printf("[%s] %s\n\n", entry.m_pName, succeeded ? "passed" : "FAILED");
+    }
+
+    return failedCount;
+}
@@ -4,9 +4,12 @@
 
 #include <type_traits>
 #include <stdio.h>
-#include <comdef.h>
 #include <limits>
 
+#ifdef _MSC_VER
+    #include <comdef.h>
+#endif
+
 #define STRINGIFY(value) STRINGIFY2(value)
 #define STRINGIFY2(value) #value
 #define CONCAT(value0, value1) CONCAT2(value0, value1)
@@ -87,4 +90,42 @@
         #define BIOME_FAIL_MSG(msg) 
     #endif
 
+#endif
+
+// Linux (built with GCC or Clang)
+#ifdef __linux__
+
+    #define EXPORT_SYMBOL __attribute__((visibility("default")))
+    #define PLATFORM_LINUX 1
+
+    #ifdef _DEBUG
+        #define BIOME_ASSERT_MSG(x, msg)                                                                                    \
+        {                                                                                                                   \
+            if (!(x))                                                                                                       \
+            {                                                                                                               \
+                fprintf(stderr, "Assertion failed: %s\n%s\n", #x, msg);                                                     \
+                __builtin_trap();                                                                                           \
+            }                                                                                                               \
+        }
+
+        #define BIOME_ASSERT_MSG_FMT(x, msg, ...)                           \
+        {                                                                   \
+            char tmpFmt[512];                                               \
+            snprintf(tmpFmt, BIOME_ARRAY_SIZE(tmpFmt), msg, __VA_ARGS__);   \
+            BIOME_ASSERT_MSG(x, tmpFmt);                                    \
+        }
+
+        #define BIOME_ASSERT(x) BIOME_ASSERT_MSG(x, "")
+        #define BIOME_ASSERT_ALWAYS_EXEC(x) BIOME_ASSERT(x)
+        #define BIOME_FAIL() BIOME_ASSERT(false)
+        #define BIOME_FAIL_MSG(msg) BIOME_ASSERT_MSG(false, msg)
+    #else
+        #define BIOME_ASSERT_MSG(x, msg)
+        #define BIOME_ASSERT_MSG_FMT(x, msg, ...)
+        #define BIOME_ASSERT(x)
+        #define BIOME_ASSERT_ALWAYS_EXEC(x) (x)
+        #define BIOME_FAIL() 
+        #define BIOME_FAIL_MSG(msg) 
+    #endif
+
 #endif
\ No newline at end of file
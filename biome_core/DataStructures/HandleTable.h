@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "biome_core/Handle/GenerationalHandle.h"
+#include "biome_core/Memory/SubAllocator.h"
+
+namespace biome
+{
+    namespace data
+    {
+        // Fixed capacity table of objects accessed through `GenerationalHandle`.
+        //
+        // Objects live in a single array indexed by their handle, so `Get` is an index plus a
+        // generation check, and `ForEach` walks the live objects linearly. Objects never move:
+        // pointers returned by `Get` stay valid until the object is destroyed.
+        //
+        // Handles are validated in all builds. `Get` returns nullptr for a null or stale handle,
+        // and destroying a stale handle does nothing, both assert in debug builds.
+        //
+        // With `IsThreadSafe`, `Create` and `Destroy` can be called from any thread and take a lock.
+        // `Get` never locks, the object must not be destroyed while other threads use it.
+        // `Create` publishes the slot with a release store once the object is constructed, so a
+        // handle passed to another thread always reaches a constructed object.
+        //
+        // Every object must be destroyed before the table, the destructor asserts otherwise.
+        //
+        template<typename T, bool IsThreadSafe = false>
+        class HandleTable
+        {
+        public:
+
+            using HandleType = GenerationalHandle<T>;
+
+            HandleTable() = default;
+            HandleTable(uint32_t capacity) { Init(capacity); }
+            ~HandleTable();
+
+            HandleTable(const HandleTable&) = delete;
+            HandleTable& operator=(const HandleTable&) = delete;
+
+            void        Init(uint32_t capacity);
+
+            // Returns a null handle when the table is full
+            template<typename ...Args>
+            HandleType  Create(Args&&... args);
+            void        Destroy(HandleType handle);
+
+            bool        IsValid(HandleType handle) const;
+            T*          Get(HandleType handle) const;
+
+            // Calls `function(HandleType, T&)` for every live object, in slot order
+            template<typename FunctionType>
+            void        ForEach(FunctionType &&function);
+
+            uint32_t    Count() const { return m_Count; }
+            uint32_t    Capacity() const { return m_Capacity; }
+
+        private:
+
+            // `m_NextFreeIndex` is `LiveSlot` while the slot holds an object.
+            // Both are read without the lock by `IsValid`, hence atomic.
+            struct Slot
+            {
+                std::atomic<uint32_t>   m_Generation;
+                std::atomic<uint32_t>   m_NextFreeIndex;
+            };
+
+            static constexpr uint32_t LiveSlot = UINT32_MAX - 1;
+            static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+            memory::SubAllocator    m_Allocation {};
+            Slot*                   m_pSlots { nullptr };
+            T*                      m_pValues { nullptr };
+            uint32_t                m_Capacity { 0 };
+            uint32_t                m_Count { 0 };
+            uint32_t                m_FreeListIndex { InvalidIndex };
+            std::mutex              m_Mutex {};
+        };
+    }
+}
+
+#include "HandleTable.inl"
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "HandleTable.h"
+#include <new>
+#include <utility>
+#include "biome_core/Core/Defines.h"
+
+using namespace biome;
+using namespace biome::data;
+
+template<typename T, bool IsThreadSafe>
+HandleTable<T, IsThreadSafe>::~HandleTable()
+{
+    BIOME_ASSERT_MSG(m_Count == 0, "HandleTable: Objects still alive at destruction, most probably leaked handles");
+
+    ForEach([](HandleType, T &value) { value.~T(); });
+}
+
+template<typename T, bool IsThreadSafe>
+void HandleTable<T, IsThreadSafe>::Init(uint32_t capacity)
+{
+    BIOME_ASSERT_MSG(m_pSlots == nullptr, "HandleTable::Init: Already initialized");
+    BIOME_ASSERT_MSG(capacity <= HandleType::MaxIndexCount, "HandleTable::Init: Capacity does not fit in a handle");
+
+    const memory::SubRange<Slot> slots = m_Allocation.Accumulate<Slot>(capacity);
+    const memory::SubRange<T> values = m_Allocation.Accumulate<T>(capacity);
+    m_Allocation.Allocate();
+
+    m_pSlots = m_Allocation.Get(slots).data();
+    m_pValues = m_Allocation.Get(values).data();
+    m_Capacity = capacity;
+
+    // Thread the free list in index order so that consecutive creations are adjacent
+    for (uint32_t index = 0; index < capacity; ++index)
+    {
+        Slot* const pSlot = new (m_pSlots + index) Slot;
+        pSlot->m_Generation.store(0, std::memory_order_relaxed);
+        pSlot->m_NextFreeIndex.store((index + 1 < capacity) ? index + 1 : InvalidIndex, std::memory_order_relaxed);
+    }
+
+    m_FreeListIndex = capacity > 0 ? 0 : InvalidIndex;
+}
+
+template<typename T, bool IsThreadSafe>
+template<typename ...Args>
+typename HandleTable<T, IsThreadSafe>::HandleType HandleTable<T, IsThreadSafe>::Create(Args&&... args)
+{
+    uint32_t index = InvalidIndex;
+
+    {
+        std::unique_lock<std::mutex> lck(m_Mutex, std::defer_lock);
+        if constexpr (IsThreadSafe)
+        {
+            lck.lock();
+        }
+
+        index = m_FreeListIndex;
+
+        if (index == InvalidIndex)
+        {
+            BIOME_FAIL_MSG("HandleTable::Create: Table is full");
+            return HandleType();
+        }
+
+        m_FreeListIndex = m_pSlots[index].m_NextFreeIndex.load(std::memory_order_relaxed);
+        ++m_Count;
+    }
+
+    // Constructed outside of the lock, the slot belongs to this thread now
+    new (m_pValues + index) T(std::forward<Args>(args)...);
+
+    // Release publishes the constructed object to the threads validating the handle
+    Slot& slot = m_pSlots[index];
+    slot.m_NextFreeIndex.store(LiveSlot, std::memory_order_release);
+
+    return HandleType(index, slot.m_Generation.load(std::memory_order_relaxed));
+}
+
+template<typename T, bool IsThreadSafe>
+void HandleTable<T, IsThreadSafe>::Destroy(HandleType handle)
+{
+    const uint32_t index = handle.GetIndex();
+
+    std::unique_lock<std::mutex> lck(m_Mutex, std::defer_lock);
+    if constexpr (IsThreadSafe)
+    {
+        lck.lock();
+    }
+
+    // Validated under the lock, so that only one of the threads destroying the same handle
+    // at once gets past this point
+    if (!IsValid(handle))
+    {
+        BIOME_ASSERT_MSG(handle.IsNull(), "HandleTable::Destroy: Stale handle, most probably already destroyed");
+        return;
+    }
+
+    // Retire the slot and bump the generation so that any remaining copy of the handle is invalidated
+    Slot& slot = m_pSlots[index];
+    slot.m_NextFreeIndex.store(InvalidIndex, std::memory_order_relaxed);
+    slot.m_Generation.store((slot.m_Generation.load(std::memory_order_relaxed) + 1) & HandleType::GenerationMask, std::memory_order_relaxed);
+
+    if constexpr (IsThreadSafe)
+    {
+        lck.unlock();
+    }
+
+    // Destructed outside of the lock, the retired slot can't be reached by anyone else
+    m_pValues[index].~T();
+
+    if constexpr (IsThreadSafe)
+    {
+        lck.lock();
+    }
+
+    slot.m_NextFreeIndex.store(m_FreeListIndex, std::memory_order_relaxed);
+    m_FreeListIndex = index;
+    --m_Count;
+}
+
+template<typename T, bool IsThreadSafe>
+bool HandleTable<T, IsThreadSafe>::IsValid(HandleType handle) const
+{
+    const uint32_t index = handle.GetIndex();
+
+    // Acquire pairs with the release in `Create`
+    return index < m_Capacity
+        && m_pSlots[index].m_NextFreeIndex.load(std::memory_order_acquire) == LiveSlot
+        && m_pSlots[index].m_Generation.load(std::memory_order_relaxed) == handle.GetGeneration();
+}
+
+template<typename T, bool IsThreadSafe>
+T* HandleTable<T, IsThreadSafe>::Get(HandleType handle) const
+{
+    if (!IsValid(handle))
+    {
+        BIOME_FAIL_MSG("HandleTable::Get: Null or stale handle");
+        return nullptr;
+    }
+
+    return m_pValues + handle.GetIndex();
+}
+
+template<typename T, bool IsThreadSafe>
+template<typename FunctionType>
+void HandleTable<T, IsThreadSafe>::ForEach(FunctionType &&function)
+{
+    for (uint32_t index = 0; index < m_Capacity; ++index)
+    {
+        const Slot& slot = m_pSlots[index];
+
+        if (slot.m_NextFreeIndex.load(std::memory_order_acquire) == LiveSlot)
+        {
+            function(HandleType(index, slot.m_Generation.load(std::memory_order_relaxed)), m_pValues[index]);
+        }
+    }
+}
@@ -7,6 +7,7 @@ using namespace biome::data;
 
 IndexFreeList::IndexFreeList(IndexFreeList&& other) noexcept
 {
+    m_Allocation = std::move(other.m_Allocation);
     m_Items = other.m_Items;
     m_Capacity = other.m_Capacity;
     m_Count = other.m_Count;
@@ -17,6 +18,7 @@ IndexFreeList::IndexFreeList(IndexFreeList&& other) noexcept
 
 IndexFreeList& IndexFreeList::operator=(IndexFreeList &&other) noexcept
 {
+    m_Allocation = std::move(other.m_Allocation);
     m_Items = other.m_Items;
     m_Capacity = other.m_Capacity;
     m_Count = other.m_Count;
@@ -29,20 +31,20 @@ IndexFreeList& IndexFreeList::operator=(IndexFreeList &&other) noexcept
 
 void IndexFreeList::Init(uint32_t capacity)
 {
-    m_Capacity = capacity;
-    m_Items = static_cast<Item*>(biome::memory::AlignedAlloc(capacity, alignof(Item)));
+    const memory::SubRange<Item> items = m_Allocation.Accumulate<Item>(capacity);
+    m_Allocation.Allocate();
 
-    for (uint32_t i = 0; i < m_Capacity; ++i)
-    {
-        m_Items[i].m_Next = i + 1;
-    }
+    Init(m_Allocation.Get(items));
 }
 
-IndexFreeList::~IndexFreeList()
+void IndexFreeList::Init(std::span<Item> items)
 {
-    if (m_Items)
+    m_Capacity = static_cast<uint32_t>(items.size());
+    m_Items = items.data();
+
+    for (uint32_t i = 0; i < m_Capacity; ++i)
     {
-        biome::memory::FreeAlignedAlloc(m_Items);
+        m_Items[i].m_Next = i + 1;
     }
 }
 
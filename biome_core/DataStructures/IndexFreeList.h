@@ -1,15 +1,16 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include "biome_core/Handle/Handle.h"
+#include "biome_core/Memory/SubAllocator.h"
 
 namespace biome
 {
     namespace data
     {
-        // Free-list of indices using `Handle` to access.
-        // Used in a `PackedArray` to keep the link between
-        // handles and actual array indices.
+        // Fixed capacity free-list of indices using `Handle` to access.
+        // Keeps the link between handles and actual array indices.
         //
         // All operations in this free-list are in O(1)
         //
@@ -17,12 +18,20 @@ namespace biome
         {
         public:
 
+            struct Item
+            {
+                Handle m_Handle;
+                uint32_t m_Next;
+            };
+
             IndexFreeList() = default;
             IndexFreeList(IndexFreeList&& other) noexcept;
             IndexFreeList& operator=(IndexFreeList &&other) noexcept;
-            ~IndexFreeList();
+            ~IndexFreeList() = default;
 
             void Init(uint32_t capacity);
+            // Uses items owned by the caller, e.g. packed with other arrays through a `SubAllocator`
+            void Init(std::span<Item> items);
             Handle Add(uint32_t index);
             uint32_t Remove(const Handle &handle);
             uint32_t Get(const Handle &handle) const;
@@ -32,18 +41,13 @@ namespace biome
 
         private:
 
-            struct Item
-            {
-                Handle m_Handle;
-                uint32_t m_Next;
-            };
-
             bool ValidateHandle(const Handle& handle) const;
 
-            Item*       m_Items { nullptr };
-            uint32_t    m_Capacity;
-            uint32_t    m_Count { 0 };
-            uint32_t    m_FreeListIndex { 0 };
+            memory::SubAllocator    m_Allocation {};
+            Item*                   m_Items { nullptr };
+            uint32_t                m_Capacity;
+            uint32_t                m_Count { 0 };
+            uint32_t                m_FreeListIndex { 0 };
         };
     }
 }
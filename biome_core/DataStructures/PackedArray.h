@@ -1,47 +1,112 @@
 #pragma once
 
 #include <cstdint>
-#include "IndexFreeList.h"
-#include "biome_core/Handle/Handle.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Handle/GenerationalHandle.h"
+#include "biome_core/Memory/Memory.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
 
 namespace biome
 {
     namespace data
     {
-        // Data structure used to keep a mutable list of objects always 
+        // Data structure used to keep a mutable list of objects always
         // tightly packed so it is possible to iterate over them linearly.
         // As long as nothing is removed from the list, indices are stable.
-        // When objects are removed, indices are not longer valid.
-        // 
-        // To keep a stable access to objects in the array, `Handle` are 
-        // used.
+        // When objects are removed, the last object moves into the hole.
+        //
+        // To keep a stable access to objects in the array, `GenerationalHandle`
+        // are used. They are validated in all builds: `Get` returns nullptr
+        // for a stale handle.
+        //
+        // The values, the handle lookup and the handle of every value each
+        // reserve address space for `maxCapacity` elements up front, and commit
+        // it in chunks of `GrowthChunkCapacity` elements as the array grows.
+        // Growing never moves values, so handles and value pointers stay valid
+        // until the value is removed. Arrays needing more than `DefaultMaxCapacity`
+        // values pass their own max capacity, up to `HandleType::MaxIndexCount`.
+        //
+        // With `IsThreadSafe`, `Add`, `Emplace` and `Remove` can be called from
+        // any thread and take a lock, e.g. for loaders running on workers.
+        // `Get` and `ForEach` never lock: they can run during appends, but not
+        // during a `Remove`, which moves a value.
         //
         // All operations in this list are in O(1)
         //
-        template<typename T>
+        template<typename T, bool IsThreadSafe = false>
         class PackedArray
         {
         public:
 
-            PackedArray(uint32_t capacity);
+            using HandleType = GenerationalHandle<T>;
+
+            static constexpr uint32_t GrowthChunkCapacity = 1024;
+            static constexpr uint32_t DefaultMaxCapacity = 64 * GrowthChunkCapacity;
+
+            PackedArray(uint32_t initialCapacity = GrowthChunkCapacity, uint32_t maxCapacity = DefaultMaxCapacity);
             PackedArray(PackedArray&& other) noexcept;
             PackedArray& operator=(PackedArray &&other) noexcept;
             ~PackedArray();
 
-            Handle Add(T &value);
-            void Remove(const Handle &handle);
-            T* Get(const Handle &handle) const;
+            PackedArray(const PackedArray&) = delete;
+            PackedArray& operator=(const PackedArray&) = delete;
+
+            HandleType Add(const T &value) { return Emplace(value); }
+            HandleType Add(T &&value) { return Emplace(std::move(value)); }
+            template<typename ...Args>
+            HandleType Emplace(Args&&... args);
+            void Remove(HandleType handle);
+
+            bool IsValid(HandleType handle) const;
+            T* Get(HandleType handle) const;
+
+            // Calls `function(HandleType, T&)` for every value in packed order. Values added
+            // while it runs are not visited.
+            template<typename FunctionType>
+            void ForEach(FunctionType &&function);
+
             T* GetIterator() { return m_Values; }
             const T* GetIterator() const { return m_Values; }
-            uint32_t Count() const { return m_Lookup.Count(); }
-            Handle GetHandleFromIndex(uint32_t index) const;
+            uint32_t Count() const { return m_Count.load(std::memory_order_acquire); }
+            uint32_t Capacity() const { return m_CommittedCapacity; }
+            HandleType GetHandleFromIndex(uint32_t index) const;
 
         private:
 
-            IndexFreeList   m_Lookup {};
-            Handle*         m_LookupHandles { nullptr };
-            T*              m_Values { nullptr };
-            uint32_t        m_NextIndex { 0 };
+            // Links a handle to its value, or to the next free slot when the slot is free.
+            // Atomic as `IsValid` reads them while `Emplace` reuses a free slot.
+            struct Slot
+            {
+                std::atomic<uint32_t> m_Generation;
+                std::atomic<uint32_t> m_ValueIndex;
+            };
+
+            static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+            template<typename ValueType>
+            static ValueType* Reserve(uint32_t maxCapacity, uint32_t initialCapacity);
+            template<typename ValueType>
+            static void Commit(ValueType *pValues, uint32_t committedCapacity, uint32_t newCapacity);
+
+            void Grow(uint32_t requiredCapacity);
+            void Release();
+
+            Slot*                   m_Slots { nullptr };
+            HandleType*             m_ValueHandles { nullptr };
+            T*                      m_Values { nullptr };
+            // Release store once a value is constructed, so that lock-free readers only see complete values
+            std::atomic<uint32_t>   m_Count { 0 };
+            // Atomic as `IsValid` reads it during appends
+            std::atomic<uint32_t>   m_SlotCount { 0 };
+            uint32_t                m_FreeSlotIndex { InvalidIndex };
+            uint32_t                m_CommittedCapacity { 0 };
+            uint32_t                m_MaxCapacity { 0 };
+            std::mutex              m_Mutex {};
         };
     }
 }
@@ -49,83 +114,249 @@ namespace biome
 using namespace biome;
 using namespace biome::data;
 
-template<typename T>
-PackedArray<T>::PackedArray(uint32_t capacity)
+template<typename T, bool IsThreadSafe>
+PackedArray<T, IsThreadSafe>::PackedArray(uint32_t initialCapacity, uint32_t maxCapacity)
+    : m_CommittedCapacity(std::min(initialCapacity, maxCapacity))
+    , m_MaxCapacity(maxCapacity)
 {
-    m_Lookup.Init(capacity);
-    m_LookupHandles = static_cast<Handle*>(biome::memory::AlignedAlloc(capacity * sizeof(Handle), alignof(Handle)));
-    m_Values = static_cast<T*>(biome::memory::AlignedAlloc(capacity * sizeof(T), alignof(T)));
+    BIOME_ASSERT_MSG(maxCapacity > 0 && maxCapacity <= HandleType::MaxIndexCount, "PackedArray: Max capacity does not fit in a handle");
+
+    m_Slots = Reserve<Slot>(m_MaxCapacity, m_CommittedCapacity);
+    m_ValueHandles = Reserve<HandleType>(m_MaxCapacity, m_CommittedCapacity);
+    m_Values = Reserve<T>(m_MaxCapacity, m_CommittedCapacity);
 }
 
-template<typename T>
-PackedArray<T>::PackedArray(PackedArray&& other) noexcept
+template<typename T, bool IsThreadSafe>
+PackedArray<T, IsThreadSafe>::PackedArray(PackedArray&& other) noexcept
 {
-    m_Lookup = std::move(other.m_Lookup);
-    m_LookupHandles = other.m_LookupHandles;
-    m_Values = other.m_Values;
-    m_NextIndex = other.m_NextIndex;
-
-    other.m_LookupHandles = nullptr;
-    other.m_Values = nullptr;
+    *this = std::move(other);
 }
 
-template<typename T>
-PackedArray<T>& PackedArray<T>::operator=(PackedArray<T> &&other) noexcept
+template<typename T, bool IsThreadSafe>
+PackedArray<T, IsThreadSafe>& PackedArray<T, IsThreadSafe>::operator=(PackedArray<T, IsThreadSafe> &&other) noexcept
 {
-    m_Lookup = std::move(other.m_Lookup);
-    m_LookupHandles = other.m_LookupHandles;
-    m_Values = other.m_Values;
-    m_NextIndex = other.m_NextIndex;
+    if (this != &other)
+    {
+        Release();
 
-    other.m_LookupHandles = nullptr;
-    other.m_Values = nullptr;
+        m_Slots = std::exchange(other.m_Slots, nullptr);
+        m_ValueHandles = std::exchange(other.m_ValueHandles, nullptr);
+        m_Values = std::exchange(other.m_Values, nullptr);
+        m_Count.store(other.m_Count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_SlotCount.store(other.m_SlotCount.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_FreeSlotIndex = std::exchange(other.m_FreeSlotIndex, InvalidIndex);
+        m_CommittedCapacity = std::exchange(other.m_CommittedCapacity, 0);
+        m_MaxCapacity = std::exchange(other.m_MaxCapacity, 0);
+    }
 
     return *this;
 }
 
-template<typename T>
-PackedArray<T>::~PackedArray()
+template<typename T, bool IsThreadSafe>
+PackedArray<T, IsThreadSafe>::~PackedArray()
 {
-    biome::memory::FreeAlignedAlloc(m_Values);
-    biome::memory::FreeAlignedAlloc(m_LookupHandles);
+    Release();
 }
 
-template<typename T>
-biome::Handle PackedArray<T>::Add(T &value)
+template<typename T, bool IsThreadSafe>
+template<typename ...Args>
+typename PackedArray<T, IsThreadSafe>::HandleType PackedArray<T, IsThreadSafe>::Emplace(Args&&... args)
 {
-    BIOME_ASSERT_MSG(m_NextIndex < m_Lookup.Capacity(), "PackedArray<T>::Add: Capacity overflow.");
+    std::unique_lock<std::mutex> lck(m_Mutex, std::defer_lock);
+    if constexpr (IsThreadSafe)
+    {
+        lck.lock();
+    }
+
+    const uint32_t valueIndex = m_Count.load(std::memory_order_relaxed);
+    const uint32_t slotCount = m_SlotCount.load(std::memory_order_relaxed);
+    const bool needsNewSlot = m_FreeSlotIndex == InvalidIndex;
 
-    uint32_t newIndex = m_NextIndex++;
-    Handle newHdl = m_Lookup.Add(newIndex);
-    m_LookupHandles[newIndex] = newHdl;
-    m_Values[newIndex] = value;
+    if (valueIndex == m_MaxCapacity || (needsNewSlot && slotCount == m_MaxCapacity))
+    {
+        BIOME_FAIL_MSG("PackedArray::Emplace: Max capacity reached");
+        return HandleType();
+    }
 
-    return newHdl;
+    Grow(std::max(valueIndex + 1, needsNewSlot ? slotCount + 1 : 0));
+
+    uint32_t slotIndex = m_FreeSlotIndex;
+
+    if (needsNewSlot)
+    {
+        slotIndex = slotCount;
+        Slot* const pSlot = new (m_Slots + slotIndex) Slot;
+        pSlot->m_Generation.store(0, std::memory_order_relaxed);
+        pSlot->m_ValueIndex.store(InvalidIndex, std::memory_order_relaxed);
+        m_SlotCount.store(slotCount + 1, std::memory_order_release);
+    }
+    else
+    {
+        m_FreeSlotIndex = m_Slots[slotIndex].m_ValueIndex.load(std::memory_order_relaxed);
+    }
+
+    // Readers only follow the value index once the count covers it, see `IsValid`
+    Slot& slot = m_Slots[slotIndex];
+    slot.m_ValueIndex.store(valueIndex, std::memory_order_relaxed);
+
+    const HandleType handle(slotIndex, slot.m_Generation.load(std::memory_order_relaxed));
+    m_ValueHandles[valueIndex] = handle;
+    new (m_Values + valueIndex) T(std::forward<Args>(args)...);
+
+    m_Count.store(valueIndex + 1, std::memory_order_release);
+
+    return handle;
 }
 
-template<typename T>
-void PackedArray<T>::Remove(const Handle &handle)
+template<typename T, bool IsThreadSafe>
+void PackedArray<T, IsThreadSafe>::Remove(HandleType handle)
 {
-    BIOME_ASSERT_MSG(m_NextIndex > 0, "PackedArray<T>::Remove: Removing from empty array");
+    std::unique_lock<std::mutex> lck(m_Mutex, std::defer_lock);
+    if constexpr (IsThreadSafe)
+    {
+        lck.lock();
+    }
+
+    if (!IsValid(handle))
+    {
+        BIOME_FAIL_MSG("PackedArray::Remove: Invalid handle. Most probably already removed");
+        return;
+    }
+
+    const uint32_t lastIndex = m_Count.load(std::memory_order_relaxed) - 1;
+    Slot& slot = m_Slots[handle.GetIndex()];
+    const uint32_t valueIndex = slot.m_ValueIndex.load(std::memory_order_relaxed);
 
-    --m_NextIndex;
-    uint32_t valueIndex = m_Lookup.Remove(handle);
+    m_Values[valueIndex].~T();
 
-    m_Values[valueIndex] = m_Values[m_NextIndex];
-    m_LookupHandles[valueIndex] = m_LookupHandles[m_NextIndex];
+    // Nothing to move when removing the last value
+    if (valueIndex != lastIndex)
+    {
+        new (m_Values + valueIndex) T(std::move(m_Values[lastIndex]));
+        m_Values[lastIndex].~T();
+
+        m_ValueHandles[valueIndex] = m_ValueHandles[lastIndex];
+        m_Slots[m_ValueHandles[valueIndex].GetIndex()].m_ValueIndex.store(valueIndex, std::memory_order_relaxed);
+    }
 
-    m_Lookup.Update(m_LookupHandles[valueIndex], valueIndex);
+    m_Count.store(lastIndex, std::memory_order_release);
+
+    // Bump the generation so that any remaining copy of the handle is invalidated
+    slot.m_Generation.store((slot.m_Generation.load(std::memory_order_relaxed) + 1) & HandleType::GenerationMask, std::memory_order_relaxed);
+    slot.m_ValueIndex.store(m_FreeSlotIndex, std::memory_order_relaxed);
+    m_FreeSlotIndex = handle.GetIndex();
 }
 
-template<typename T>
-T* PackedArray<T>::Get(const Handle &handle) const
+template<typename T, bool IsThreadSafe>
+bool PackedArray<T, IsThreadSafe>::IsValid(HandleType handle) const
 {
-    uint32_t index = m_Lookup.Get(handle);
-    return &m_Values[index];
+    const uint32_t slotIndex = handle.GetIndex();
+
+    if (slotIndex >= m_SlotCount.load(std::memory_order_acquire) || m_Slots[slotIndex].m_Generation.load(std::memory_order_relaxed) != handle.GetGeneration())
+    {
+        return false;
+    }
+
+    // Free slots link to other slots, only a live one is pointed back by its value.
+    // A value index at or past the count is being written by `Emplace`, not published yet.
+    const uint32_t valueIndex = m_Slots[slotIndex].m_ValueIndex.load(std::memory_order_relaxed);
+    return valueIndex < m_Count.load(std::memory_order_acquire) && m_ValueHandles[valueIndex] == handle;
+}
+
+template<typename T, bool IsThreadSafe>
+T* PackedArray<T, IsThreadSafe>::Get(HandleType handle) const
+{
+    if (!IsValid(handle))
+    {
+        BIOME_FAIL_MSG("PackedArray::Get: Null or stale handle");
+        return nullptr;
+    }
+
+    return &m_Values[m_Slots[handle.GetIndex()].m_ValueIndex.load(std::memory_order_relaxed)];
+}
+
+template<typename T, bool IsThreadSafe>
+template<typename FunctionType>
+void PackedArray<T, IsThreadSafe>::ForEach(FunctionType &&function)
+{
+    const uint32_t count = m_Count.load(std::memory_order_acquire);
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        function(m_ValueHandles[index], m_Values[index]);
+    }
+}
+
+template<typename T, bool IsThreadSafe>
+typename PackedArray<T, IsThreadSafe>::HandleType PackedArray<T, IsThreadSafe>::GetHandleFromIndex(uint32_t index) const
+{
+    return m_ValueHandles[index];
+}
+
+template<typename T, bool IsThreadSafe>
+template<typename ValueType>
+ValueType* PackedArray<T, IsThreadSafe>::Reserve(uint32_t maxCapacity, uint32_t initialCapacity)
+{
+    // Page aligned so that the committed range always starts on a page
+    const size_t pageSize = memory::VirtualMemoryAllocator::GetSystemPageSize();
+    return static_cast<ValueType*>(memory::VirtualMemoryAllocator::Allocate(
+        sizeof(ValueType) * maxCapacity,
+        memory::Align(sizeof(ValueType) * initialCapacity, pageSize),
+        pageSize));
 }
 
-template<typename T>
-biome::Handle PackedArray<T>::GetHandleFromIndex(uint32_t index) const
+template<typename T, bool IsThreadSafe>
+template<typename ValueType>
+void PackedArray<T, IsThreadSafe>::Commit(ValueType *pValues, uint32_t committedCapacity, uint32_t newCapacity)
 {
-    return m_LookupHandles[index];
+    const size_t pageSize = memory::VirtualMemoryAllocator::GetSystemPageSize();
+    const size_t committedByteSize = memory::Align(sizeof(ValueType) * committedCapacity, pageSize);
+    const size_t newByteSize = memory::Align(sizeof(ValueType) * newCapacity, pageSize);
+
+    if (newByteSize > committedByteSize)
+    {
+        memory::VirtualMemoryAllocator::Commit(reinterpret_cast<uint8_t*>(pValues) + committedByteSize, newByteSize - committedByteSize);
+    }
+}
+
+template<typename T, bool IsThreadSafe>
+void PackedArray<T, IsThreadSafe>::Grow(uint32_t requiredCapacity)
+{
+    if (requiredCapacity <= m_CommittedCapacity)
+    {
+        return;
+    }
+
+    const uint32_t chunkCount = (requiredCapacity + GrowthChunkCapacity - 1) / GrowthChunkCapacity;
+    const uint32_t newCapacity = std::min(chunkCount * GrowthChunkCapacity, m_MaxCapacity);
+
+    Commit(m_Slots, m_CommittedCapacity, newCapacity);
+    Commit(m_ValueHandles, m_CommittedCapacity, newCapacity);
+    Commit(m_Values, m_CommittedCapacity, newCapacity);
+
+    m_CommittedCapacity = newCapacity;
+}
+
+template<typename T, bool IsThreadSafe>
+void PackedArray<T, IsThreadSafe>::Release()
+{
+    if (m_Values == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t count = m_Count.load(std::memory_order_relaxed);
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        m_Values[index].~T();
+    }
+
+    memory::VirtualMemoryAllocator::Release(m_Values);
+    memory::VirtualMemoryAllocator::Release(m_ValueHandles);
+    memory::VirtualMemoryAllocator::Release(m_Slots);
+
+    m_Values = nullptr;
+    m_ValueHandles = nullptr;
+    m_Slots = nullptr;
+    m_Count.store(0, std::memory_order_relaxed);
 }
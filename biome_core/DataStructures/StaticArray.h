@@ -32,7 +32,7 @@ namespace biome
 
             template<typename... Args>
             StaticArray(const size_t size, Args&&... args)
-                : StaticArray(size)
+                : StaticArray(size, UninitializedTag {})
             {
                 for (size_t index = 0; index < size; ++index)
                 {
@@ -57,6 +57,11 @@ namespace biome
 
         private:
 
+            struct UninitializedTag {};
+
+            // Allocates the items without constructing them
+            StaticArray(size_t size, UninitializedTag);
+
             template<typename... AddValueType, typename = std::enable_if_t<(... && std::is_same_v<ValueType, AddValueType>)>>
             void SetValues(const size_t index, ValueType&& value, AddValueType&&... values)
             {
@@ -16,20 +16,25 @@ StaticArray<ValueType, CleanConstructDelete, AllocatorType>::StaticArray()
 
 template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
 StaticArray<ValueType, CleanConstructDelete, AllocatorType>::StaticArray(size_t size)
+    : StaticArray(size, UninitializedTag {})
+{
+    if constexpr (CleanConstructDelete)
+    {
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            new(m_pData + i) ValueType();
+        }
+    }
+}
+
+template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+StaticArray<ValueType, CleanConstructDelete, AllocatorType>::StaticArray(size_t size, UninitializedTag)
     : m_pData(nullptr)
     , m_size(size)
 {
     if(size > 0)
     {
         m_pData = static_cast<ValueType*>(AllocatorType::Allocate(sizeof(ValueType) * size));
-
-        if constexpr (CleanConstructDelete)
-        {
-            for (size_t i = 0; i < m_size; ++i)
-            {
-                new(m_pData + i) ValueType();
-            }
-        }
     }
 }
 
@@ -0,0 +1,119 @@
+#include <pch.h>
+#include "AsyncFileReader.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+
+using namespace biome::filesystem;
+using namespace biome::threading;
+
+bool AsyncFileReader::ReadAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    if (fopen_s(&m_pFile, m_pFilePath, "rb") != 0 || m_pFile == nullptr)
+    {
+        // Resume right away with an empty content
+        return false;
+    }
+
+    const long fileSize = fseek(m_pFile, 0, SEEK_END) == 0 ? ftell(m_pFile) : -1;
+
+    if (fileSize < 0)
+    {
+        // Not seekable, or too large to report its size, read as failed
+        fclose(m_pFile);
+        m_pFile = nullptr;
+        return false;
+    }
+
+    fseek(m_pFile, 0, SEEK_SET);
+
+    m_content = StaticArray<uint8_t>(static_cast<size_t>(fileSize));
+    m_handle = handle;
+    m_pReader->Submit(this);
+    return true;
+}
+
+StaticArray<uint8_t> AsyncFileReader::ReadAwaiter::await_resume()
+{
+    if (m_readFailed)
+    {
+        m_content = StaticArray<uint8_t>();
+    }
+
+    return std::move(m_content);
+}
+
+AsyncFileReader::AsyncFileReader(WorkerThreadPool &threadPool)
+    : m_threadPool(threadPool)
+    , m_thread(ThreadMain, this)
+{
+
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_isRunning = false;
+    }
+
+    m_conditionVar.notify_one();
+    m_thread.join();
+}
+
+void AsyncFileReader::Submit(ReadAwaiter *pRead)
+{
+    // Notify under the lock: once the read is queued, it can complete and let the owner
+    // destroy the reader before an unlocked notify would run
+    std::lock_guard<std::mutex> lck(m_mutex);
+    BIOME_ASSERT_MSG(m_isRunning, "Read submitted to a destroyed AsyncFileReader");
+
+    if (m_pLastRead != nullptr)
+    {
+        m_pLastRead->m_pNext = pRead;
+    }
+    else
+    {
+        m_pFirstRead = pRead;
+    }
+
+    m_pLastRead = pRead;
+    m_conditionVar.notify_one();
+}
+
+void AsyncFileReader::ThreadMain(AsyncFileReader *pReader)
+{
+    pReader->ProcessReads();
+}
+
+void AsyncFileReader::ProcessReads()
+{
+    std::unique_lock<std::mutex> lck(m_mutex);
+
+    while (true)
+    {
+        m_conditionVar.wait(lck, [&] { return m_pFirstRead != nullptr || !m_isRunning; });
+
+        if (m_pFirstRead == nullptr)
+        {
+            // Stopped and drained
+            break;
+        }
+
+        ReadAwaiter* pRead = m_pFirstRead;
+        m_pFirstRead = pRead->m_pNext;
+        m_pLastRead = m_pFirstRead != nullptr ? m_pLastRead : nullptr;
+        pRead->m_pNext = nullptr;
+
+        lck.unlock();
+        {
+            const size_t byteSize = pRead->m_content.Size();
+            const size_t bytesRead = byteSize > 0 ? fread(pRead->m_content.Data(), sizeof(uint8_t), byteSize, pRead->m_pFile) : 0;
+            fclose(pRead->m_pFile);
+            pRead->m_pFile = nullptr;
+
+            // Partial reads are reported as failures, the buffer is released on the awaiting side
+            pRead->m_readFailed = bytesRead != byteSize;
+            m_threadPool.QueueTask(pRead);
+        }
+        lck.lock();
+    }
+}
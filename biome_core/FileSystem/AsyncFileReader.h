@@ -0,0 +1,84 @@
+#pragma once
+
+#include <coroutine>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/Threading/WorkerTask.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        class WorkerThreadPool;
+    }
+
+    namespace filesystem
+    {
+        // Reads whole files for coroutines without blocking pool workers.
+        //
+        // `co_await reader.Read(pFilePath)` suspends the coroutine and hands the read to the
+        // reader's I/O thread. Once the file is loaded, the coroutine resumes on a worker of the
+        // thread pool with the file content, or an empty array if the file can't be read.
+        // The file is opened and its buffer allocated on the awaiting thread, from its thread
+        // heap, so the I/O thread only blocks on the read itself. Reads complete in submission order.
+        //
+        class AsyncFileReader
+        {
+        public:
+
+            class ReadAwaiter : public threading::WorkerTask
+            {
+            public:
+
+                ReadAwaiter(AsyncFileReader *pReader, const char *pFilePath)
+                    : WorkerTask(true), m_pReader(pReader), m_pFilePath(pFilePath) {}
+
+                bool await_ready() const noexcept { return false; }
+                bool await_suspend(std::coroutine_handle<> handle);
+                StaticArray<uint8_t> await_resume();
+
+                void DoWork() noexcept override { m_handle.resume(); }
+                void OnWorkDone() noexcept override {}
+
+            private:
+
+                friend class AsyncFileReader;
+
+                AsyncFileReader*        m_pReader;
+                const char*             m_pFilePath;
+                FILE*                   m_pFile { nullptr };
+                StaticArray<uint8_t>    m_content {};
+                std::coroutine_handle<> m_handle {};
+                ReadAwaiter*            m_pNext { nullptr };
+                bool                    m_readFailed { false };
+            };
+
+            AsyncFileReader(threading::WorkerThreadPool &threadPool);
+            ~AsyncFileReader();
+
+            AsyncFileReader(const AsyncFileReader&) = delete;
+            AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+            // `pFilePath` must stay valid until the read completes
+            ReadAwaiter Read(const char *pFilePath) { return ReadAwaiter(this, pFilePath); }
+
+        private:
+
+            static void ThreadMain(AsyncFileReader *pReader);
+
+            void Submit(ReadAwaiter *pRead);
+            void ProcessReads();
+
+            threading::WorkerThreadPool& m_threadPool;
+            ReadAwaiter* m_pFirstRead { nullptr };
+            ReadAwaiter* m_pLastRead { nullptr };
+            std::mutex m_mutex {};
+            std::condition_variable m_conditionVar {};
+            bool m_isRunning { true };
+            std::thread m_thread;
+        };
+    }
+}
@@ -5,6 +5,21 @@
 using namespace biome::filesystem;
 using namespace biome::memory;
 
+namespace
+{
+	FileSystemChange ToFileSystemChange(DWORD action)
+	{
+		switch (action)
+		{
+		case FILE_ACTION_ADDED:				return FileSystemChange::Added;
+		case FILE_ACTION_REMOVED:			return FileSystemChange::Removed;
+		case FILE_ACTION_RENAMED_OLD_NAME:	return FileSystemChange::RenamedFrom;
+		case FILE_ACTION_RENAMED_NEW_NAME:	return FileSystemChange::RenamedTo;
+		default:							return FileSystemChange::Modified;
+		}
+	}
+}
+
 DWORD WINAPI FileSystemWatcher::ThreadProc(void* pContext)
 {
 	FileSystemWatcher* pWatcher = static_cast<FileSystemWatcher*>(pContext);
@@ -15,13 +30,51 @@ DWORD WINAPI FileSystemWatcher::ThreadProc(void* pContext)
 bool FileSystemWatcher::Initialize(FileSystemWatcherCallback callback)
 {
 	m_callback = callback;
+	m_notifications.Init(NotificationCapacity);
+
+	m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+	if (m_wakeEvent == NULL)
+	{
+		return false;
+	}
+
+	m_isRunning = true;
 	m_thread = CreateThread(nullptr, 0, ThreadProc, this, 0, nullptr);
 	return m_thread != NULL;
 }
 
 FileSystemWatcher::~FileSystemWatcher()
 {
+	if (m_thread != NULL)
+	{
+		{
+			std::unique_lock<std::mutex> lck(m_mutex);
+			m_isRunning = false;
+		}
+
+		SetEvent(m_wakeEvent);
+		WaitForSingleObject(m_thread, INFINITE);
+		CloseHandle(m_thread);
+	}
+
+	for (auto& pair : m_watchedDirectories)
+	{
+		WatchedDirectoryData& data = pair.second;
+
+		// The pending read writes into the buffer, wait for its cancellation before releasing it
+		DWORD byteCount = 0;
+		CancelIoEx(data.m_directory, &data.m_overlapped);
+		GetOverlappedResult(data.m_directory, &data.m_overlapped, &byteCount, TRUE);
 
+		CloseHandle(data.m_directory);
+		CloseHandle(data.m_overlapped.hEvent);
+	}
+
+	if (m_wakeEvent != NULL)
+	{
+		CloseHandle(m_wakeEvent);
+	}
 }
 
 bool FileSystemWatcher::WatchDirectory(const wchar_t* directoryPath)
@@ -60,19 +113,10 @@ bool FileSystemWatcher::WatchDirectory(const wchar_t* directoryPath)
 	auto pair = m_watchedDirectories.emplace(std::make_pair(std::move(filePath), WatchedDirectoryData {}));
 	WatchedDirectoryData& data = pair.first->second;
 
+	data.m_directory = dirHdl;
 	data.m_overlapped.hEvent = eventHdl;
 
-	BOOL operationQueued = ReadDirectoryChangesW(
-		dirHdl,
-		data.m_notificationBuffer,
-		ARRAYSIZE(data.m_notificationBuffer),
-		TRUE,
-		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
-		nullptr,
-		&data.m_overlapped,
-		nullptr);
-
-	if (!operationQueued)
+	if (!IssueDirectoryRead(data))
 	{
 		CloseHandle(dirHdl);
 		CloseHandle(eventHdl);
@@ -81,6 +125,9 @@ bool FileSystemWatcher::WatchDirectory(const wchar_t* directoryPath)
 		return false;
 	}
 
+	// Have the watcher thread wait on the new directory too
+	SetEvent(m_wakeEvent);
+
 	return true;
 }
 
@@ -94,22 +141,123 @@ void FileSystemWatcher::StopAllWatching()
 	std::unique_lock<std::mutex> lck(m_mutex);
 }
 
+bool FileSystemWatcher::PopNotification(FileSystemNotification& notification)
+{
+	return m_notifications.TryPop(notification);
+}
+
+bool FileSystemWatcher::IssueDirectoryRead(WatchedDirectoryData& data)
+{
+	return ReadDirectoryChangesW(
+		data.m_directory,
+		data.m_notificationBuffer,
+		ARRAYSIZE(data.m_notificationBuffer),
+		TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+		nullptr,
+		&data.m_overlapped,
+		nullptr);
+}
+
 void FileSystemWatcher::ProcessNotifications()
 {
-	std::unique_lock<std::mutex> lck(m_mutex);
+	HANDLE events[MAXIMUM_WAIT_OBJECTS];
 
-	while (m_isRunning)
+	while (true)
 	{
+		DWORD eventCount = 0;
 
+		{
+			std::unique_lock<std::mutex> lck(m_mutex);
+
+			if (!m_isRunning)
+			{
+				break;
+			}
+
+			events[eventCount++] = m_wakeEvent;
 
-		for (auto& pair : m_watchedDirectories)
+			for (auto& pair : m_watchedDirectories)
+			{
+				if (eventCount == MAXIMUM_WAIT_OBJECTS)
+				{
+					break;
+				}
+
+				events[eventCount++] = pair.second.m_overlapped.hEvent;
+			}
+		}
+
+		const DWORD result = WaitForMultipleObjects(eventCount, events, FALSE, INFINITE);
+
+		if (result == WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + eventCount)
 		{
-			const WatchedDirectoryData& data = pair.second;
+			// Woken up to refresh the directories or to stop
+			continue;
 		}
 
+		bool hasNotifications = false;
 
+		{
+			std::unique_lock<std::mutex> lck(m_mutex);
 
+			for (auto& pair : m_watchedDirectories)
+			{
+				if (pair.second.m_overlapped.hEvent == events[result - WAIT_OBJECT_0])
+				{
+					hasNotifications = ProcessDirectoryChanges(pair.first, pair.second);
+					break;
+				}
+			}
+		}
 
-		m_conditionVar.wait(lck);
+		if (hasNotifications && m_callback != nullptr)
+		{
+			m_callback();
+		}
+	}
+}
+
+bool FileSystemWatcher::ProcessDirectoryChanges(const std::wstring& directoryPath, WatchedDirectoryData& data)
+{
+	bool hasNotifications = false;
+	DWORD byteCount = 0;
+
+	// A byte count of 0 means the buffer overflowed and the changes are lost
+	if (GetOverlappedResult(data.m_directory, &data.m_overlapped, &byteCount, FALSE) && byteCount > 0)
+	{
+		const uint8_t* pEntry = data.m_notificationBuffer;
+
+		while (true)
+		{
+			const FILE_NOTIFY_INFORMATION* pInfo = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(pEntry);
+
+			const size_t directoryLength = directoryPath.size();
+			const size_t fileNameLength = pInfo->FileNameLength / sizeof(wchar_t);
+
+			if (directoryLength + 1 + fileNameLength < MaxNotificationPathLength)
+			{
+				FileSystemNotification notification;
+				notification.m_change = ToFileSystemChange(pInfo->Action);
+				wmemcpy(notification.m_path, directoryPath.c_str(), directoryLength);
+				notification.m_path[directoryLength] = L'\\';
+				wmemcpy(notification.m_path + directoryLength + 1, pInfo->FileName, fileNameLength);
+				notification.m_path[directoryLength + 1 + fileNameLength] = L'\0';
+
+				// Never block the watcher on a consumer lagging behind, drop the change instead
+				hasNotifications |= m_notifications.TryPush(std::move(notification));
+			}
+
+			if (pInfo->NextEntryOffset == 0)
+			{
+				break;
+			}
+
+			pEntry += pInfo->NextEntryOffset;
+		}
 	}
+
+	IssueDirectoryRead(data);
+
+	return hasNotifications;
 }
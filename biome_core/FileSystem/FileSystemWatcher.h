@@ -3,18 +3,48 @@
 #include <map>
 #include <string>
 #include <mutex>
-#include <condition_variable>
+
+#include "biome_core/Threading/SpscRing.h"
 
 namespace biome
 {
     namespace filesystem
     {
+        enum class FileSystemChange
+        {
+            Added,
+            Removed,
+            Modified,
+            RenamedFrom,
+            RenamedTo
+        };
+
+        // Null terminated, changes to longer paths are dropped
+        constexpr uint32_t MaxNotificationPathLength = MAX_PATH;
+
+        // Plain data, so that the watcher thread never allocates. It runs without a thread heap,
+        // and the notifications are released by the consumer thread.
+        struct FileSystemNotification
+        {
+            FileSystemChange    m_change { FileSystemChange::Modified };
+            wchar_t             m_path[MaxNotificationPathLength] {};
+        };
+
+        // Called from the watcher thread when new notifications are ready to be popped
         typedef void (*FileSystemWatcherCallback)();
 
+        // Watches directories for changes on a dedicated thread.
+        //
+        // The watcher thread hands the changes over through a lock-free single-producer
+        // single-consumer ring, so `PopNotification` must always be called from the same
+        // thread. Changes are dropped while the ring is full.
+        //
         class FileSystemWatcher
         {
         public:
 
+            static constexpr uint32_t NotificationCapacity = 256;
+
             FileSystemWatcher() = default;
             ~FileSystemWatcher();
             FileSystemWatcher(const FileSystemWatcher&) = delete;
@@ -25,23 +55,31 @@ namespace biome
             void StopWatchingDirectory(const wchar_t* directoryPath);
             void StopAllWatching();
 
-        private:
+            // Single consumer thread only
+            bool PopNotification(FileSystemNotification& notification);
 
-            void ProcessNotifications();
-            static DWORD WINAPI ThreadProc(void* pContext);
+        private:
 
             typedef uint8_t NotificationBuffer[1024];
 
             struct WatchedDirectoryData
             {
+                HANDLE m_directory { INVALID_HANDLE_VALUE };
                 OVERLAPPED m_overlapped { 0 };
                 NotificationBuffer m_notificationBuffer {};
             };
 
+            void ProcessNotifications();
+            bool ProcessDirectoryChanges(const std::wstring& directoryPath, WatchedDirectoryData& data);
+            static bool IssueDirectoryRead(WatchedDirectoryData& data);
+            static DWORD WINAPI ThreadProc(void* pContext);
+
             FileSystemWatcherCallback m_callback { nullptr };
             HANDLE m_thread { 0 };
+            // Wakes the watcher thread when the watched directories change or it must stop
+            HANDLE m_wakeEvent { 0 };
             std::mutex m_mutex {};
-            std::condition_variable m_conditionVar {};
+            biome::threading::SpscRing<FileSystemNotification> m_notifications {};
 
 
             std::map<std::wstring, WatchedDirectoryData> m_watchedDirectories {};
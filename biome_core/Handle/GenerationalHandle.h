@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace biome
+{
+    // 32 bits handle to an object owned by a `HandleTable`.
+    //
+    // The low bits index the object's slot, the high bits hold the generation of the slot when
+    // the object was created. Destroying the object bumps the slot generation, so handles
+    // still pointing to it no longer match and are detected as stale, in all builds.
+    // The generation wraps after `GenerationMask + 1` reuses of a slot.
+    //
+    // `T` only types the handle, so that handles to different object types don't mix.
+    // A default constructed handle is null.
+    //
+    template<typename T>
+    class GenerationalHandle
+    {
+    public:
+
+        static constexpr uint32_t IndexBitCount = 20;
+        static constexpr uint32_t IndexMask = (1u << IndexBitCount) - 1;
+        static constexpr uint32_t GenerationMask = UINT32_MAX >> IndexBitCount;
+        // The last index is left out so that no valid handle equals the null one
+        static constexpr uint32_t MaxIndexCount = IndexMask;
+
+        constexpr GenerationalHandle() = default;
+        constexpr GenerationalHandle(uint32_t index, uint32_t generation)
+            : m_Value(((generation & GenerationMask) << IndexBitCount) | (index & IndexMask))
+        {
+        }
+
+        static constexpr GenerationalHandle FromValue(uint32_t value)
+        {
+            GenerationalHandle handle;
+            handle.m_Value = value;
+            return handle;
+        }
+
+        constexpr uint32_t GetIndex() const { return m_Value & IndexMask; }
+        constexpr uint32_t GetGeneration() const { return m_Value >> IndexBitCount; }
+        constexpr uint32_t GetValue() const { return m_Value; }
+        constexpr bool IsNull() const { return m_Value == NullValue; }
+
+        constexpr bool operator==(const GenerationalHandle&) const = default;
+
+    private:
+
+        static constexpr uint32_t NullValue = UINT32_MAX;
+
+        uint32_t m_Value { NullValue };
+    };
+}
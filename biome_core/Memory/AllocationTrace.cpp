@@ -0,0 +1,210 @@
+#include <pch.h>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <stdio.h>
+#include <thread>
+#include "biome_core/Memory/AllocationTrace.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+#include "biome_core/DataStructures/Vector.h"
+
+using namespace biome::memory;
+using namespace biome::data;
+
+namespace
+{
+    struct TraceEvent
+    {
+        uint64_t            m_Timestamp;
+        uintptr_t           m_Address;
+        size_t              m_ByteSize;
+        const char*         m_pTag;
+        uint32_t            m_ThreadIndex;
+        AllocatorType       m_Allocator;
+        AllocationEventType m_Type;
+    };
+
+    constexpr uint32_t InvalidThreadIndex = UINT32_MAX;
+    constexpr uint32_t NoTagIndex = UINT32_MAX;
+
+    std::atomic<bool>       s_IsRunning { false };
+    std::atomic<uint64_t>   s_NextEventIndex { 0 };
+    std::atomic<uint32_t>   s_NextThreadIndex { 0 };
+    // Threads that may be writing to the buffer, see `Stop`
+    std::atomic<uint32_t>   s_PendingWriterCount { 0 };
+    TraceEvent*             s_pEvents { nullptr };
+    size_t                  s_EventCapacity { 0 };
+
+    thread_local const char*    s_pThreadTag { nullptr };
+    thread_local uint32_t       s_ThreadIndex { InvalidThreadIndex };
+
+    uint32_t FindOrAddTag(Vector<const char*> &tags, const char *pTag)
+    {
+        if (pTag == nullptr)
+        {
+            return NoTagIndex;
+        }
+
+        for (uint32_t i = 0; i < tags.Size(); ++i)
+        {
+            if (tags[i] == pTag)
+            {
+                return i;
+            }
+        }
+
+        return tags.Add(pTag);
+    }
+
+    FILE* OpenForWrite(const char *pFilePath)
+    {
+    #if PLATFORM_WINDOWS
+        FILE *pFile = nullptr;
+        return fopen_s(&pFile, pFilePath, "wb") == 0 ? pFile : nullptr;
+    #else
+        return fopen(pFilePath, "wb");
+    #endif
+    }
+}
+
+void AllocationTrace::Start(size_t eventCapacity)
+{
+    BIOME_ASSERT_MSG(!IsRunning(), "AllocationTrace::Start: Already running");
+
+    // Power of two capacity so that the write index wraps with a mask
+    const size_t capacity = std::bit_ceil(std::max<size_t>(eventCapacity, 1));
+
+    if (capacity != s_EventCapacity)
+    {
+        if (s_pEvents)
+        {
+            VirtualMemoryAllocator::Release(s_pEvents);
+        }
+
+        const size_t byteSize = capacity * sizeof(TraceEvent);
+        s_pEvents = static_cast<TraceEvent*>(VirtualMemoryAllocator::Allocate(byteSize, byteSize));
+        s_EventCapacity = capacity;
+    }
+
+    s_NextEventIndex.store(0, std::memory_order_relaxed);
+    s_IsRunning.store(true, std::memory_order_release);
+}
+
+void AllocationTrace::Stop()
+{
+    s_IsRunning.store(false, std::memory_order_relaxed);
+
+    // Pairs with the fence in `Record`: either the writer sees tracing stopped,
+    // or its pending count is seen here and its event is complete once it drops
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (s_PendingWriterCount.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+bool AllocationTrace::IsRunning()
+{
+    return s_IsRunning.load(std::memory_order_acquire);
+}
+
+bool AllocationTrace::DumpToFile(const char *pFilePath)
+{
+    BIOME_ASSERT_MSG(!IsRunning(), "AllocationTrace::DumpToFile: Tracing must be stopped first");
+
+    const uint64_t recordedCount = s_NextEventIndex.load(std::memory_order_acquire);
+    const uint64_t eventCount = std::min<uint64_t>(recordedCount, s_EventCapacity);
+    const uint64_t firstEventIndex = recordedCount - eventCount;
+
+    Vector<const char*> tags;
+    for (uint64_t i = firstEventIndex; i < recordedCount; ++i)
+    {
+        FindOrAddTag(tags, s_pEvents[i & (s_EventCapacity - 1)].m_pTag);
+    }
+
+    FILE *pFile = OpenForWrite(pFilePath);
+    if (pFile == nullptr)
+    {
+        return false;
+    }
+
+    FileHeader header {};
+    header.m_Magic = FileMagic;
+    header.m_Version = FileVersion;
+    header.m_EventCount = eventCount;
+    header.m_TagCount = tags.Size();
+
+    bool succeeded = fwrite(&header, sizeof(header), 1, pFile) == 1;
+
+    for (uint32_t i = 0; succeeded && i < tags.Size(); ++i)
+    {
+        const uint32_t byteCount = static_cast<uint32_t>(strlen(tags[i]));
+        succeeded = fwrite(&byteCount, sizeof(byteCount), 1, pFile) == 1 && fwrite(tags[i], 1, byteCount, pFile) == byteCount;
+    }
+
+    for (uint64_t i = firstEventIndex; succeeded && i < recordedCount; ++i)
+    {
+        const TraceEvent &event = s_pEvents[i & (s_EventCapacity - 1)];
+
+        FileEvent fileEvent {};
+        fileEvent.m_Timestamp = event.m_Timestamp;
+        fileEvent.m_Address = event.m_Address;
+        fileEvent.m_ByteSize = event.m_ByteSize;
+        fileEvent.m_TagIndex = FindOrAddTag(tags, event.m_pTag);
+        fileEvent.m_ThreadIndex = event.m_ThreadIndex;
+        fileEvent.m_Allocator = event.m_Allocator;
+        fileEvent.m_Type = event.m_Type;
+
+        succeeded = fwrite(&fileEvent, sizeof(fileEvent), 1, pFile) == 1;
+    }
+
+    fclose(pFile);
+
+    return succeeded;
+}
+
+void AllocationTrace::Record(AllocatorType allocator, AllocationEventType type, uintptr_t address, size_t byteSize)
+{
+    if (!s_IsRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    s_PendingWriterCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Stopped meanwhile, the buffer may be reallocated by the next `Start`.
+    // Acquire pairs with `Start` publishing the buffer.
+    if (!s_IsRunning.load(std::memory_order_acquire))
+    {
+        s_PendingWriterCount.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    if (s_ThreadIndex == InvalidThreadIndex)
+    {
+        s_ThreadIndex = s_NextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t eventIndex = s_NextEventIndex.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &event = s_pEvents[eventIndex & (s_EventCapacity - 1)];
+
+    event.m_Timestamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    event.m_Address = address;
+    event.m_ByteSize = byteSize;
+    event.m_pTag = s_pThreadTag;
+    event.m_ThreadIndex = s_ThreadIndex;
+    event.m_Allocator = allocator;
+    event.m_Type = type;
+
+    s_PendingWriterCount.fetch_sub(1, std::memory_order_release);
+}
+
+const char* AllocationTrace::SetThreadTag(const char *pTag)
+{
+    const char *pPreviousTag = s_pThreadTag;
+    s_pThreadTag = pTag;
+    return pPreviousTag;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include "biome_core/Core/Defines.h"
+
+// Compiles allocation tracing in. Tracing then still has to be started at runtime.
+#ifndef BIOME_ALLOCATION_TRACE
+    #define BIOME_ALLOCATION_TRACE 0
+#endif
+
+namespace biome
+{
+    namespace memory
+    {
+        enum class AllocatorType : uint8_t
+        {
+            ThreadHeap,
+            VirtualMemory,
+            FrameMemory,
+            ConcurrentFrameMemory,
+            RingBuffer,
+            MemoryOffset,
+            Count
+        };
+
+        enum class AllocationEventType : uint8_t
+        {
+            Allocate,
+            // Byte size is 0 when the allocator does not know it without a lookup
+            Release,
+            // Linear allocators release everything at once, the event covers the released range
+            Reset
+        };
+
+        // Ring buffer of allocation events shared by every allocator and thread.
+        //
+        // Recording an event is a relaxed load when tracing is stopped, and a fetch-add plus a
+        // 40 bytes write when it runs. Once the buffer is full, the oldest events are overwritten;
+        // size it so that writers cannot lap each other, a lapped slot may hold a torn event.
+        // Events are tagged with the innermost `BIOME_ALLOCATION_TAG` scope of the recording thread.
+        // `Stop` waits for the events being recorded, so that `DumpToFile` and a following `Start`,
+        // which may reallocate the buffer, never race with a writer.
+        //
+        // File layout, little endian:
+        //   FileHeader, then `m_TagCount` times { uint32_t byteCount, char tag[byteCount] },
+        //   then `m_EventCount` times FileEvent, oldest first.
+        //
+        class AllocationTrace
+        {
+        public:
+
+            static constexpr uint32_t FileMagic = 0x54414D42; // "BMAT"
+            static constexpr uint32_t FileVersion = 1;
+
+            struct FileHeader
+            {
+                uint32_t    m_Magic;
+                uint32_t    m_Version;
+                uint64_t    m_EventCount;
+                uint32_t    m_TagCount;
+                uint32_t    m_Padding;
+            };
+
+            struct FileEvent
+            {
+                uint64_t            m_Timestamp;
+                uint64_t            m_Address;
+                uint64_t            m_ByteSize;
+                uint32_t            m_TagIndex;
+                uint32_t            m_ThreadIndex;
+                AllocatorType       m_Allocator;
+                AllocationEventType m_Type;
+                uint8_t             m_Padding[6];
+            };
+
+            static void Start(size_t eventCapacity);
+            static void Stop();
+            static bool IsRunning();
+            static bool DumpToFile(const char *pFilePath);
+
+            static void Record(AllocatorType allocator, AllocationEventType type, uintptr_t address, size_t byteSize);
+
+            // Returns the previous tag so that scopes can restore it
+            static const char* SetThreadTag(const char *pTag);
+        };
+
+        class AllocationTagScope
+        {
+        public:
+
+            AllocationTagScope(const char *pTag) : m_pPreviousTag(AllocationTrace::SetThreadTag(pTag)) {}
+            ~AllocationTagScope() { AllocationTrace::SetThreadTag(m_pPreviousTag); }
+
+            AllocationTagScope(const AllocationTagScope&) = delete;
+            AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+
+        private:
+
+            const char* m_pPreviousTag;
+        };
+    }
+}
+
+#if BIOME_ALLOCATION_TRACE
+    // `tag` must be a string literal, or outlive the trace dump
+    #define BIOME_ALLOCATION_TAG(tag) biome::memory::AllocationTagScope CONCAT(allocationTagScope, __LINE__)(tag)
+    #define BIOME_TRACE_ALLOCATION(allocator, eventType, address, byteSize)                                                  \
+        biome::memory::AllocationTrace::Record(                                                                             \
+            biome::memory::AllocatorType::allocator,                                                                        \
+            biome::memory::AllocationEventType::eventType,                                                                  \
+            (uintptr_t)(address),                                                                                           \
+            (byteSize))
+#else
+    #define BIOME_ALLOCATION_TAG(tag)
+    #define BIOME_TRACE_ALLOCATION(allocator, eventType, address, byteSize)
+#endif
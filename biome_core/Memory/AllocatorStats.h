@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace biome
+{
+    namespace memory
+    {
+        // Counters reported by every biome allocator through `GetStats`.
+        //
+        // Byte counts are in the unit the allocator manages: memory for the heaps and linear
+        // allocators, offsets for `MemoryOffsetAllocator`. Counters an allocator cannot track
+        // are left to 0.
+        //
+        struct AllocatorStats
+        {
+            size_t      m_ReservedByteCount { 0 };
+            size_t      m_CommittedByteCount { 0 };
+            size_t      m_UsedByteCount { 0 };
+            size_t      m_PeakUsedByteCount { 0 };
+            size_t      m_LargestFreeBlockByteCount { 0 };
+            size_t      m_FreeRangeCount { 0 };
+            uint64_t    m_AllocationCount { 0 };
+            uint64_t    m_ReleaseCount { 0 };
+        };
+    }
+}
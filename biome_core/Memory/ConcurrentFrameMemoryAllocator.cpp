@@ -0,0 +1,153 @@
+#include <pch.h>
+#include "ConcurrentFrameMemoryAllocator.h"
+#include "AllocationTrace.h"
+
+using namespace biome::memory;
+
+namespace
+{
+    struct ThreadChunk
+    {
+        uint64_t    m_Epoch { 0 };
+        uintptr_t   m_NextAddr { 0 };
+        uintptr_t   m_EndAddr { 0 };
+    };
+
+    constexpr uint32_t ThreadChunkCacheSize = 4;
+
+    // Chunks of the allocators most recently used by this thread. Epochs are unique across all
+    // allocators and frames, so a chunk from a previous frame or a destroyed allocator never matches.
+    thread_local ThreadChunk s_ThreadChunks[ThreadChunkCacheSize] {};
+    thread_local uint32_t s_NextEvictedChunk { 0 };
+
+    std::atomic<uint64_t> s_NextEpoch { 1 };
+}
+
+ConcurrentFrameMemoryAllocator::ConcurrentFrameMemoryAllocator(size_t poolByteSize, size_t chunkByteSize)
+{
+    Init(poolByteSize, chunkByteSize);
+}
+
+ConcurrentFrameMemoryAllocator::~ConcurrentFrameMemoryAllocator()
+{
+    if (m_MemoryPool)
+    {
+        FreeAlignedAlloc(m_MemoryPool);
+    }
+}
+
+void ConcurrentFrameMemoryAllocator::Init(size_t poolByteSize, size_t chunkByteSize)
+{
+    BIOME_ASSERT_MSG(m_MemoryPool == nullptr, "ConcurrentFrameMemoryAllocator::Init: Already initialized");
+    BIOME_ASSERT_MSG(chunkByteSize <= poolByteSize, "ConcurrentFrameMemoryAllocator::Init: Chunks larger than the pool");
+
+    m_PoolByteSize = Align(poolByteSize, MaxAlignment);
+    m_ChunkByteSize = Align(chunkByteSize, MaxAlignment);
+    m_MemoryPool = static_cast<uint8_t*>(AlignedAlloc(m_PoolByteSize, MaxAlignment));
+    m_HighWaterMark = 0;
+    m_NextByte.store(0, std::memory_order_relaxed);
+    m_Epoch = s_NextEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* ConcurrentFrameMemoryAllocator::Allocate(size_t byteSize, size_t alignment)
+{
+    BIOME_ASSERT_MSG(alignment <= MaxAlignment, "ConcurrentFrameMemoryAllocator::Allocate: Maximum supported alignment exceeded.");
+
+    ThreadChunk *pChunk = nullptr;
+    for (ThreadChunk &chunk : s_ThreadChunks)
+    {
+        if (chunk.m_Epoch == m_Epoch)
+        {
+            pChunk = &chunk;
+            break;
+        }
+    }
+
+    if (pChunk)
+    {
+        uintptr_t allocAddr = Align(pChunk->m_NextAddr, alignment);
+        if (allocAddr + byteSize <= pChunk->m_EndAddr)
+        {
+            pChunk->m_NextAddr = allocAddr + byteSize;
+            BIOME_TRACE_ALLOCATION(ConcurrentFrameMemory, Allocate, allocAddr, byteSize);
+            return reinterpret_cast<void*>(allocAddr);
+        }
+    }
+
+    // Large allocations would waste most of a chunk, carve them from the pool directly.
+    // Pool allocations are always aligned on `MaxAlignment`.
+    if (byteSize > m_ChunkByteSize / 2)
+    {
+        uint8_t *pAllocation = AllocateFromPool(Align(byteSize, MaxAlignment));
+        BIOME_TRACE_ALLOCATION(ConcurrentFrameMemory, Allocate, pAllocation, byteSize);
+        return pAllocation;
+    }
+
+    uint8_t *pChunkStart = AllocateFromPool(m_ChunkByteSize);
+    if (pChunkStart == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (pChunk == nullptr)
+    {
+        pChunk = &s_ThreadChunks[s_NextEvictedChunk];
+        s_NextEvictedChunk = (s_NextEvictedChunk + 1) % ThreadChunkCacheSize;
+    }
+
+    pChunk->m_Epoch = m_Epoch;
+    pChunk->m_NextAddr = reinterpret_cast<uintptr_t>(pChunkStart) + byteSize;
+    pChunk->m_EndAddr = reinterpret_cast<uintptr_t>(pChunkStart) + m_ChunkByteSize;
+
+    BIOME_TRACE_ALLOCATION(ConcurrentFrameMemory, Allocate, pChunkStart, byteSize);
+
+    return pChunkStart;
+}
+
+void ConcurrentFrameMemoryAllocator::EndFrame()
+{
+    // Requests that overflowed the pool are accounted for, so the mark tells how large the pool should be
+    m_HighWaterMark = std::max(m_HighWaterMark, m_NextByte.load(std::memory_order_relaxed));
+    BIOME_TRACE_ALLOCATION(ConcurrentFrameMemory, Reset, m_MemoryPool, GetAllocatedByteCount());
+    m_NextByte.store(0, std::memory_order_relaxed);
+    m_ReleaseCount = m_PoolAllocationCount.load(std::memory_order_relaxed);
+    m_Epoch = s_NextEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t ConcurrentFrameMemoryAllocator::GetAllocatedByteCount() const
+{
+    return std::min(m_NextByte.load(std::memory_order_relaxed), m_PoolByteSize);
+}
+
+AllocatorStats ConcurrentFrameMemoryAllocator::GetStats() const
+{
+    const size_t allocatedByteCount = GetAllocatedByteCount();
+    const size_t freeByteCount = m_PoolByteSize - allocatedByteCount;
+
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = m_PoolByteSize;
+    stats.m_CommittedByteCount = m_PoolByteSize;
+    stats.m_UsedByteCount = allocatedByteCount;
+    stats.m_PeakUsedByteCount = std::max(m_HighWaterMark, m_NextByte.load(std::memory_order_relaxed));
+    stats.m_LargestFreeBlockByteCount = freeByteCount;
+    stats.m_FreeRangeCount = freeByteCount > 0 ? 1 : 0;
+    stats.m_AllocationCount = m_PoolAllocationCount.load(std::memory_order_relaxed);
+    stats.m_ReleaseCount = m_ReleaseCount;
+
+    return stats;
+}
+
+uint8_t* ConcurrentFrameMemoryAllocator::AllocateFromPool(size_t byteSize)
+{
+    const size_t offset = m_NextByte.fetch_add(byteSize, std::memory_order_relaxed);
+    m_PoolAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    BIOME_ASSERT_MSG(offset + byteSize <= m_PoolByteSize, "ConcurrentFrameMemoryAllocator: Over allocation for this frame");
+
+    if (offset + byteSize > m_PoolByteSize)
+    {
+        return nullptr;
+    }
+
+    return m_MemoryPool + offset;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/AllocatorStats.h"
+
+namespace biome
+{
+    namespace memory
+    {
+        // Frame scoped linear allocator usable from any number of threads at once.
+        //
+        // Every thread bumps a private chunk carved from the shared pool with an atomic fetch-add,
+        // so allocations only touch shared state when a chunk runs out. Allocations too large for
+        // a chunk are carved from the pool directly.
+        // `EndFrame` resets the pool in O(1): it moves the allocator to a new epoch, which
+        // invalidates every thread chunk without touching them. It must not run concurrently with
+        // `Allocate`.
+        //
+        class ConcurrentFrameMemoryAllocator
+        {
+        public:
+
+            static constexpr size_t DefaultChunkByteSize = KiB(64);
+            static constexpr size_t MaxAlignment = 64;
+
+            ConcurrentFrameMemoryAllocator() {};
+            ConcurrentFrameMemoryAllocator(size_t poolByteSize, size_t chunkByteSize = DefaultChunkByteSize);
+            ~ConcurrentFrameMemoryAllocator();
+
+            ConcurrentFrameMemoryAllocator(const ConcurrentFrameMemoryAllocator&) = delete;
+            ConcurrentFrameMemoryAllocator& operator=(const ConcurrentFrameMemoryAllocator&) = delete;
+
+            void    Init(size_t poolByteSize, size_t chunkByteSize = DefaultChunkByteSize);
+
+            void*   Allocate(size_t byteSize, size_t alignment = sizeof(uintptr_t));
+            void    EndFrame();
+
+            // Pool bytes handed out to chunks and large allocations during the current frame
+            size_t  GetAllocatedByteCount() const;
+            // Largest number of pool bytes used by a single frame since `Init`
+            size_t  GetHighWaterMark() const { return m_HighWaterMark; }
+            size_t  GetPoolByteSize() const { return m_PoolByteSize; }
+            // Allocations are counted at the pool level, each chunk refill or large allocation
+            // counting as one, so that bumping a thread chunk stays free of shared writes
+            AllocatorStats GetStats() const;
+
+        private:
+
+            uint8_t* AllocateFromPool(size_t byteSize);
+
+            uint8_t*            m_MemoryPool { nullptr };
+            size_t              m_PoolByteSize { 0 };
+            size_t              m_ChunkByteSize { 0 };
+            size_t              m_HighWaterMark { 0 };
+            uint64_t            m_Epoch { 0 };
+            uint64_t            m_ReleaseCount { 0 };
+            std::atomic<size_t> m_NextByte { 0 };
+            std::atomic<uint64_t> m_PoolAllocationCount { 0 };
+        };
+    }
+}
@@ -1,5 +1,6 @@
 #include <pch.h>
 #include "FrameMemoryAllocator.h"
+#include "AllocationTrace.h"
 
 using namespace biome::memory;
 
@@ -32,15 +33,39 @@ void* FrameMemoryAllocator::Allocate(size_t byteSize, size_t alignment)
 
     BIOME_ASSERT_MSG(m_NextByte <= m_PoolByteSize, "Over allocation for this frame");
 
+    m_PeakByteCount = std::max(m_PeakByteCount, m_NextByte);
+    ++m_AllocationCount;
+    BIOME_TRACE_ALLOCATION(FrameMemory, Allocate, m_MemoryPool + alignedOffset, allocByteSize);
+
     return m_MemoryPool + alignedOffset;
 }
 
 void FrameMemoryAllocator::Reset(MemoryBookmark bookmark)
 {
+    BIOME_TRACE_ALLOCATION(FrameMemory, Reset, m_MemoryPool + bookmark, m_NextByte - bookmark);
     m_NextByte = bookmark;
 }
 
 void FrameMemoryAllocator::Reset()
 {
+    BIOME_TRACE_ALLOCATION(FrameMemory, Reset, m_MemoryPool, m_NextByte);
     m_NextByte = 0;
+    m_ReleaseCount = m_AllocationCount;
+}
+
+AllocatorStats FrameMemoryAllocator::GetStats() const
+{
+    const size_t freeByteCount = m_PoolByteSize - m_NextByte;
+
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = m_PoolByteSize;
+    stats.m_CommittedByteCount = m_PoolByteSize;
+    stats.m_UsedByteCount = m_NextByte;
+    stats.m_PeakUsedByteCount = m_PeakByteCount;
+    stats.m_LargestFreeBlockByteCount = freeByteCount;
+    stats.m_FreeRangeCount = freeByteCount > 0 ? 1 : 0;
+    stats.m_AllocationCount = m_AllocationCount;
+    stats.m_ReleaseCount = m_ReleaseCount;
+
+    return stats;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "biome_core/Memory/AllocatorStats.h"
 
 namespace biome
 {
@@ -24,6 +25,8 @@ namespace biome
             void            Reset();
             size_t          GetAllocatedByteCount() const { return m_NextByte; }
             void*           GetFrameStartAddress() { return m_MemoryPool; }
+            // Allocations are only counted as released by the full `Reset`
+            AllocatorStats  GetStats() const;
 
         private:
 
@@ -32,6 +35,9 @@ namespace biome
             uint8_t* m_MemoryPool { nullptr };
             size_t m_PoolByteSize { 0 };
             size_t m_NextByte { 0 };
+            size_t m_PeakByteCount { 0 };
+            uint64_t m_AllocationCount { 0 };
+            uint64_t m_ReleaseCount { 0 };
         };
     }
 }
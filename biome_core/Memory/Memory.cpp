@@ -5,16 +5,14 @@
 
 using namespace biome::memory;
 
-void* biome::memory::AlignedAlloc(size_t size, size_t /*alignment*/)
+void* biome::memory::AlignedAlloc(size_t size, size_t alignment)
 {
-    // Aligned on page size by default
-    return ThreadHeapAllocator::Allocate(size);
+    return ThreadHeapAllocator::Allocate(size, alignment);
 }
 
-void* biome::memory::AlignedRealloc(void *pMemory, size_t newSize, size_t /*alignment*/)
+void* biome::memory::AlignedRealloc(void *pMemory, size_t newSize, size_t alignment)
 {
-    // Aligned on page size by default
-    void *pNewAddr = ThreadHeapAllocator::Allocate(newSize);
+    void *pNewAddr = ThreadHeapAllocator::Allocate(newSize, alignment);
 
     size_t originalSize = ThreadHeapAllocator::AllocationSize(pMemory);
     size_t copySize = std::min(originalSize, newSize);
@@ -54,15 +52,13 @@ void operator delete[](void *ptr)
 
 void* operator new(std::size_t count, std::align_val_t al)
 {
-    // The allocator already aligns on system page size
-    return ThreadHeapAllocator::Allocate(count);
+    return ThreadHeapAllocator::Allocate(count, static_cast<size_t>(al));
 }
 
 
 void* operator new[](std::size_t count, std::align_val_t al)
 {
-    // The allocator already aligns on system page size
-    return ThreadHeapAllocator::Allocate(count);
+    return ThreadHeapAllocator::Allocate(count, static_cast<size_t>(al));
 }
 
 void operator delete(void *ptr, std::align_val_t al)
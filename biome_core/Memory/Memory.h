@@ -2,6 +2,9 @@
 
 #include <malloc.h>
 #include <new>
+#ifndef _MSC_VER
+    #include <alloca.h>
+#endif
 #include "biome_core/Core/Utilities.h"
 
 // Global allocation operator overrides
@@ -28,7 +31,11 @@ namespace biome
 
         inline void* StackAlloc(size_t size)
         {
+        #ifdef _MSC_VER
             return _malloca(size);
+        #else
+            return alloca(size);
+        #endif
         }
 
         template<typename T> concept UnsignedType = std::is_unsigned_v<T>;
@@ -1,28 +1,30 @@
 #include <pch.h>
 #include "MemoryOffsetAllocator.h"
 #include "VirtualMemoryAllocator.h"
+#include "AllocationTrace.h"
 
 using namespace biome::memory;
 
 void MemoryOffsetAllocator::Initialize(size_t byteSize, size_t pageSize)
 {
-    const size_t pageCount = Align(byteSize, pageSize) / pageSize;
-    const size_t metadataOverhead = sizeof(Range) * pageCount * 2;
+    BIOME_ASSERT_MSG(m_pPages == nullptr, "MemoryOffsetAllocator::Initialize: Already initialized");
 
-    m_pFreeRanges = static_cast<Range*>(VirtualMemoryAllocator::Allocate(metadataOverhead, metadataOverhead));
-    m_pUsedRanges = m_pFreeRanges + pageCount;
+    const size_t pageCount = Align(byteSize, pageSize) / pageSize;
+    BIOME_ASSERT_MSG(pageCount > 0 && pageCount < AllocatedRunFlag, "MemoryOffsetAllocator::Initialize: Unsupported page count");
 
-    m_pFreeRanges->m_Offset = 0;
-    m_pFreeRanges->m_Count = pageCount;
-    m_FreeRangeCount = 1;
+    const size_t metadataOverhead = sizeof(PageRun) * pageCount;
+    m_pPages = static_cast<PageRun*>(VirtualMemoryAllocator::Allocate(metadataOverhead, metadataOverhead));
 
     m_SystemPageSize = pageSize;
-    m_TotalPageCount = pageCount;
+    m_TotalPageCount = static_cast<uint32_t>(pageCount);
+
+    m_FreeRuns.Initialize(m_pPages);
+    InsertFreeRun(0, m_TotalPageCount);
 }
 
 bool MemoryOffsetAllocator::IsInitialized()
 {
-    return m_pFreeRanges != nullptr;
+    return m_pPages != nullptr;
 }
 
 MemoryOffsetAllocator::~MemoryOffsetAllocator()
@@ -32,44 +34,42 @@ MemoryOffsetAllocator::~MemoryOffsetAllocator()
 
 void MemoryOffsetAllocator::Shutdown()
 {
-    if (m_pFreeRanges != nullptr)
+    if (m_pPages != nullptr)
     {
-        VirtualMemoryAllocator::Release(m_pFreeRanges);
+        VirtualMemoryAllocator::Release(m_pPages);
+        m_pPages = nullptr;
     }
 }
 
 size_t MemoryOffsetAllocator::Allocate(size_t byteSize)
 {
-    BIOME_ASSERT_MSG(m_FreeRangeCount > 0, "Memory exhausted");
+    const size_t requiredPageCount = std::max<size_t>(Align(byteSize, m_SystemPageSize) / m_SystemPageSize, 1);
 
-    const size_t requiredPageCount = Align(byteSize, m_SystemPageSize) / m_SystemPageSize;
+    const uint32_t pageIndex = requiredPageCount <= m_TotalPageCount ?
+        SearchFreePages(static_cast<uint32_t>(requiredPageCount)) :
+        InvalidPageIndex;
 
-    for (int64_t i = m_FreeRangeCount - 1; i >= 0; --i)
+    if (pageIndex == InvalidPageIndex)
     {
-        Range& range = m_pFreeRanges[i];
-        if (range.m_Count >= requiredPageCount)
-        {
-            Range usedRange { range.m_Offset, requiredPageCount};
-            AddUsedRange(usedRange);
-
-            range.m_Offset += requiredPageCount;
-            range.m_Count -= requiredPageCount;
-            
-            if (range.m_Count == 0 && m_FreeRangeCount > 1)
-            {
-                Range& lastRange = m_pFreeRanges[m_FreeRangeCount - 1];
-                range.m_Offset = lastRange.m_Offset;
-                range.m_Count = lastRange.m_Count;
-                lastRange.m_Offset = InvalidOffset;
-                --m_FreeRangeCount;
-            }
-
-            return usedRange.m_Offset * m_SystemPageSize;
-        }
+        BIOME_FAIL_MSG("Memory exhausted");
+        return InvalidOffset;
+    }
+
+    const uint32_t pageCount = static_cast<uint32_t>(requiredPageCount);
+    const uint32_t freePageCount = RunPageCount(pageIndex);
+    if (freePageCount > pageCount)
+    {
+        InsertFreeRun(pageIndex + pageCount, freePageCount - pageCount);
     }
 
-    BIOME_FAIL_MSG("Memory exhausted");
-    return InvalidOffset;
+    SetRunTags(pageIndex, pageCount, AllocatedRunFlag);
+
+    m_UsedPageCount += pageCount;
+    m_PeakUsedPageCount = std::max(m_PeakUsedPageCount, m_UsedPageCount);
+    ++m_AllocationCount;
+    BIOME_TRACE_ALLOCATION(MemoryOffset, Allocate, pageIndex * m_SystemPageSize, pageCount * m_SystemPageSize);
+
+    return pageIndex * m_SystemPageSize;
 }
 
 size_t MemoryOffsetAllocator::AllocatePages(size_t pageCount)
@@ -79,125 +79,127 @@ size_t MemoryOffsetAllocator::AllocatePages(size_t pageCount)
 
 bool MemoryOffsetAllocator::Release(size_t byteOffset)
 {
-    const size_t pageOffset = byteOffset / m_SystemPageSize;
+    if (byteOffset % m_SystemPageSize != 0 || byteOffset / m_SystemPageSize >= m_TotalPageCount)
+    {
+        return false;
+    }
 
-    for (size_t i = 0; i < m_UsedRangeCount; ++i)
+    uint32_t pageIndex = static_cast<uint32_t>(byteOffset / m_SystemPageSize);
+
+    if ((m_pPages[pageIndex].m_PageCount & RunFlags) != AllocatedRunFlag)
     {
-        Range& range = m_pUsedRanges[i];
-        if (range.m_Offset == pageOffset)
-        {
-            AddFreeRange(range);
+        return false;
+    }
 
-            --m_UsedRangeCount;
-            if (m_UsedRangeCount > 0)
-            {
-                Range& lastRange = m_pUsedRanges[m_UsedRangeCount];
+    uint32_t pageCount = RunPageCount(pageIndex);
 
-                range.m_Offset = lastRange.m_Offset;
-                range.m_Count = lastRange.m_Count;
+    m_UsedPageCount -= pageCount;
+    ++m_ReleaseCount;
+    BIOME_TRACE_ALLOCATION(MemoryOffset, Release, byteOffset, pageCount * m_SystemPageSize);
 
-                lastRange.m_Offset = InvalidOffset;
-            }
+    // The first page may end up inside a merged run, where its tag would still read as allocated
+    m_pPages[pageIndex].m_PageCount = pageCount;
 
-            return true;
-        }
+    // Merge with the previous run, found through the boundary tag of its last page
+    if (pageIndex > 0 && IsRunFree(pageIndex - 1))
+    {
+        const uint32_t previousPageCount = RunPageCount(pageIndex - 1);
+        pageIndex -= previousPageCount;
+        pageCount += previousPageCount;
+        RemoveFreeRun(pageIndex);
     }
 
-    return false;
-}
+    // Merge with the next run
+    const uint32_t nextPageIndex = pageIndex + pageCount;
+    if (nextPageIndex < m_TotalPageCount && IsRunFree(nextPageIndex))
+    {
+        pageCount += RunPageCount(nextPageIndex);
+        RemoveFreeRun(nextPageIndex);
+    }
 
-void MemoryOffsetAllocator::AddFreeRange(const Range& range)
-{
-    BIOME_ASSERT(m_FreeRangeCount < m_TotalPageCount);
-    AddRange(range, m_pFreeRanges, m_FreeRangeCount);
+    InsertFreeRun(pageIndex, pageCount);
+
+    return true;
 }
 
-void MemoryOffsetAllocator::AddUsedRange(const Range& range)
+AllocatorStats MemoryOffsetAllocator::GetStats() const
 {
-    BIOME_ASSERT(m_UsedRangeCount < m_TotalPageCount);
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = m_TotalPageCount * m_SystemPageSize;
+    stats.m_CommittedByteCount = stats.m_ReservedByteCount;
+    stats.m_UsedByteCount = m_UsedPageCount * m_SystemPageSize;
+    stats.m_PeakUsedByteCount = m_PeakUsedPageCount * m_SystemPageSize;
+    stats.m_FreeRangeCount = m_FreeRuns.Count();
+    stats.m_AllocationCount = m_AllocationCount;
+    stats.m_ReleaseCount = m_ReleaseCount;
+
+    // The largest run is in the highest non-empty bucket, which only spans a few sizes
+    for (uint32_t pageIndex = m_FreeRuns.FirstInLargestBucket(); pageIndex != InvalidPageIndex; pageIndex = m_FreeRuns.NextInBucket(pageIndex))
+    {
+        stats.m_LargestFreeBlockByteCount = std::max(stats.m_LargestFreeBlockByteCount, RunPageCount(pageIndex) * m_SystemPageSize);
+    }
 
-    Range& newRange = m_pUsedRanges[m_UsedRangeCount];
-    newRange.m_Offset = range.m_Offset;
-    newRange.m_Count = range.m_Count;
-    ++m_UsedRangeCount;
+    return stats;
 }
 
-void MemoryOffsetAllocator::AddRange(const Range& range, Range* pRanges, size_t& rangeCount)
+uint32_t MemoryOffsetAllocator::SearchFreePages(uint32_t pageCount)
 {
-    bool merged = false;
+    uint32_t pageIndex = m_FreeRuns.FindFit(pageCount);
 
-    for (size_t i = rangeCount - 1; i >= 0; --i)
+    if (pageIndex == InvalidPageIndex)
     {
-        if (Merge(pRanges[i], range, pRanges[i]))
-        {
-            merged = true;
-            break;
-        }
+        pageIndex = SearchFreePagesSlow(pageCount);
     }
 
-    if (!merged)
+    if (pageIndex != InvalidPageIndex)
     {
-        Range& newRange = pRanges[rangeCount];
-        newRange.m_Offset = range.m_Offset;
-        newRange.m_Count = range.m_Count;
-        ++rangeCount;
+        RemoveFreeRun(pageIndex);
     }
 
-    for (size_t i = rangeCount - 1; i > 0; --i)
+    return pageIndex;
+}
+
+uint32_t MemoryOffsetAllocator::SearchFreePagesSlow(uint32_t pageCount) const
+{
+    // Rounding the request up skips the bucket it falls in, which may still hold a run large enough.
+    // The allocator owns the whole range, so look there before reporting it exhausted.
+    for (uint32_t pageIndex = m_FreeRuns.FirstInBucket(pageCount); pageIndex != InvalidPageIndex; pageIndex = m_FreeRuns.NextInBucket(pageIndex))
     {
-        for (size_t j = i - 1; j >= 0; --j)
+        if (RunPageCount(pageIndex) >= pageCount)
         {
-            if (Merge(pRanges[i], pRanges[j], pRanges[j]))
-            {
-                --rangeCount;
-                break;
-            }
+            return pageIndex;
         }
     }
+
+    return InvalidPageIndex;
 }
 
-bool MemoryOffsetAllocator::AreOverlapping(const Range& range0, const Range& range1)
+void MemoryOffsetAllocator::InsertFreeRun(uint32_t pageIndex, uint32_t pageCount)
 {
-    const size_t rangeEnd0 = range0.m_Offset + range0.m_Count;
-    const size_t rangeEnd1 = range1.m_Offset + range1.m_Count;
-
-    return
-        rangeEnd0 > range1.m_Offset ||
-        rangeEnd1 > range0.m_Offset;
+    SetRunTags(pageIndex, pageCount, FreeRunFlag);
+    m_FreeRuns.Insert(pageIndex, pageCount);
 }
 
-bool MemoryOffsetAllocator::CanMerge(const Range& range0, const Range& range1)
+void MemoryOffsetAllocator::RemoveFreeRun(uint32_t pageIndex)
 {
-    BIOME_ASSERT(!AreOverlapping(range0, range1));
-
-    const size_t rangeEnd0 = range0.m_Offset + range0.m_Count;
-    const size_t rangeEnd1 = range1.m_Offset + range1.m_Count;
-
-    return 
-        rangeEnd0 == range1.m_Offset || 
-        rangeEnd1 == range0.m_Offset;
+    const uint32_t pageCount = RunPageCount(pageIndex);
+    m_FreeRuns.Remove(pageIndex, pageCount);
+    SetRunTags(pageIndex, pageCount, 0);
 }
 
-bool MemoryOffsetAllocator::Merge(const Range& range0, const Range& range1, Range& newRange)
+void MemoryOffsetAllocator::SetRunTags(uint32_t pageIndex, uint32_t pageCount, uint32_t flags)
 {
-    if (CanMerge(range0, range1))
-    {
-        const size_t rangeEnd0 = range0.m_Offset + range0.m_Count;
-        const size_t rangeEnd1 = range1.m_Offset + range1.m_Count;
-
-        newRange.m_Count = range0.m_Count + range1.m_Count;
-
-        if (rangeEnd0 == range1.m_Offset)
-        {
-            newRange.m_Offset = range0.m_Offset;
-        }
-        else
-        {
-            newRange.m_Offset = range1.m_Offset;
-        }
+    // The allocated flag only goes on the first page, the last page of a run may be the first of none
+    m_pPages[pageIndex + pageCount - 1].m_PageCount = pageCount | (flags & FreeRunFlag);
+    m_pPages[pageIndex].m_PageCount = pageCount | flags;
+}
 
-        return true;
-    }
+uint32_t MemoryOffsetAllocator::RunPageCount(uint32_t pageIndex) const
+{
+    return m_pPages[pageIndex].m_PageCount & ~RunFlags;
+}
 
-    return false;
+bool MemoryOffsetAllocator::IsRunFree(uint32_t pageIndex) const
+{
+    return (m_pPages[pageIndex].m_PageCount & FreeRunFlag) != 0;
 }
@@ -2,12 +2,22 @@
 
 #include <stdint.h>
 #include "biome_core/Memory/Memory.h"
+#include "biome_core/Memory/AllocatorStats.h"
+#include "biome_core/Memory/TlsfIndex.h"
 #include "biome_core/Core/Defines.h"
 
 namespace biome
 {
     namespace memory
     {
+        // Allocates page aligned offsets in a range of memory the allocator does not own, such as
+        // a descriptor heap.
+        //
+        // Free page runs are indexed in a two-level segregated-fit (TLSF) table, the same way the
+        // `ThreadHeapAllocator` indexes its pages, so `Allocate` is in O(1) until the range is nearly
+        // full, where it may walk one bucket. Boundary tags on the first and last page of each run
+        // let `Release` find and merge the free neighbours in O(1).
+        //
         class MemoryOffsetAllocator
         {
         public:
@@ -27,31 +37,47 @@ namespace biome
             void        Shutdown();
             size_t      Allocate(size_t byteSize);
             size_t      AllocatePages(size_t pageCount);
+            // Returns false when `byteOffset` is not the start of a live allocation
             bool        Release(size_t byteOffset);
             size_t      GetPageSize() const { return m_SystemPageSize; }
+            AllocatorStats GetStats() const;
 
         private:
 
-            struct Range
+            // Matches `TlsfIndex::InvalidIndex`
+            static constexpr uint32_t InvalidPageIndex = UINT32_MAX;
+            static constexpr uint32_t FreeRunFlag = 0x80000000u;
+            // Only set on the first page of allocated runs, so that `Release` can reject other offsets
+            static constexpr uint32_t AllocatedRunFlag = 0x40000000u;
+            static constexpr uint32_t RunFlags = FreeRunFlag | AllocatedRunFlag;
+
+            // Boundary tag stored for every page of the range.
+            // `m_PageCount` is valid on the first and last page of each run and carries `FreeRunFlag`
+            // when the run is free. Free list links are only valid on the first page of a free run.
+            struct PageRun
             {
-                size_t m_Offset;
-                size_t m_Count;
+                uint32_t m_PageCount;
+                uint32_t m_NextFree;
+                uint32_t m_PreviousFree;
             };
 
-            void AddFreeRange(const Range& range);
-            void AddUsedRange(const Range& range);
-
-            static bool AreOverlapping(const Range& range0, const Range& range1);
-            static bool CanMerge(const Range& range0, const Range& range1);
-            static bool Merge(const Range& range0, const Range& range1, Range& newRange);
-            static void AddRange(const Range& range, Range* pRanges, size_t& rangeCount);
+            uint32_t    SearchFreePages(uint32_t pageCount);
+            uint32_t    SearchFreePagesSlow(uint32_t pageCount) const;
+            void        InsertFreeRun(uint32_t pageIndex, uint32_t pageCount);
+            void        RemoveFreeRun(uint32_t pageIndex);
+            void        SetRunTags(uint32_t pageIndex, uint32_t pageCount, uint32_t flags);
+            uint32_t    RunPageCount(uint32_t pageIndex) const;
+            bool        IsRunFree(uint32_t pageIndex) const;
 
-            Range*      m_pFreeRanges { nullptr };
-            Range*      m_pUsedRanges { nullptr };
+            PageRun*    m_pPages { nullptr };
             size_t      m_SystemPageSize { 0 };
-            size_t      m_TotalPageCount { 0 };
-            size_t      m_FreeRangeCount { 0 };
-            size_t      m_UsedRangeCount { 0 };
+            uint32_t    m_TotalPageCount { 0 };
+            uint32_t    m_UsedPageCount { 0 };
+            uint32_t    m_PeakUsedPageCount { 0 };
+            uint64_t    m_AllocationCount { 0 };
+            uint64_t    m_ReleaseCount { 0 };
+
+            TlsfIndex<PageRun> m_FreeRuns {};
         };
     }
 }
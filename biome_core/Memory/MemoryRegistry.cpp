@@ -0,0 +1,217 @@
+#include <pch.h>
+#include <atomic>
+#include <stdio.h>
+#include "MemoryRegistry.h"
+
+using namespace biome::memory;
+
+namespace
+{
+    constexpr uint32_t GranularityLog2 = 16;
+    constexpr uint32_t AddressBitCount = 48;
+    constexpr uint32_t LeafBitCount = 10;
+    constexpr uint32_t InnerBitCount = 10;
+    constexpr uint32_t RootBitCount = AddressBitCount - GranularityLog2 - LeafBitCount - InnerBitCount;
+
+    constexpr uintptr_t OwnerTypeMask = 0x3;
+
+    static_assert((size_t(1) << GranularityLog2) == RegistryGranularity);
+    static_assert(uintptr_t(MemoryOwnerType::Count) <= OwnerTypeMask + 1);
+
+    struct Leaf
+    {
+        std::atomic<uintptr_t> m_Entries[size_t(1) << LeafBitCount];
+    };
+
+    struct Inner
+    {
+        std::atomic<Leaf*> m_Leaves[size_t(1) << InnerBitCount];
+    };
+
+    // Nodes are never freed once published, so lookups never race with a node going away.
+    std::atomic<Inner*> s_Root[size_t(1) << RootBitCount] {};
+
+    template<typename NodeType>
+    NodeType* GetOrCreateNode(std::atomic<NodeType*> &slot)
+    {
+        NodeType *pNode = slot.load(std::memory_order_acquire);
+
+        if (pNode == nullptr)
+        {
+            // Nodes cannot come from the thread heaps since they register themselves here
+            NodeType *pNewNode = static_cast<NodeType*>(calloc(1, sizeof(NodeType)));
+
+            if (slot.compare_exchange_strong(pNode, pNewNode, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                pNode = pNewNode;
+            }
+            else
+            {
+                free(pNewNode);
+            }
+        }
+
+        return pNode;
+    }
+
+    std::atomic<uintptr_t>* FindEntry(uintptr_t key, bool create)
+    {
+        const uintptr_t rootIndex = key >> (InnerBitCount + LeafBitCount);
+        const uintptr_t innerIndex = (key >> LeafBitCount) & ((uintptr_t(1) << InnerBitCount) - 1);
+        const uintptr_t leafIndex = key & ((uintptr_t(1) << LeafBitCount) - 1);
+
+        if (rootIndex >= BIOME_ARRAY_SIZE(s_Root))
+        {
+            return nullptr;
+        }
+
+        Inner *pInner = create ? GetOrCreateNode(s_Root[rootIndex]) : s_Root[rootIndex].load(std::memory_order_acquire);
+        if (pInner == nullptr)
+        {
+            return nullptr;
+        }
+
+        Leaf *pLeaf = create ? GetOrCreateNode(pInner->m_Leaves[innerIndex]) : pInner->m_Leaves[innerIndex].load(std::memory_order_acquire);
+        if (pLeaf == nullptr)
+        {
+            return nullptr;
+        }
+
+        return &pLeaf->m_Entries[leafIndex];
+    }
+
+    void SetEntries(const void *pRangeStart, size_t byteSize, uintptr_t value)
+    {
+        BIOME_ASSERT(byteSize > 0);
+
+        const uintptr_t firstKey = reinterpret_cast<uintptr_t>(pRangeStart) >> GranularityLog2;
+        const uintptr_t lastKey = (reinterpret_cast<uintptr_t>(pRangeStart) + byteSize - 1) >> GranularityLog2;
+        const bool create = value != 0;
+
+        for (uintptr_t key = firstKey; key <= lastKey; ++key)
+        {
+            std::atomic<uintptr_t> *pEntry = FindEntry(key, create);
+            BIOME_ASSERT_MSG(pEntry || !create, "MemoryRegistry: Address outside of the supported address space");
+
+            if (pEntry)
+            {
+                pEntry->store(value, std::memory_order_release);
+            }
+        }
+    }
+
+    MemoryOwner ToOwner(uintptr_t value)
+    {
+        MemoryOwner owner {};
+        owner.m_Type = static_cast<MemoryOwnerType>(value & OwnerTypeMask);
+        owner.m_pOwner = reinterpret_cast<void*>(value & ~OwnerTypeMask);
+
+        return owner;
+    }
+
+    const char* GetOwnerTypeName(MemoryOwnerType type)
+    {
+        switch (type)
+        {
+            case MemoryOwnerType::VirtualMemoryBlock:   return "VirtualMemoryBlock";
+            case MemoryOwnerType::ThreadHeap:           return "ThreadHeap";
+            default:                                    return "Unknown";
+        }
+    }
+
+    void ReportOwnerRange(void *pContext, const void *pRangeStart, size_t byteSize, const MemoryOwner &owner)
+    {
+        uint32_t &rangeCount = *static_cast<uint32_t*>(pContext);
+        ++rangeCount;
+
+        printf("Live memory range %p, %zu bytes, owned by %s %p\n", pRangeStart, byteSize, GetOwnerTypeName(owner.m_Type), owner.m_pOwner);
+    }
+}
+
+void biome::memory::RegisterOwner(const void *pRangeStart, size_t byteSize, MemoryOwnerType type, void *pOwner)
+{
+    BIOME_ASSERT_MSG((reinterpret_cast<uintptr_t>(pOwner) & OwnerTypeMask) == 0, "MemoryRegistry: Owner address is not aligned enough to be tagged");
+    SetEntries(pRangeStart, byteSize, reinterpret_cast<uintptr_t>(pOwner) | static_cast<uintptr_t>(type));
+}
+
+void biome::memory::UnregisterOwner(const void *pRangeStart, size_t byteSize)
+{
+    SetEntries(pRangeStart, byteSize, 0);
+}
+
+MemoryOwner biome::memory::FindOwner(const void *pMemory)
+{
+    MemoryOwner owner {};
+
+    const std::atomic<uintptr_t> *pEntry = FindEntry(reinterpret_cast<uintptr_t>(pMemory) >> GranularityLog2, false);
+    if (pEntry)
+    {
+        owner = ToOwner(pEntry->load(std::memory_order_acquire));
+    }
+
+    return owner;
+}
+
+void biome::memory::ForEachOwner(OwnerRangeFunction pFunction, void *pContext)
+{
+    uintptr_t rangeFirstKey = 0;
+    uintptr_t rangeLastKey = 0;
+    uintptr_t rangeValue = 0;
+
+    const auto flushRange = [&]()
+    {
+        if (rangeValue != 0)
+        {
+            const void *pRangeStart = reinterpret_cast<const void*>(rangeFirstKey << GranularityLog2);
+            pFunction(pContext, pRangeStart, (rangeLastKey - rangeFirstKey + 1) << GranularityLog2, ToOwner(rangeValue));
+        }
+    };
+
+    for (uintptr_t rootIndex = 0; rootIndex < BIOME_ARRAY_SIZE(s_Root); ++rootIndex)
+    {
+        const Inner *pInner = s_Root[rootIndex].load(std::memory_order_acquire);
+        if (pInner == nullptr)
+        {
+            continue;
+        }
+
+        for (uintptr_t innerIndex = 0; innerIndex < BIOME_ARRAY_SIZE(pInner->m_Leaves); ++innerIndex)
+        {
+            const Leaf *pLeaf = pInner->m_Leaves[innerIndex].load(std::memory_order_acquire);
+            if (pLeaf == nullptr)
+            {
+                continue;
+            }
+
+            for (uintptr_t leafIndex = 0; leafIndex < BIOME_ARRAY_SIZE(pLeaf->m_Entries); ++leafIndex)
+            {
+                const uintptr_t value = pLeaf->m_Entries[leafIndex].load(std::memory_order_acquire);
+                if (value == 0)
+                {
+                    continue;
+                }
+
+                const uintptr_t key = (((rootIndex << InnerBitCount) | innerIndex) << LeafBitCount) | leafIndex;
+
+                if (value != rangeValue || key != rangeLastKey + 1)
+                {
+                    flushRange();
+                    rangeFirstKey = key;
+                    rangeValue = value;
+                }
+
+                rangeLastKey = key;
+            }
+        }
+    }
+
+    flushRange();
+}
+
+uint32_t biome::memory::ReportLiveOwners()
+{
+    uint32_t rangeCount = 0;
+    ForEachOwner(&ReportOwnerRange, &rangeCount);
+
+    return rangeCount;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace biome
+{
+    namespace memory
+    {
+        enum class MemoryOwnerType : uintptr_t
+        {
+            None = 0,
+            VirtualMemoryBlock,
+            ThreadHeap,
+            Count
+        };
+
+        struct MemoryOwner
+        {
+            MemoryOwnerType m_Type { MemoryOwnerType::None };
+            void*           m_pOwner { nullptr };
+        };
+
+        // Global address to owner map.
+        //
+        // Reserved address ranges are registered by the allocators that own them and looked up
+        // in O(1) through a three-level radix tree keyed on `RegistryGranularity`. Lookups and
+        // updates are lock-free. Registered ranges must not share a granule with another owner,
+        // which holds for every virtual memory reservation.
+        //
+        constexpr size_t RegistryGranularity = size_t(1) << 16;
+
+        using OwnerRangeFunction = void(*)(void *pContext, const void *pRangeStart, size_t byteSize, const MemoryOwner &owner);
+
+        void        RegisterOwner(const void *pRangeStart, size_t byteSize, MemoryOwnerType type, void *pOwner);
+        void        UnregisterOwner(const void *pRangeStart, size_t byteSize);
+        MemoryOwner FindOwner(const void *pMemory);
+
+        // Calls `pFunction` for every registered range in address order, adjacent granules of the
+        // same owner merged. Ranges registered or unregistered during the walk may be missed.
+        void        ForEachOwner(OwnerRangeFunction pFunction, void *pContext);
+
+        // Prints every range still registered and returns their count. Meant for leak reporting
+        // at shutdown, where only the heap of the calling thread is expected to remain.
+        uint32_t    ReportLiveOwners();
+    }
+}
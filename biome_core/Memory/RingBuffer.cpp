@@ -1,49 +1,150 @@
 #include <pch.h>
+#include <atomic>
+#include <thread>
 #include "RingBuffer.h"
 #include "Memory/ThreadHeapAllocator.h"
+#include "Memory/AllocationTrace.h"
 
 using namespace biome::memory;
 
-static uintptr_t AllocateBuffer(size_t byteSize)
+RingBuffer::RingBuffer(size_t byteSize, uint32_t maxFramesInFlight, CompletedValueFunction pCompletedValueFunction, const void *pContext)
+    : m_ByteSize(Align(byteSize, MaxAlignment))
+    , m_MaxFramesInFlight(maxFramesInFlight)
+    , m_pCompletedValueFunction(pCompletedValueFunction)
+    , m_pCompletedValueContext(pContext)
 {
-    // Aligned to page size by default
-    return reinterpret_cast<uintptr_t>(ThreadHeapAllocator::Allocate(byteSize));
+    BIOME_ASSERT_MSG(maxFramesInFlight > 0, "RingBuffer: At least one frame in flight is required");
+    BIOME_ASSERT_MSG(pCompletedValueFunction != nullptr, "RingBuffer: A completion counter is required to retire frames");
+
+    m_pRing = static_cast<uint8_t*>(ThreadHeapAllocator::Allocate(m_ByteSize, MaxAlignment));
+    m_pFrameMarkers = static_cast<FrameMarker*>(ThreadHeapAllocator::Allocate(sizeof(FrameMarker) * maxFramesInFlight));
+}
+
+RingBuffer::~RingBuffer()
+{
+    ThreadHeapAllocator::Release(m_pFrameMarkers);
+    ThreadHeapAllocator::Release(m_pRing);
 }
 
-RingBuffer::RingBuffer(size_t byteSize)
-    : m_RingStart(AllocateBuffer(byteSize))
-    , m_RingEnd(m_RingStart + byteSize)
-    , m_NextAddr(m_RingStart)
-#ifdef _DEBUG
-    , m_FrameStart(m_RingStart)
-#endif
+void* RingBuffer::Allocate(size_t byteSize, size_t alignment)
 {
+    void *pMemory = TryAllocate(byteSize, alignment);
+
+    while (pMemory == nullptr)
+    {
+        BIOME_ASSERT_MSG(m_FrameMarkerCount > 0, "RingBuffer::Allocate: Current frame does not fit in the buffer");
+
+        if (m_FrameMarkerCount == 0)
+        {
+            return nullptr;
+        }
 
+        std::this_thread::yield();
+        pMemory = TryAllocate(byteSize, alignment);
+    }
+
+    return pMemory;
 }
 
-RingBuffer::~RingBuffer()
+void* RingBuffer::TryAllocate(size_t byteSize, size_t alignment)
 {
-    ThreadHeapAllocator::Release(reinterpret_cast<void*>(m_RingStart));
+    BIOME_ASSERT_MSG(alignment <= MaxAlignment, "RingBuffer::Allocate: Maximum supported alignment exceeded");
+    BIOME_ASSERT_MSG(byteSize <= m_ByteSize, "RingBuffer::Allocate: Requested allocation larger than total buffer size");
+
+    Retire();
+
+    // The buffer size is a multiple of every supported alignment, so aligning the ring offset aligns the address
+    const size_t offset = static_cast<size_t>(m_Head % m_ByteSize);
+    size_t paddingByteSize = Align(offset, alignment) - offset;
+
+    if (offset + paddingByteSize + byteSize > m_ByteSize)
+    {
+        // Skip the end of the buffer, allocations are contiguous
+        paddingByteSize = m_ByteSize - offset;
+    }
+
+    const uint64_t newHead = m_Head + paddingByteSize + byteSize;
+    if (newHead - m_Tail > m_ByteSize)
+    {
+        return nullptr;
+    }
+
+    void *pMemory = m_pRing + (m_Head + paddingByteSize) % m_ByteSize;
+    m_Head = newHead;
+
+    m_PeakUsedByteCount = std::max(m_PeakUsedByteCount, GetUsedByteCount());
+    ++m_AllocationCount;
+    BIOME_TRACE_ALLOCATION(RingBuffer, Allocate, pMemory, byteSize);
+
+    return pMemory;
 }
 
-void* RingBuffer::Allocate(size_t byteSize, size_t alignment)
+void RingBuffer::EndFrame(uint64_t completionValue)
+{
+    while (m_FrameMarkerCount == m_MaxFramesInFlight)
+    {
+        Retire();
+
+        if (m_FrameMarkerCount == m_MaxFramesInFlight)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const uint32_t markerIndex = (m_FirstFrameMarker + m_FrameMarkerCount) % m_MaxFramesInFlight;
+    m_pFrameMarkers[markerIndex] = { completionValue, m_Head, m_AllocationCount };
+    ++m_FrameMarkerCount;
+}
+
+AllocatorStats RingBuffer::GetStats() const
 {
-    BIOME_ASSERT_MSG(Align(byteSize, alignment) <= (m_RingEnd - m_RingStart), 
-        "RingBuffer::Allocate: Requested aligned allocation larger than total buffer size");
+    const size_t freeByteCount = m_ByteSize - GetUsedByteCount();
+    const size_t byteCountToEnd = m_ByteSize - static_cast<size_t>(m_Head % m_ByteSize);
+
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = m_ByteSize;
+    stats.m_CommittedByteCount = m_ByteSize;
+    stats.m_UsedByteCount = GetUsedByteCount();
+    stats.m_PeakUsedByteCount = m_PeakUsedByteCount;
+    stats.m_AllocationCount = m_AllocationCount;
+    stats.m_ReleaseCount = m_ReleaseCount;
 
-    uintptr_t nextAddr = biome::memory::Align(m_NextAddr, alignment);
-    uintptr_t endAddr = nextAddr + byteSize;
-    nextAddr = endAddr >= m_RingEnd ? m_RingStart : nextAddr;
-    m_NextAddr = nextAddr + byteSize;
+    if (freeByteCount > byteCountToEnd)
+    {
+        stats.m_FreeRangeCount = 2;
+        stats.m_LargestFreeBlockByteCount = std::max(byteCountToEnd, freeByteCount - byteCountToEnd);
+    }
+    else if (freeByteCount > 0)
+    {
+        stats.m_FreeRangeCount = 1;
+        stats.m_LargestFreeBlockByteCount = freeByteCount;
+    }
 
-    BIOME_ASSERT_MSG(m_NextAddr <= m_FrameStart || nextAddr < m_NextAddr, "RingBuffer::Allocate: Overallocation for this frame");
+    return stats;
+}
 
-    return reinterpret_cast<void*>(nextAddr);
+uint64_t RingBuffer::ReadAtomicCounter(const void *pCounter)
+{
+    return static_cast<const std::atomic<uint64_t>*>(pCounter)->load(std::memory_order_acquire);
 }
 
-void RingBuffer::EndFrame()
+void RingBuffer::Retire()
 {
-#ifdef _DEBUG
-    m_FrameStart = m_NextAddr;
-#endif
+    if (m_FrameMarkerCount == 0)
+    {
+        return;
+    }
+
+    const uint64_t completedValue = m_pCompletedValueFunction(m_pCompletedValueContext);
+
+    while (m_FrameMarkerCount > 0 && m_pFrameMarkers[m_FirstFrameMarker].m_CompletionValue <= completedValue)
+    {
+        const FrameMarker &marker = m_pFrameMarkers[m_FirstFrameMarker];
+        BIOME_TRACE_ALLOCATION(RingBuffer, Reset, m_pRing + m_Tail % m_ByteSize, marker.m_EndPosition - m_Tail);
+
+        m_Tail = marker.m_EndPosition;
+        m_ReleaseCount = marker.m_EndAllocationCount;
+        m_FirstFrameMarker = (m_FirstFrameMarker + 1) % m_MaxFramesInFlight;
+        --m_FrameMarkerCount;
+    }
 }
@@ -1,30 +1,78 @@
 #pragma once
 
 #include <cstdint>
+#include "biome_core/Memory/AllocatorStats.h"
 
 namespace biome
 {
     namespace memory
     {
+        // Single producer ring allocator for data consumed up to N frames later, e.g. by the GPU.
+        //
+        // `EndFrame` records a marker holding the end of the frame data and the value a completion
+        // counter reaches once that data is consumed. Frames are retired, and their bytes reused,
+        // when the caller-supplied counter reaches their value. The counter can be a GPU frame
+        // fence or, for headless use, an atomic counter read through `ReadAtomicCounter`.
+        //
+        // On overflow, `Allocate` blocks until enough frames retire while `TryAllocate` returns
+        // nullptr so that the caller can fall back to another allocator.
+        //
         class RingBuffer
         {
         public:
 
-            RingBuffer(size_t byteSize);
+            using CompletedValueFunction = uint64_t(*)(const void *pContext);
+
+            static constexpr size_t MaxAlignment = 64;
+
+            RingBuffer(size_t byteSize, uint32_t maxFramesInFlight, CompletedValueFunction pCompletedValueFunction, const void *pContext);
             ~RingBuffer();
 
+            RingBuffer(const RingBuffer&) = delete;
+            RingBuffer& operator=(const RingBuffer&) = delete;
+
             template<typename T>
             void* Allocate();
 
             void* Allocate(size_t byteSize, size_t alignment = sizeof(uint32_t));
-            void EndFrame();
-
-            uintptr_t m_RingStart;
-            uintptr_t m_RingEnd;
-            uintptr_t m_NextAddr;
-        #ifdef _DEBUG
-            uintptr_t m_FrameStart;
-        #endif
+            void* TryAllocate(size_t byteSize, size_t alignment = sizeof(uint32_t));
+            void EndFrame(uint64_t completionValue);
+
+            size_t GetUsedByteCount() const { return static_cast<size_t>(m_Head - m_Tail); }
+            // Allocations are released when their frame retires. The free space splits in two ranges
+            // when it wraps around the end of the buffer.
+            AllocatorStats GetStats() const;
+
+            // `CompletedValueFunction` reading a `std::atomic<uint64_t>` passed as context
+            static uint64_t ReadAtomicCounter(const void *pCounter);
+
+        private:
+
+            struct FrameMarker
+            {
+                uint64_t m_CompletionValue;
+                uint64_t m_EndPosition;
+                uint64_t m_EndAllocationCount;
+            };
+
+            void Retire();
+
+            uint8_t*                m_pRing { nullptr };
+            size_t                  m_ByteSize { 0 };
+            // Positions only ever grow, the ring offset of a position is `position % m_ByteSize`
+            uint64_t                m_Head { 0 };
+            uint64_t                m_Tail { 0 };
+            size_t                  m_PeakUsedByteCount { 0 };
+            uint64_t                m_AllocationCount { 0 };
+            uint64_t                m_ReleaseCount { 0 };
+
+            FrameMarker*            m_pFrameMarkers { nullptr };
+            uint32_t                m_MaxFramesInFlight { 0 };
+            uint32_t                m_FirstFrameMarker { 0 };
+            uint32_t                m_FrameMarkerCount { 0 };
+
+            CompletedValueFunction  m_pCompletedValueFunction { nullptr };
+            const void*             m_pCompletedValueContext { nullptr };
         };
 
         template<typename T>
@@ -0,0 +1,113 @@
+#include <pch.h>
+#include <algorithm>
+#include <bit>
+#include "ScopedArena.h"
+#include "ThreadHeapAllocator.h"
+
+using namespace biome::memory;
+
+ScopedArena::ScopedArena(size_t byteSize, bool allowHeapFallback)
+    : m_pBuffer(static_cast<uint8_t*>(ThreadHeapAllocator::Allocate(byteSize, DefaultAlignment)))
+    , m_ByteSize(byteSize)
+    , m_OwnsBuffer(true)
+    , m_AllowHeapFallback(allowHeapFallback)
+{
+    BIOME_ASSERT_MSG(m_pBuffer != nullptr || byteSize == 0, "ScopedArena: Out of memory");
+}
+
+ScopedArena::ScopedArena(void *pBuffer, size_t byteSize, bool allowHeapFallback)
+    : m_pBuffer(static_cast<uint8_t*>(pBuffer))
+    , m_ByteSize(byteSize)
+    , m_OwnsBuffer(false)
+    , m_AllowHeapFallback(allowHeapFallback)
+{
+}
+
+ScopedArena::~ScopedArena()
+{
+    Reset();
+
+    if (m_OwnsBuffer && m_pBuffer)
+    {
+        ThreadHeapAllocator::Release(m_pBuffer);
+    }
+}
+
+void* ScopedArena::Allocate(size_t byteSize, size_t alignment)
+{
+    BIOME_ASSERT_MSG(std::has_single_bit(alignment), "ScopedArena::Allocate: Alignment must be a power of two");
+
+    // Align the address rather than the offset, a given buffer may have any alignment
+    const uintptr_t bufferAddr = reinterpret_cast<uintptr_t>(m_pBuffer);
+    const size_t alignedOffset = Align(bufferAddr + m_NextByte, alignment) - bufferAddr;
+
+    if (alignedOffset + byteSize <= m_ByteSize)
+    {
+        m_NextByte = alignedOffset + byteSize;
+        return m_pBuffer + alignedOffset;
+    }
+
+    if (m_AllowHeapFallback)
+    {
+        return AllocateFallback(byteSize, alignment);
+    }
+
+    return nullptr;
+}
+
+void ScopedArena::Rewind(const Marker &marker)
+{
+    BIOME_ASSERT_MSG(marker.m_Offset <= m_NextByte && marker.m_FallbackCount <= m_FallbackCount, "ScopedArena::Rewind: Marker is ahead of the arena");
+
+    while (m_FallbackCount > marker.m_FallbackCount)
+    {
+        FallbackHeader *pPrevious = m_pLastFallback->m_pPrevious;
+        ThreadHeapAllocator::Release(m_pLastFallback);
+        m_pLastFallback = pPrevious;
+        --m_FallbackCount;
+    }
+
+    m_NextByte = marker.m_Offset;
+}
+
+void* ScopedArena::AllocateFallback(size_t byteSize, size_t alignment)
+{
+    // The header sits right before the returned address, padded to keep it aligned
+    const size_t headerByteSize = Align(sizeof(FallbackHeader), alignment);
+    const size_t allocationAlignment = std::max(alignment, alignof(FallbackHeader));
+
+    uint8_t *pAllocation = static_cast<uint8_t*>(ThreadHeapAllocator::Allocate(headerByteSize + byteSize, allocationAlignment));
+    if (pAllocation == nullptr)
+    {
+        return nullptr;
+    }
+
+    FallbackHeader *pHeader = reinterpret_cast<FallbackHeader*>(pAllocation);
+    pHeader->m_pPrevious = m_pLastFallback;
+    m_pLastFallback = pHeader;
+    ++m_FallbackCount;
+
+    return pAllocation + headerByteSize;
+}
+
+void* ScopedArena::do_allocate(size_t byteSize, size_t alignment)
+{
+    void *pMemory = Allocate(byteSize, alignment);
+
+    if (pMemory == nullptr)
+    {
+        // The engine does not use exceptions, report the failure the way the other allocators do
+        BIOME_FAIL_MSG("ScopedArena: Out of memory");
+    }
+
+    return pMemory;
+}
+
+void ScopedArena::do_deallocate(void* /*pMemory*/, size_t /*byteSize*/, size_t /*alignment*/)
+{
+}
+
+bool ScopedArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
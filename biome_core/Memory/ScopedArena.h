@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+
+namespace biome
+{
+    namespace memory
+    {
+        // Linear allocator for short-lived data, rewound to markers instead of releasing allocations.
+        //
+        // The arena bumps through a buffer it allocates from the thread heap, or through one it is
+        // given, such as a stack array. With heap fallback enabled, requests that do not fit are
+        // served by the thread heap and released when the arena is rewound past them; otherwise
+        // they fail with nullptr.
+        // The arena is a `std::pmr::memory_resource`, so `std::pmr` containers can use it directly.
+        // Their deallocations are no-ops, memory comes back on `Rewind` or `Reset`.
+        // The arena must be used and destroyed on the thread that created it.
+        //
+        class ScopedArena final : public std::pmr::memory_resource
+        {
+        public:
+
+            static constexpr size_t DefaultAlignment = alignof(std::max_align_t);
+
+            struct Marker
+            {
+                size_t      m_Offset { 0 };
+                uint32_t    m_FallbackCount { 0 };
+            };
+
+            // Rewinds the arena to where it was when the scope was opened
+            class Scope
+            {
+            public:
+
+                Scope(ScopedArena &arena) : m_Arena(arena), m_Marker(arena.GetMarker()) {}
+                ~Scope() { m_Arena.Rewind(m_Marker); }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+
+                ScopedArena&    m_Arena;
+                const Marker    m_Marker;
+            };
+
+            ScopedArena(size_t byteSize, bool allowHeapFallback = true);
+            ScopedArena(void *pBuffer, size_t byteSize, bool allowHeapFallback = true);
+            ~ScopedArena();
+
+            ScopedArena(const ScopedArena&) = delete;
+            ScopedArena& operator=(const ScopedArena&) = delete;
+
+            void*       Allocate(size_t byteSize, size_t alignment = DefaultAlignment);
+            template<typename T>
+            T*          Allocate(size_t count = 1) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+
+            Marker      GetMarker() const { return Marker { m_NextByte, m_FallbackCount }; }
+            void        Rewind(const Marker &marker);
+            void        Reset() { Rewind(Marker {}); }
+
+            size_t      GetUsedByteCount() const { return m_NextByte; }
+            size_t      GetByteSize() const { return m_ByteSize; }
+            uint32_t    GetFallbackCount() const { return m_FallbackCount; }
+
+        private:
+
+            // Stored at the start of every heap fallback allocation
+            struct FallbackHeader
+            {
+                FallbackHeader* m_pPrevious;
+            };
+
+            void*       AllocateFallback(size_t byteSize, size_t alignment);
+
+            void*       do_allocate(size_t byteSize, size_t alignment) override;
+            void        do_deallocate(void *pMemory, size_t byteSize, size_t alignment) override;
+            bool        do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+            uint8_t*        m_pBuffer { nullptr };
+            size_t          m_ByteSize { 0 };
+            size_t          m_NextByte { 0 };
+            FallbackHeader* m_pLastFallback { nullptr };
+            uint32_t        m_FallbackCount { 0 };
+            bool            m_OwnsBuffer { false };
+            bool            m_AllowHeapFallback { false };
+        };
+    }
+}
@@ -0,0 +1,198 @@
+#include <pch.h>
+#include <array>
+#include "SmallObjectAllocator.h"
+
+using namespace biome::memory;
+
+namespace
+{
+    constexpr uint16_t SizeClassByteSizes[] =
+    {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256, 320, 384, 448, 512,
+        640, 768, 896, 1008, 1344, 2032
+    };
+
+    constexpr size_t LookupGranularity = SmallObjectAllocator::Alignment;
+    constexpr size_t LookupEntryCount = SmallObjectAllocator::MaxByteSize / LookupGranularity + 1;
+
+    // Maps a byte size rounded up to `LookupGranularity` to the smallest size class that fits it.
+    constexpr std::array<uint8_t, LookupEntryCount> BuildSizeClassLookup()
+    {
+        std::array<uint8_t, LookupEntryCount> lookup {};
+
+        uint8_t sizeClass = 0;
+        for (size_t i = 0; i < LookupEntryCount; ++i)
+        {
+            while (SizeClassByteSizes[sizeClass] < i * LookupGranularity)
+            {
+                ++sizeClass;
+            }
+
+            lookup[i] = sizeClass;
+        }
+
+        return lookup;
+    }
+
+    constexpr std::array<uint8_t, LookupEntryCount> SizeClassLookup = BuildSizeClassLookup();
+
+    static_assert(SizeClassByteSizes[BIOME_ARRAY_SIZE(SizeClassByteSizes) - 1] == SmallObjectAllocator::MaxByteSize);
+}
+
+void SmallObjectAllocator::Initialize(size_t pageSize)
+{
+    static_assert(BIOME_ARRAY_SIZE(SizeClassByteSizes) == SizeClassCount);
+    BIOME_ASSERT_MSG(pageSize >= sizeof(Slab) + 2 * MaxByteSize, "SmallObjectAllocator: System page size is too small to hold slabs.");
+
+    m_PageSize = pageSize;
+
+    for (Slab *&pSlab : m_pPartialSlabs)
+    {
+        pSlab = nullptr;
+    }
+}
+
+void* SmallObjectAllocator::Allocate(size_t byteSize)
+{
+    BIOME_ASSERT(byteSize <= MaxByteSize);
+
+    Slab *pSlab = m_pPartialSlabs[SizeClassIndex(byteSize)];
+    if (pSlab)
+    {
+        return AllocateBlock(pSlab);
+    }
+
+    return nullptr;
+}
+
+void* SmallObjectAllocator::AllocateFromNewSlab(void *pPage, size_t byteSize)
+{
+    BIOME_ASSERT_MSG(!IsSmallAllocation(pPage, m_PageSize), "SmallObjectAllocator: Slab pages must be page aligned.");
+
+    const uint32_t sizeClass = SizeClassIndex(byteSize);
+    const size_t blockByteSize = SizeClassByteSize(sizeClass);
+
+    Slab *pSlab = static_cast<Slab*>(pPage);
+    pSlab->m_pNext = nullptr;
+    pSlab->m_pPrevious = nullptr;
+    pSlab->m_pFreeBlocks = nullptr;
+    pSlab->m_SizeClass = static_cast<uint16_t>(sizeClass);
+    pSlab->m_BlockCount = static_cast<uint16_t>((m_PageSize - sizeof(Slab)) / blockByteSize);
+    pSlab->m_UsedCount = 0;
+    pSlab->m_UntouchedIndex = 0;
+
+    LinkSlab(pSlab);
+
+    return AllocateBlock(pSlab);
+}
+
+void* SmallObjectAllocator::Release(void *pMemory)
+{
+    Slab *pSlab = AddressToSlab(pMemory);
+
+    BIOME_ASSERT_MSG(pSlab->m_UsedCount > 0, "SmallObjectAllocator::Release: Releasing from an empty slab");
+    BIOME_ASSERT_MSG(
+        ((reinterpret_cast<uintptr_t>(pMemory) - reinterpret_cast<uintptr_t>(pSlab + 1)) % SizeClassByteSize(pSlab->m_SizeClass)) == 0,
+        "SmallObjectAllocator::Release: Address is not the start of a block");
+
+    if (pSlab->m_UsedCount == pSlab->m_BlockCount)
+    {
+        // Slab was full and therefore out of the partial list
+        LinkSlab(pSlab);
+    }
+
+    *static_cast<void**>(pMemory) = pSlab->m_pFreeBlocks;
+    pSlab->m_pFreeBlocks = pMemory;
+    --pSlab->m_UsedCount;
+
+    // Keep the last slab of a size class around to avoid committing and releasing a page back and forth.
+    const bool isLastSlab = pSlab->m_pNext == nullptr && pSlab->m_pPrevious == nullptr;
+    if (pSlab->m_UsedCount == 0 && !isLastSlab)
+    {
+        UnlinkSlab(pSlab);
+        return pSlab;
+    }
+
+    return nullptr;
+}
+
+size_t SmallObjectAllocator::AllocationSize(const void *pMemory) const
+{
+    const Slab *pSlab = AddressToSlab(pMemory);
+    return SizeClassByteSize(pSlab->m_SizeClass);
+}
+
+uint32_t SmallObjectAllocator::SizeClassIndex(size_t byteSize)
+{
+    return SizeClassLookup[(byteSize + LookupGranularity - 1) / LookupGranularity];
+}
+
+size_t SmallObjectAllocator::SizeClassByteSize(uint32_t sizeClass)
+{
+    return SizeClassByteSizes[sizeClass];
+}
+
+void* SmallObjectAllocator::AllocateBlock(Slab *pSlab)
+{
+    void *pBlock = pSlab->m_pFreeBlocks;
+
+    if (pBlock)
+    {
+        pSlab->m_pFreeBlocks = *static_cast<void**>(pBlock);
+    }
+    else
+    {
+        const size_t blockOffset = size_t(pSlab->m_UntouchedIndex++) * SizeClassByteSize(pSlab->m_SizeClass);
+        pBlock = reinterpret_cast<uint8_t*>(pSlab + 1) + blockOffset;
+    }
+
+    if (++pSlab->m_UsedCount == pSlab->m_BlockCount)
+    {
+        // Full slabs leave the partial list until one of their blocks is released
+        UnlinkSlab(pSlab);
+    }
+
+    return pBlock;
+}
+
+void SmallObjectAllocator::LinkSlab(Slab *pSlab)
+{
+    Slab *&pHead = m_pPartialSlabs[pSlab->m_SizeClass];
+
+    pSlab->m_pPrevious = nullptr;
+    pSlab->m_pNext = pHead;
+
+    if (pHead)
+    {
+        pHead->m_pPrevious = pSlab;
+    }
+
+    pHead = pSlab;
+}
+
+void SmallObjectAllocator::UnlinkSlab(Slab *pSlab)
+{
+    if (pSlab->m_pPrevious)
+    {
+        pSlab->m_pPrevious->m_pNext = pSlab->m_pNext;
+    }
+    else
+    {
+        m_pPartialSlabs[pSlab->m_SizeClass] = pSlab->m_pNext;
+    }
+
+    if (pSlab->m_pNext)
+    {
+        pSlab->m_pNext->m_pPrevious = pSlab->m_pPrevious;
+    }
+
+    pSlab->m_pNext = nullptr;
+    pSlab->m_pPrevious = nullptr;
+}
+
+SmallObjectAllocator::Slab* SmallObjectAllocator::AddressToSlab(const void *pMemory) const
+{
+    const uintptr_t pageMask = ~uintptr_t(m_PageSize - 1);
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(pMemory) & pageMask);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include "biome_core/Core/Defines.h"
+
+namespace biome
+{
+    namespace memory
+    {
+        // Segregated size-class allocator for small objects.
+        //
+        // Each slab is a single system page handed over by the owning `ThreadHeapAllocator`
+        // and only holds blocks of one size class. The slab header lives at the start of
+        // its page, so a small block is never page aligned. This is how the heap tells
+        // small blocks apart from page allocations when they are released.
+        //
+        // The allocator never talks to the heap itself: `Allocate` returns nullptr when
+        // a new slab is required and `Release` returns the slab page once it is empty.
+        //
+        // All operations in this allocator are in O(1)
+        //
+        class SmallObjectAllocator
+        {
+        public:
+
+            static constexpr size_t Alignment = 16;
+            static constexpr size_t MaxByteSize = 2032;
+
+            SmallObjectAllocator() = default;
+            SmallObjectAllocator(const SmallObjectAllocator&) = delete;
+            SmallObjectAllocator(SmallObjectAllocator&&) = delete;
+            SmallObjectAllocator& operator=(const SmallObjectAllocator&) = delete;
+            SmallObjectAllocator& operator=(SmallObjectAllocator&&) = delete;
+            ~SmallObjectAllocator() = default;
+
+            void    Initialize(size_t pageSize);
+            void*   Allocate(size_t byteSize);
+            void*   AllocateFromNewSlab(void *pPage, size_t byteSize);
+            void*   Release(void *pMemory);
+            size_t  AllocationSize(const void *pMemory) const;
+
+            static bool IsSmallAllocation(const void *pMemory, size_t pageSize)
+            {
+                return (reinterpret_cast<uintptr_t>(pMemory) & (pageSize - 1)) != 0;
+            }
+
+        private:
+
+            struct alignas(Alignment) Slab
+            {
+                Slab*       m_pNext;
+                Slab*       m_pPrevious;
+                void*       m_pFreeBlocks;      // Intrusive list of released blocks
+                uint16_t    m_SizeClass;
+                uint16_t    m_BlockCount;
+                uint16_t    m_UsedCount;
+                uint16_t    m_UntouchedIndex;   // Blocks from this index on were never handed out
+            };
+
+            static constexpr uint32_t SizeClassCount = 22;
+
+            static uint32_t SizeClassIndex(size_t byteSize);
+            static size_t   SizeClassByteSize(uint32_t sizeClass);
+
+            void*   AllocateBlock(Slab *pSlab);
+            void    LinkSlab(Slab *pSlab);
+            void    UnlinkSlab(Slab *pSlab);
+            Slab*   AddressToSlab(const void *pMemory) const;
+
+            Slab*   m_pPartialSlabs[SizeClassCount] {};
+            size_t  m_PageSize { 0 };
+        };
+    }
+}
@@ -4,6 +4,37 @@
 
 using namespace biome::memory;
 
+SubAllocator::SubAllocator(SubAllocator &&other) noexcept
+    : m_pAllocation(other.m_pAllocation)
+    , m_accumulatedBytes(other.m_accumulatedBytes)
+    , m_alignment(other.m_alignment)
+{
+    other.m_pAllocation = nullptr;
+    other.m_accumulatedBytes = 0;
+    other.m_alignment = 1;
+}
+
+SubAllocator& SubAllocator::operator=(SubAllocator &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_pAllocation)
+        {
+            ThreadHeapAllocator::Release(m_pAllocation);
+        }
+
+        m_pAllocation = other.m_pAllocation;
+        m_accumulatedBytes = other.m_accumulatedBytes;
+        m_alignment = other.m_alignment;
+
+        other.m_pAllocation = nullptr;
+        other.m_accumulatedBytes = 0;
+        other.m_alignment = 1;
+    }
+
+    return *this;
+}
+
 SubAllocator::~SubAllocator()
 {
     if (m_pAllocation)
@@ -11,3 +42,13 @@ SubAllocator::~SubAllocator()
         ThreadHeapAllocator::Release(m_pAllocation);
     }
 }
+
+void SubAllocator::Allocate()
+{
+    BIOME_ASSERT_MSG(m_pAllocation == nullptr, "SubAllocator::Allocate: Already allocated");
+
+    if (m_accumulatedBytes > 0)
+    {
+        m_pAllocation = static_cast<uint8_t*>(ThreadHeapAllocator::Allocate(m_accumulatedBytes, m_alignment));
+    }
+}
@@ -1,26 +1,71 @@
 #pragma once
 
+#include <cstdint>
+#include <algorithm>
+#include <span>
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/Memory.h"
+
 namespace biome
 {
     namespace memory
     {
+        // Typed sub-range of a `SubAllocator` allocation, returned by `Accumulate`.
+        template<typename T>
+        struct SubRange
+        {
+            size_t m_Offset { 0 };
+            size_t m_Count { 0 };
+        };
+
+        // Packs several arrays in a single allocation.
+        //
+        // Sub-ranges are first accumulated, then `Allocate` makes one allocation aligned for all of
+        // them, after which typed spans are retrieved with `Get`. The allocation is released with the
+        // sub-allocator. Spans are not constructed, it is up to the caller to construct and
+        // destroy non-trivial types.
+        //
         class SubAllocator
         {
         public:
 
             SubAllocator() = default;
+            SubAllocator(SubAllocator &&other) noexcept;
+            SubAllocator& operator=(SubAllocator &&other) noexcept;
+            SubAllocator(const SubAllocator&) = delete;
+            SubAllocator& operator=(const SubAllocator&) = delete;
             ~SubAllocator();
 
             template<typename T>
-            void Accumulate(size_t count)
+            SubRange<T> Accumulate(size_t count)
             {
-                m_accumulatedBytes = memory::Align(m_accumulatedBytes, alignof(T)) + (sizeof(T) * count);
+                BIOME_ASSERT_MSG(m_pAllocation == nullptr, "SubAllocator::Accumulate: Already allocated");
+
+                const size_t offset = memory::Align(m_accumulatedBytes, alignof(T));
+                m_accumulatedBytes = offset + (sizeof(T) * count);
+                m_alignment = std::max(m_alignment, alignof(T));
+
+                return SubRange<T> { offset, count };
             }
 
+            void Allocate();
+
+            template<typename T>
+            std::span<T> Get(const SubRange<T> &range) const
+            {
+                BIOME_ASSERT_MSG(m_pAllocation != nullptr || range.m_Count == 0, "SubAllocator::Get: Not allocated yet");
+                BIOME_ASSERT_MSG(range.m_Offset + sizeof(T) * range.m_Count <= m_accumulatedBytes, "SubAllocator::Get: Range out of the allocation");
+
+                return std::span<T>(reinterpret_cast<T*>(m_pAllocation + range.m_Offset), range.m_Count);
+            }
+
+            size_t GetByteSize() const { return m_accumulatedBytes; }
+
         private:
 
             uint8_t*    m_pAllocation { nullptr };
             size_t      m_accumulatedBytes { 0 };
+            size_t      m_alignment { 1 };
         };
     }
 }
\ No newline at end of file
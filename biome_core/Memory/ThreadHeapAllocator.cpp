@@ -1,12 +1,15 @@
 #include <pch.h>
+#include <thread>
 #include "ThreadHeapAllocator.h"
-#include "VirtualMemoryAllocator.h"
+#include "MemoryRegistry.h"
+#include "AllocationTrace.h"
 
 using namespace biome::memory;
 
 thread_local ThreadHeapAllocator* ThreadHeapAllocator::s_pAllocator = nullptr;
+std::atomic<uint32_t> ThreadHeapAllocator::s_PendingRemoteReleaseCount { 0 };
 
-ThreadHeapAllocator* ThreadHeapAllocator::CreateAllocator(size_t heapByteSize, size_t initialCommitByteSize)
+ThreadHeapAllocator* ThreadHeapAllocator::CreateAllocator(size_t heapByteSize, size_t initialCommitByteSize, LargePageMode largePageMode)
 {
     void* pMemory = malloc(sizeof(ThreadHeapAllocator));
     ThreadHeapAllocator* pAllocator = new(pMemory) ThreadHeapAllocator();
@@ -14,34 +17,42 @@ ThreadHeapAllocator* ThreadHeapAllocator::CreateAllocator(size_t heapByteSize, s
     const uint32_t pageSize = VirtualMemoryAllocator::GetSystemPageSize();
     const uint32_t pageCount = static_cast<uint32_t>(Align(heapByteSize, pageSize)) / pageSize;
     const uint32_t committedPageCount = static_cast<uint32_t>(Align(initialCommitByteSize, pageSize)) / pageSize;
-    const size_t metadataOverhead = (sizeof(uint32_t) + sizeof(FreeRange)) * pageCount;
+    const size_t metadataOverhead = sizeof(PageRun) * pageCount;
 
-    pAllocator->m_MemoryPool = reinterpret_cast<uintptr_t>(VirtualMemoryAllocator::Allocate(heapByteSize, initialCommitByteSize, pageSize));
-    pAllocator->m_pFreeRanges = static_cast<FreeRange*>(VirtualMemoryAllocator::Allocate(metadataOverhead, metadataOverhead));
-    pAllocator->m_pPages = reinterpret_cast<uint32_t*>(pAllocator->m_pFreeRanges + pageCount);
+    pAllocator->m_MemoryPool = reinterpret_cast<uintptr_t>(VirtualMemoryAllocator::Allocate(heapByteSize, initialCommitByteSize, pageSize, largePageMode));
+    pAllocator->m_pPages = static_cast<PageRun*>(VirtualMemoryAllocator::Allocate(metadataOverhead, metadataOverhead));
 
     pAllocator->m_SystemPageSize = pageSize;
     pAllocator->m_TotalPageCount = pageCount;
+    pAllocator->m_InitialCommittedPageCount = committedPageCount;
     pAllocator->m_CommittedPageCount = committedPageCount;
     pAllocator->m_NextPageIndex = 0;
+    pAllocator->m_LargePageMode = VirtualMemoryAllocator::GetLargePageMode(reinterpret_cast<void*>(pAllocator->m_MemoryPool));
+
+    pAllocator->m_FreeRuns.Initialize(pAllocator->m_pPages);
+
+    pAllocator->m_SmallObjects.Initialize(pageSize);
+
+    RegisterOwner(reinterpret_cast<void*>(pAllocator->m_MemoryPool), size_t(pageCount) * pageSize, MemoryOwnerType::ThreadHeap, pAllocator);
 
     return pAllocator;
 }
 
 ThreadHeapAllocator::~ThreadHeapAllocator()
 {
+    // Unregistered by `Shutdown`, which must not free the heap while remote releases can reach it
     if (m_MemoryPool != 0)
     {
-        VirtualMemoryAllocator::Release(m_pFreeRanges);
+        VirtualMemoryAllocator::Release(m_pPages);
         VirtualMemoryAllocator::Release(reinterpret_cast<void*>(m_MemoryPool));
     }
 }
 
-bool ThreadHeapAllocator::Initialize(size_t heapByteSize, size_t initialCommitByteSize)
+bool ThreadHeapAllocator::Initialize(size_t heapByteSize, size_t initialCommitByteSize, LargePageMode largePageMode)
 {
     BIOME_ASSERT_MSG(s_pAllocator == nullptr, "ThreadHeapAllocator already initialized");
 
-    s_pAllocator = CreateAllocator(heapByteSize, initialCommitByteSize);
+    s_pAllocator = CreateAllocator(heapByteSize, initialCommitByteSize, largePageMode);
     return s_pAllocator != nullptr;
 }
 
@@ -52,16 +63,33 @@ bool ThreadHeapAllocator::IsInitialized()
 
 void ThreadHeapAllocator::Shutdown()
 {
-    s_pAllocator->~ThreadHeapAllocator();
-    free(s_pAllocator);
+    ThreadHeapAllocator *pAllocator = s_pAllocator;
     s_pAllocator = nullptr;
+
+    // New lookups no longer find this heap once it is unregistered
+    UnregisterOwner(reinterpret_cast<void*>(pAllocator->m_MemoryPool), size_t(pAllocator->m_TotalPageCount) * pAllocator->m_SystemPageSize);
+
+    // Pairs with the fence in `Release`: either the remote release sees the heap unregistered,
+    // or its pending count is seen here and the heap is kept until its push is done
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (s_PendingRemoteReleaseCount.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    pAllocator->DrainRemoteReleases();
+    pAllocator->~ThreadHeapAllocator();
+    free(pAllocator);
 }
 
-void* ThreadHeapAllocator::Allocate(size_t byteSize)
+void* ThreadHeapAllocator::Allocate(size_t byteSize, size_t alignment)
 {
     if(s_pAllocator)
     {
-        return s_pAllocator->AllocateInternal(byteSize);
+        void *pAllocation = s_pAllocator->AllocateInternal(byteSize, alignment);
+        BIOME_TRACE_ALLOCATION(ThreadHeap, Allocate, pAllocation, byteSize);
+        return pAllocation;
     }
     
     return nullptr;
@@ -74,17 +102,38 @@ bool ThreadHeapAllocator::WasAllocatedFromThisThread(void* pMemory)
 
 bool ThreadHeapAllocator::Release(void *pMemory)
 {
-    if(s_pAllocator)
+    BIOME_TRACE_ALLOCATION(ThreadHeap, Release, pMemory, 0);
+
+    if(s_pAllocator && s_pAllocator->WasAllocatedFromThisThreadInternal(pMemory))
     {
         return s_pAllocator->ReleaseInternal(pMemory);
     }
+
+    // Counted from before the lookup until after the push, so that `Shutdown` cannot free the owner in between
+    s_PendingRemoteReleaseCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    ThreadHeapAllocator *pOwner = FindOwner(pMemory);
+    if (pOwner)
+    {
+        pOwner->PushRemoteRelease(pMemory);
+    }
+
+    s_PendingRemoteReleaseCount.fetch_sub(1, std::memory_order_release);
     
-    return false;
+    return pOwner != nullptr;
 }
 
 size_t ThreadHeapAllocator::AllocationSize(void *pMemory)
 {
-    return s_pAllocator->AllocationSizeInternal(pMemory);
+    if (s_pAllocator && s_pAllocator->WasAllocatedFromThisThreadInternal(pMemory))
+    {
+        return s_pAllocator->AllocationSizeInternal(pMemory);
+    }
+
+    // Tags of a live allocation are only ever written by its owner when allocating it, reading them is safe
+    ThreadHeapAllocator *pOwner = FindOwner(pMemory);
+    return pOwner ? pOwner->AllocationSizeInternal(pMemory) : 0;
 }
 
 void ThreadHeapAllocator::Defrag()
@@ -92,46 +141,100 @@ void ThreadHeapAllocator::Defrag()
     s_pAllocator->DefragInternal();
 }
 
-void* ThreadHeapAllocator::AllocateInternal(size_t byteSize)
+AllocatorStats ThreadHeapAllocator::GetStats()
 {
-    void *pAllocation = nullptr;
+    return s_pAllocator ? s_pAllocator->GetStatsInternal() : AllocatorStats {};
+}
 
-    const uint32_t requiredPageCount = static_cast<uint32_t>(Align(byteSize, m_SystemPageSize) / m_SystemPageSize);
-    const uint32_t newNextPageIndex = m_NextPageIndex + requiredPageCount;
-    BIOME_ASSERT_MSG(requiredPageCount <= m_TotalPageCount, "ThreadHeapAllocator: Requested allocation exceeds allocator total byte size.");
-    
-    if (newNextPageIndex < m_CommittedPageCount)
+ThreadHeapAllocator* ThreadHeapAllocator::FindOwner(void *pMemory)
+{
+    const MemoryOwner owner = biome::memory::FindOwner(pMemory);
+
+    if (owner.m_Type == MemoryOwnerType::ThreadHeap)
     {
-        m_pPages[m_NextPageIndex] = requiredPageCount;
-        pAllocation = PageIndexToAddress(m_NextPageIndex);
-        m_NextPageIndex = newNextPageIndex;
+        ThreadHeapAllocator *pAllocator = static_cast<ThreadHeapAllocator*>(owner.m_pOwner);
+        BIOME_ASSERT(pAllocator->WasAllocatedFromThisThreadInternal(pMemory));
+        return pAllocator;
     }
-    else
+
+    return nullptr;
+}
+
+void* ThreadHeapAllocator::AllocateInternal(size_t byteSize, size_t alignment)
+{
+    BIOME_ASSERT_MSG(alignment <= m_SystemPageSize, "ThreadHeapAllocator: Alignment larger than system page size is not supported.");
+
+    if (m_pRemoteReleases.load(std::memory_order_relaxed) != nullptr)
     {
-        uint32_t freePagesStartIndex = SearchFreePages(requiredPageCount);
-        if (freePagesStartIndex != UINT32_MAX)
+        DrainRemoteReleases();
+    }
+
+    void *pAllocation = (byteSize <= SmallObjectAllocator::MaxByteSize && alignment <= SmallObjectAllocator::Alignment) ?
+        AllocateSmallInternal(byteSize) :
+        AllocatePagesInternal(byteSize);
+
+    if (pAllocation)
+    {
+        m_UsedByteCount += AllocationSizeInternal(pAllocation);
+        m_PeakUsedByteCount = std::max(m_PeakUsedByteCount, m_UsedByteCount);
+        ++m_AllocationCount;
+    }
+
+    return pAllocation;
+}
+
+void* ThreadHeapAllocator::AllocateSmallInternal(size_t byteSize)
+{
+    void *pAllocation = m_SmallObjects.Allocate(byteSize);
+
+    if (pAllocation == nullptr)
+    {
+        void *pSlabPage = AllocatePagesInternal(m_SystemPageSize);
+        if (pSlabPage)
+        {
+            pAllocation = m_SmallObjects.AllocateFromNewSlab(pSlabPage, byteSize);
+        }
+    }
+
+    return pAllocation;
+}
+
+void* ThreadHeapAllocator::AllocatePagesInternal(size_t byteSize)
+{
+    const uint32_t requiredPageCount = std::max(static_cast<uint32_t>(Align(byteSize, m_SystemPageSize) / m_SystemPageSize), 1u);
+    BIOME_ASSERT_MSG(requiredPageCount <= m_TotalPageCount, "ThreadHeapAllocator: Requested allocation exceeds allocator total byte size.");
+
+    uint32_t pageIndex = SearchFreePages(requiredPageCount);
+
+    if (pageIndex != InvalidPageIndex)
+    {
+        const uint32_t freePageCount = RunPageCount(pageIndex);
+        if (freePageCount > requiredPageCount)
         {
-            m_pPages[freePagesStartIndex] = requiredPageCount;
-            pAllocation = PageIndexToAddress(freePagesStartIndex);
+            InsertFreeRun(pageIndex + requiredPageCount, freePageCount - requiredPageCount);
         }
-        else
+    }
+    else if (requiredPageCount <= m_TotalPageCount - m_NextPageIndex)
+    {
+        const uint32_t newNextPageIndex = m_NextPageIndex + requiredPageCount;
+        if (newNextPageIndex > m_CommittedPageCount)
         {
-            uint32_t newRequiredCommitCount = newNextPageIndex - m_CommittedPageCount;
-            uint32_t remainingReservedPagesCount = m_TotalPageCount - m_CommittedPageCount;
-            if (newRequiredCommitCount <= remainingReservedPagesCount)
-            {
-                CommitMorePages(newRequiredCommitCount);
-
-                m_pPages[m_NextPageIndex] = requiredPageCount;
-                pAllocation = PageIndexToAddress(m_NextPageIndex);
-                m_NextPageIndex = newNextPageIndex;
-            }
+            CommitMorePages(newNextPageIndex - m_CommittedPageCount);
         }
+
+        pageIndex = m_NextPageIndex;
+        m_NextPageIndex = newNextPageIndex;
     }
 
-    BIOME_ASSERT_MSG(pAllocation, "ThreadHeapAllocator: Out of Memory");
+    BIOME_ASSERT_MSG(pageIndex != InvalidPageIndex, "ThreadHeapAllocator: Out of Memory");
 
-    return pAllocation;
+    if (pageIndex == InvalidPageIndex)
+    {
+        return nullptr;
+    }
+
+    SetRunTags(pageIndex, requiredPageCount, false);
+    return PageIndexToAddress(pageIndex);
 }
 
 bool ThreadHeapAllocator::WasAllocatedFromThisThreadInternal(void* pMemory)
@@ -148,23 +251,138 @@ bool ThreadHeapAllocator::ReleaseInternal(void *pMemory)
         return false;
     }
 
-    const uint32_t pageIndex = AddressToPageIndex(pMemory);
-    FreeRange &range = m_pFreeRanges[m_FreeRangesCount++];
-    range.m_Index = pageIndex;
-    range.m_Count = m_pPages[pageIndex];
+    m_UsedByteCount -= AllocationSizeInternal(pMemory);
+    ++m_ReleaseCount;
+
+    if (SmallObjectAllocator::IsSmallAllocation(pMemory, m_SystemPageSize))
+    {
+        void *pEmptySlabPage = m_SmallObjects.Release(pMemory);
+        if (pEmptySlabPage)
+        {
+            ReleasePagesInternal(pEmptySlabPage);
+        }
+    }
+    else
+    {
+        ReleasePagesInternal(pMemory);
+    }
 
     return true;
 }
 
+void ThreadHeapAllocator::ReleasePagesInternal(void *pMemory)
+{
+    uint32_t pageIndex = AddressToPageIndex(pMemory);
+    uint32_t pageCount = RunPageCount(pageIndex);
+
+    BIOME_ASSERT_MSG(!IsRunFree(pageIndex), "ThreadHeapAllocator::Release: Releasing already released memory");
+
+    // Merge with the previous run, found through the boundary tag of its last page
+    if (pageIndex > 0 && IsRunFree(pageIndex - 1))
+    {
+        const uint32_t previousPageCount = RunPageCount(pageIndex - 1);
+        pageIndex -= previousPageCount;
+        pageCount += previousPageCount;
+        RemoveFreeRun(pageIndex);
+    }
+
+    // Merge with the next run
+    const uint32_t nextPageIndex = pageIndex + pageCount;
+    if (nextPageIndex < m_NextPageIndex && IsRunFree(nextPageIndex))
+    {
+        pageCount += RunPageCount(nextPageIndex);
+        RemoveFreeRun(nextPageIndex);
+    }
+
+    if (pageIndex + pageCount == m_NextPageIndex)
+    {
+        // Run touches the untouched end of the heap, give the pages back to it
+        m_NextPageIndex = pageIndex;
+    }
+    else
+    {
+        InsertFreeRun(pageIndex, pageCount);
+    }
+}
+
 size_t ThreadHeapAllocator::AllocationSizeInternal(void *pMemory)
 {
+    if (SmallObjectAllocator::IsSmallAllocation(pMemory, m_SystemPageSize))
+    {
+        return m_SmallObjects.AllocationSize(pMemory);
+    }
+
     const uint32_t pageIndex = AddressToPageIndex(pMemory);
-    return m_pPages[pageIndex] * m_SystemPageSize;
+    return RunPageCount(pageIndex) * m_SystemPageSize;
+}
+
+void ThreadHeapAllocator::PushRemoteRelease(void *pMemory)
+{
+    RemoteRelease *pRelease = static_cast<RemoteRelease*>(pMemory);
+    pRelease->m_pNext = m_pRemoteReleases.load(std::memory_order_relaxed);
+
+    while (!m_pRemoteReleases.compare_exchange_weak(pRelease->m_pNext, pRelease, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+void ThreadHeapAllocator::DrainRemoteReleases()
+{
+    // Only the owning thread pops, and it takes the whole stack at once so there is no ABA hazard
+    RemoteRelease *pRelease = m_pRemoteReleases.exchange(nullptr, std::memory_order_acquire);
+
+    while (pRelease)
+    {
+        RemoteRelease *pNext = pRelease->m_pNext;
+        ReleaseInternal(pRelease);
+        pRelease = pNext;
+    }
 }
 
 void ThreadHeapAllocator::DefragInternal()
 {
-    // #todo Implement allocator memory defrag
+    DrainRemoteReleases();
+
+    // Every page from `m_NextPageIndex` on is free, decommit them down to the initial commit size
+    const uint32_t firstDecommitPageIndex = std::max(m_NextPageIndex, m_InitialCommittedPageCount);
+
+    // Explicit large pages stay resident until the heap is released
+    if (firstDecommitPageIndex < m_CommittedPageCount && m_LargePageMode != LargePageMode::Explicit)
+    {
+        const size_t decommitByteSize = size_t(m_CommittedPageCount - firstDecommitPageIndex) * m_SystemPageSize;
+        VirtualMemoryAllocator::Decommit(PageIndexToAddress(firstDecommitPageIndex), decommitByteSize);
+        m_CommittedPageCount = firstDecommitPageIndex;
+    }
+}
+
+AllocatorStats ThreadHeapAllocator::GetStatsInternal() const
+{
+    const bool hasUntouchedPages = m_NextPageIndex < m_TotalPageCount;
+
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = m_TotalPageCount * m_SystemPageSize;
+    stats.m_CommittedByteCount = m_CommittedPageCount * m_SystemPageSize;
+    stats.m_UsedByteCount = m_UsedByteCount;
+    stats.m_PeakUsedByteCount = m_PeakUsedByteCount;
+    stats.m_LargestFreeBlockByteCount = LargestFreeRunPageCount() * m_SystemPageSize;
+    stats.m_FreeRangeCount = m_FreeRuns.Count() + (hasUntouchedPages ? 1 : 0);
+    stats.m_AllocationCount = m_AllocationCount;
+    stats.m_ReleaseCount = m_ReleaseCount;
+
+    return stats;
+}
+
+uint32_t ThreadHeapAllocator::LargestFreeRunPageCount() const
+{
+    uint32_t largestPageCount = m_TotalPageCount - m_NextPageIndex;
+
+    // The largest run is in the highest non-empty bucket, which only spans a few sizes
+    for (uint32_t pageIndex = m_FreeRuns.FirstInLargestBucket(); pageIndex != InvalidPageIndex; pageIndex = m_FreeRuns.NextInBucket(pageIndex))
+    {
+        largestPageCount = std::max(largestPageCount, RunPageCount(pageIndex));
+    }
+
+    return largestPageCount;
 }
 
 void ThreadHeapAllocator::CommitMorePages(uint32_t pageCount)
@@ -173,27 +391,55 @@ void ThreadHeapAllocator::CommitMorePages(uint32_t pageCount)
     BIOME_ASSERT_MSG(pageCount <= reservedPageCount, 
         "ThreadHeapAllocator::CommitMorePages: Cannot commit requested number of pages. Not enough reserved memory");
 
-    size_t newCommittedPageCount = std::min(std::max(pageCount, m_CommittedPageCount * 2), reservedPageCount);
-    VirtualMemoryAllocator::Commit(PageIndexToAddress(m_CommittedPageCount), newCommittedPageCount * m_SystemPageSize);
+    const uint32_t commitPageCount = std::min(std::max(pageCount, m_CommittedPageCount), reservedPageCount);
+    if (m_LargePageMode != LargePageMode::Explicit)
+    {
+        VirtualMemoryAllocator::Commit(PageIndexToAddress(m_CommittedPageCount), size_t(commitPageCount) * m_SystemPageSize);
+    }
+
+    m_CommittedPageCount += commitPageCount;
 }
 
 uint32_t ThreadHeapAllocator::SearchFreePages(uint32_t pageCount)
 {
-    uint32_t rangeStartIndex = UINT32_MAX;
+    const uint32_t pageIndex = m_FreeRuns.FindFit(pageCount);
 
-    const uint32_t rangeCount = m_FreeRangesCount;
-    for (uint32_t i = 0; i < rangeCount; ++i)
+    if (pageIndex != InvalidPageIndex)
     {
-        FreeRange &range = m_pFreeRanges[i];
-        if (range.m_Count >= pageCount)
-        {
-            rangeStartIndex = range.m_Index;
-            m_pFreeRanges[i] = m_pFreeRanges[--m_FreeRangesCount];
-            break;
-        }
+        RemoveFreeRun(pageIndex);
     }
 
-    return rangeStartIndex;
+    return pageIndex;
+}
+
+void ThreadHeapAllocator::InsertFreeRun(uint32_t pageIndex, uint32_t pageCount)
+{
+    SetRunTags(pageIndex, pageCount, true);
+    m_FreeRuns.Insert(pageIndex, pageCount);
+}
+
+void ThreadHeapAllocator::RemoveFreeRun(uint32_t pageIndex)
+{
+    const uint32_t pageCount = RunPageCount(pageIndex);
+    m_FreeRuns.Remove(pageIndex, pageCount);
+    SetRunTags(pageIndex, pageCount, false);
+}
+
+void ThreadHeapAllocator::SetRunTags(uint32_t pageIndex, uint32_t pageCount, bool isFree)
+{
+    const uint32_t tag = isFree ? (pageCount | FreeRunFlag) : pageCount;
+    m_pPages[pageIndex].m_PageCount = tag;
+    m_pPages[pageIndex + pageCount - 1].m_PageCount = tag;
+}
+
+uint32_t ThreadHeapAllocator::RunPageCount(uint32_t pageIndex) const
+{
+    return m_pPages[pageIndex].m_PageCount & ~FreeRunFlag;
+}
+
+bool ThreadHeapAllocator::IsRunFree(uint32_t pageIndex) const
+{
+    return (m_pPages[pageIndex].m_PageCount & FreeRunFlag) != 0;
 }
 
 void* ThreadHeapAllocator::PageIndexToAddress(uint32_t index)
@@ -1,13 +1,34 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
 #include "biome_core/Memory/Memory.h"
+#include "biome_core/Memory/AllocatorStats.h"
+#include "biome_core/Memory/SmallObjectAllocator.h"
+#include "biome_core/Memory/TlsfIndex.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
 #include "biome_core/Core/Defines.h"
 
 namespace biome
 {
     namespace memory
     {
+        // Per-thread page heap reserved from the `VirtualMemoryAllocator`.
+        //
+        // Requests of at most `SmallObjectAllocator::MaxByteSize` bytes with an alignment
+        // of at most `SmallObjectAllocator::Alignment` are served from size-class slabs.
+        // Every other request is rounded up to whole system pages and is page aligned.
+        //
+        // Released page runs are merged with their free neighbours right away and indexed
+        // in a two-level segregated-fit (TLSF) table, so finding a free run is in O(1).
+        // Runs touching the untouched end of the heap are folded back into it, which lets
+        // `Defrag` decommit them.
+        //
+        // Memory released from another thread is pushed on a lock-free stack owned by the
+        // heap it came from. The owning thread puts it back in its heap on its next allocation.
+        // `Shutdown` unregisters the heap first, then waits for the remote releases that may
+        // still hold it before freeing it.
+        //
         class ThreadHeapAllocator
         {
         public:
@@ -20,50 +41,91 @@ namespace biome
             ~ThreadHeapAllocator();
 
             [[nodiscard]] 
-            static bool     Initialize(size_t heapByteSize, size_t initialCommitByteSize);
+            static bool     Initialize(size_t heapByteSize, size_t initialCommitByteSize, LargePageMode largePageMode = LargePageMode::None);
             [[nodiscard]]
             static bool     IsInitialized();
             static void     Shutdown();
-            static void*    Allocate(size_t byteSize);
+            static void*    Allocate(size_t byteSize, size_t alignment = SmallObjectAllocator::Alignment);
             static bool     WasAllocatedFromThisThread(void *pMemory);
             static bool     Release(void *pMemory);
             static size_t   AllocationSize(void *pMemory);
             static void     Defrag();
+            // Stats of the calling thread heap
+            static AllocatorStats GetStats();
 
         private:
 
             static constexpr size_t DefaultHeapByteSize = GiB(1);
             static constexpr size_t DefaultInitialCommitByteSize = MiB(100);
 
-            struct FreeRange
+            // Matches `TlsfIndex::InvalidIndex`
+            static constexpr uint32_t InvalidPageIndex = UINT32_MAX;
+            static constexpr uint32_t FreeRunFlag = 0x80000000u;
+
+            // Boundary tag stored for every page of the heap.
+            // `m_PageCount` is valid on the first and last page of each run and carries `FreeRunFlag`
+            // when the run is free. Free list links are only valid on the first page of a free run.
+            struct PageRun
+            {
+                uint32_t m_PageCount;
+                uint32_t m_NextFree;
+                uint32_t m_PreviousFree;
+            };
+
+            // Written over the first bytes of memory released from a thread that does not own it.
+            struct RemoteRelease
             {
-                uint32_t m_Index;
-                uint32_t m_Count;
+                RemoteRelease* m_pNext;
             };
 
-            static ThreadHeapAllocator* CreateAllocator(size_t heapByteSize, size_t initialCommitByteSize);
+            static ThreadHeapAllocator* CreateAllocator(size_t heapByteSize, size_t initialCommitByteSize, LargePageMode largePageMode);
+            static ThreadHeapAllocator* FindOwner(void *pMemory);
 
-            void*       AllocateInternal(size_t byteSize);
+            void*       AllocateInternal(size_t byteSize, size_t alignment);
+            void*       AllocateSmallInternal(size_t byteSize);
+            void*       AllocatePagesInternal(size_t byteSize);
             bool        WasAllocatedFromThisThreadInternal(void* pMemory);
             bool        ReleaseInternal(void *pMemory);
+            void        ReleasePagesInternal(void *pMemory);
             size_t      AllocationSizeInternal(void *pMemory);
             void        DefragInternal();
+            void        PushRemoteRelease(void *pMemory);
+            void        DrainRemoteReleases();
+            AllocatorStats GetStatsInternal() const;
+            uint32_t    LargestFreeRunPageCount() const;
 
             void        CommitMorePages(uint32_t pageCount);
             uint32_t    SearchFreePages(uint32_t pageCount);
+            void        InsertFreeRun(uint32_t pageIndex, uint32_t pageCount);
+            void        RemoveFreeRun(uint32_t pageIndex);
+            void        SetRunTags(uint32_t pageIndex, uint32_t pageCount, bool isFree);
+            uint32_t    RunPageCount(uint32_t pageIndex) const;
+            bool        IsRunFree(uint32_t pageIndex) const;
             void*       PageIndexToAddress(uint32_t index);
             uint32_t    AddressToPageIndex(void *pAddress);
 
             thread_local static ThreadHeapAllocator* s_pAllocator;
+            // Remote releases between their owner lookup and their push, see `Shutdown`
+            static std::atomic<uint32_t> s_PendingRemoteReleaseCount;
+
+            SmallObjectAllocator m_SmallObjects {};
 
             uintptr_t   m_MemoryPool { 0 };
-            FreeRange*  m_pFreeRanges { nullptr };
-            uint32_t*   m_pPages { nullptr };
+            PageRun*    m_pPages { nullptr };
             size_t      m_SystemPageSize { 0 };
             uint32_t    m_TotalPageCount { 0 };
+            uint32_t    m_InitialCommittedPageCount { 0 };
             uint32_t    m_CommittedPageCount { 0 };
             uint32_t    m_NextPageIndex { 0 };
-            uint32_t    m_FreeRangesCount { 0 };
+            size_t      m_UsedByteCount { 0 };
+            size_t      m_PeakUsedByteCount { 0 };
+            uint64_t    m_AllocationCount { 0 };
+            uint64_t    m_ReleaseCount { 0 };
+            LargePageMode m_LargePageMode { LargePageMode::None };
+
+            TlsfIndex<PageRun> m_FreeRuns {};
+
+            std::atomic<RemoteRelease*> m_pRemoteReleases { nullptr };
         };
     }
 }
\ No newline at end of file
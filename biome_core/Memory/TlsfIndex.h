@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace biome
+{
+    namespace memory
+    {
+        // Two-level segregated-fit (TLSF) index of free runs, shared by the page allocators.
+        //
+        // Runs are identified by the index of their first element and bucketed by their size:
+        // the first level is the power of two of the size, the second level splits it linearly.
+        // Sizes below `SecondLevelCount` get one exact bucket each. Bitmaps of the non-empty
+        // buckets make `FindFit` in O(1).
+        //
+        // The free lists are threaded through the caller's run array: `RunType` must have
+        // `m_NextFree` and `m_PreviousFree` members, which are only used while the run is indexed.
+        // The index does not know the run sizes, callers pass them to `Insert` and `Remove`.
+        //
+        template<typename RunType>
+        class TlsfIndex
+        {
+        public:
+
+            static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+            void        Initialize(RunType *pRuns);
+
+            void        Insert(uint32_t runIndex, uint32_t runSize);
+            void        Remove(uint32_t runIndex, uint32_t runSize);
+
+            // First run of the smallest bucket whose runs are all at least `runSize` large,
+            // `InvalidIndex` when there is none. The run stays in the index.
+            uint32_t    FindFit(uint32_t runSize) const;
+            // First run of the bucket `runSize` falls in, its runs may be smaller than `runSize`
+            uint32_t    FirstInBucket(uint32_t runSize) const;
+            // First run of the highest non-empty bucket, which holds the largest runs
+            uint32_t    FirstInLargestBucket() const;
+            uint32_t    NextInBucket(uint32_t runIndex) const { return m_pRuns[runIndex].m_NextFree; }
+
+            uint32_t    Count() const { return m_Count; }
+
+        private:
+
+            static constexpr uint32_t SecondLevelLog2 = 4;
+            static constexpr uint32_t SecondLevelCount = 1u << SecondLevelLog2;
+            static constexpr uint32_t FirstLevelCount = 32 - SecondLevelLog2 + 1;
+
+            static void MappingInsert(uint32_t runSize, uint32_t &firstLevel, uint32_t &secondLevel);
+            static void MappingSearch(uint32_t runSize, uint32_t &firstLevel, uint32_t &secondLevel);
+
+            RunType*    m_pRuns { nullptr };
+            uint32_t    m_Count { 0 };
+            uint32_t    m_FirstLevelBitmap { 0 };
+            uint32_t    m_SecondLevelBitmaps[FirstLevelCount] {};
+            uint32_t    m_Heads[FirstLevelCount][SecondLevelCount] {};
+        };
+    }
+}
+
+#include "TlsfIndex.inl"
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "TlsfIndex.h"
+#include <bit>
+
+using namespace biome::memory;
+
+template<typename RunType>
+void TlsfIndex<RunType>::Initialize(RunType *pRuns)
+{
+    m_pRuns = pRuns;
+    m_Count = 0;
+    m_FirstLevelBitmap = 0;
+
+    for (uint32_t firstLevel = 0; firstLevel < FirstLevelCount; ++firstLevel)
+    {
+        m_SecondLevelBitmaps[firstLevel] = 0;
+
+        for (uint32_t &head : m_Heads[firstLevel])
+        {
+            head = InvalidIndex;
+        }
+    }
+}
+
+template<typename RunType>
+void TlsfIndex<RunType>::Insert(uint32_t runIndex, uint32_t runSize)
+{
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    MappingInsert(runSize, firstLevel, secondLevel);
+
+    const uint32_t headIndex = m_Heads[firstLevel][secondLevel];
+    RunType &run = m_pRuns[runIndex];
+    run.m_NextFree = headIndex;
+    run.m_PreviousFree = InvalidIndex;
+
+    if (headIndex != InvalidIndex)
+    {
+        m_pRuns[headIndex].m_PreviousFree = runIndex;
+    }
+
+    m_Heads[firstLevel][secondLevel] = runIndex;
+    m_FirstLevelBitmap |= 1u << firstLevel;
+    m_SecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    ++m_Count;
+}
+
+template<typename RunType>
+void TlsfIndex<RunType>::Remove(uint32_t runIndex, uint32_t runSize)
+{
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    MappingInsert(runSize, firstLevel, secondLevel);
+
+    const RunType &run = m_pRuns[runIndex];
+
+    if (run.m_PreviousFree != InvalidIndex)
+    {
+        m_pRuns[run.m_PreviousFree].m_NextFree = run.m_NextFree;
+    }
+    else
+    {
+        m_Heads[firstLevel][secondLevel] = run.m_NextFree;
+
+        if (run.m_NextFree == InvalidIndex)
+        {
+            m_SecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (m_SecondLevelBitmaps[firstLevel] == 0)
+            {
+                m_FirstLevelBitmap &= ~(1u << firstLevel);
+            }
+        }
+    }
+
+    if (run.m_NextFree != InvalidIndex)
+    {
+        m_pRuns[run.m_NextFree].m_PreviousFree = run.m_PreviousFree;
+    }
+
+    --m_Count;
+}
+
+template<typename RunType>
+uint32_t TlsfIndex<RunType>::FindFit(uint32_t runSize) const
+{
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    MappingSearch(runSize, firstLevel, secondLevel);
+
+    uint32_t secondLevelMap = firstLevel < FirstLevelCount ? m_SecondLevelBitmaps[firstLevel] & (~0u << secondLevel) : 0;
+    if (secondLevelMap == 0)
+    {
+        const uint32_t firstLevelMap = (firstLevel + 1 < FirstLevelCount) ? m_FirstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+        if (firstLevelMap == 0)
+        {
+            return InvalidIndex;
+        }
+
+        firstLevel = std::countr_zero(firstLevelMap);
+        secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+    }
+
+    secondLevel = std::countr_zero(secondLevelMap);
+
+    return m_Heads[firstLevel][secondLevel];
+}
+
+template<typename RunType>
+uint32_t TlsfIndex<RunType>::FirstInBucket(uint32_t runSize) const
+{
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    MappingInsert(runSize, firstLevel, secondLevel);
+
+    return m_Heads[firstLevel][secondLevel];
+}
+
+template<typename RunType>
+uint32_t TlsfIndex<RunType>::FirstInLargestBucket() const
+{
+    if (m_FirstLevelBitmap == 0)
+    {
+        return InvalidIndex;
+    }
+
+    const uint32_t firstLevel = std::bit_width(m_FirstLevelBitmap) - 1;
+    const uint32_t secondLevel = std::bit_width(m_SecondLevelBitmaps[firstLevel]) - 1;
+
+    return m_Heads[firstLevel][secondLevel];
+}
+
+template<typename RunType>
+void TlsfIndex<RunType>::MappingInsert(uint32_t runSize, uint32_t &firstLevel, uint32_t &secondLevel)
+{
+    if (runSize < SecondLevelCount)
+    {
+        // Small runs get one exact bucket each
+        firstLevel = 0;
+        secondLevel = runSize;
+    }
+    else
+    {
+        const uint32_t mostSignificantBit = std::bit_width(runSize) - 1;
+        firstLevel = mostSignificantBit - SecondLevelLog2 + 1;
+        secondLevel = (runSize >> (mostSignificantBit - SecondLevelLog2)) ^ SecondLevelCount;
+    }
+}
+
+template<typename RunType>
+void TlsfIndex<RunType>::MappingSearch(uint32_t runSize, uint32_t &firstLevel, uint32_t &secondLevel)
+{
+    // Round up to the next bucket so any run found in it is large enough
+    if (runSize >= SecondLevelCount)
+    {
+        const uint32_t mostSignificantBit = std::bit_width(runSize) - 1;
+        runSize += (1u << (mostSignificantBit - SecondLevelLog2)) - 1;
+    }
+
+    MappingInsert(runSize, firstLevel, secondLevel);
+}
@@ -1,69 +1,112 @@
 #include <pch.h>
 #include <algorithm>
+#include <bit>
+#include <thread>
 #include "VirtualMemoryAllocator.h"
+#include "MemoryRegistry.h"
+#include "AllocationTrace.h"
 #include "SystemInfo/SystemInfo.h"
 
+#if PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
 using namespace biome::memory;
 using namespace biome::system;
 
+namespace
+{
+    constexpr uint32_t TagShift = 48;
+    constexpr uint64_t AddressMask = (uint64_t(1) << TagShift) - 1;
+
+    template<typename T>
+    T* UntagHead(uint64_t head)
+    {
+        return reinterpret_cast<T*>(head & AddressMask);
+    }
+
+    template<typename T>
+    uint64_t TagHead(uint64_t previousHead, T *pHead)
+    {
+        BIOME_ASSERT_MSG((reinterpret_cast<uint64_t>(pHead) & ~AddressMask) == 0, "VirtualMemoryAllocator: Address does not fit the tagged free bucket head");
+        return (((previousHead >> TagShift) + 1) << TagShift) | reinterpret_cast<uint64_t>(pHead);
+    }
+}
+
 VirtualMemoryAllocator VirtualMemoryAllocator::s_Allocator;
 
 VirtualMemoryAllocator::~VirtualMemoryAllocator()
 {
-    VMHeader *pHeader = m_FreeHead;
-    while (pHeader)
+    for (std::atomic<uint64_t> (&buckets)[FreeBucketCount] : m_FreeBuckets)
     {
-        VMHeader *pNext = pHeader->m_Next;
-        ForceReleaseToOS(pHeader);
-        pHeader = pNext;
+        for (std::atomic<uint64_t> &bucket : buckets)
+        {
+            while (VMHeader *pHeader = PopReleasedHeader(bucket))
+            {
+                ForceReleaseToOS(pHeader);
+            }
+        }
     }
-
-    m_FreeHead = m_FreeTail = nullptr;
 }
 
 VirtualMemoryAllocator::VirtualMemoryAllocator()
 {
     SystemInfo sysInfo = biome::system::GetSystemInfo();
     m_AllocationPageSize = sysInfo.m_AllocationPageSize;
+    m_AllocationGranularity = sysInfo.m_AllocationGranularity;
 }
 
-void* VirtualMemoryAllocator::Allocate(size_t byteSize, size_t commitByteSize, size_t alignment)
+void* VirtualMemoryAllocator::Allocate(size_t byteSize, size_t commitByteSize, size_t alignment, LargePageMode largePageMode)
 {
     BIOME_ASSERT_MSG(alignment <= s_Allocator.m_AllocationPageSize, "Unsupported alignment");
     BIOME_ASSERT_MSG(commitByteSize <= byteSize, "Invalid commit byte size");
-
-    std::unique_lock<std::mutex> lock(s_Allocator.m_Mutex);
+    BIOME_ASSERT_MSG(largePageMode < LargePageMode::Count, "Invalid large page mode");
 
     alignment = std::max(alignof(VMHeader), alignment);
     size_t requiredOverhead = Align(sizeof(VMHeader), alignment);
-    size_t alignedByteSize = Align(byteSize + requiredOverhead, s_Allocator.m_AllocationPageSize);
+    size_t reservationAlignment = largePageMode == LargePageMode::None ? s_Allocator.m_AllocationPageSize : LargePageSize;
+    size_t alignedByteSize = Align(byteSize + requiredOverhead, reservationAlignment);
     size_t alignedCommitByteSize = Align(commitByteSize + requiredOverhead, s_Allocator.m_AllocationPageSize);
 
     void *pMemory = nullptr;
-    VMHeader *pHeader = FindReleasedMemory(alignedByteSize);
+    VMHeader *pHeader = FindReleasedMemory(alignedByteSize, largePageMode);
 
     if (pHeader)
     {
         size_t allocationStartOffset = Align(sizeof(VMHeader), pHeader->m_Alignment) - sizeof(VMHeader);
         pMemory = reinterpret_cast<uint8_t*>(pHeader) - allocationStartOffset;
+
+        // The reused block keeps its full reservation so that it can be released to the OS as a whole
+        alignedByteSize = pHeader->m_Size;
     }
     else
     {
-        pMemory = NativeReserve(alignedByteSize);
+        pMemory = NativeReserve(alignedByteSize, largePageMode);
     }
 
-    NativeCommit(pMemory, alignedCommitByteSize);
+    BIOME_ASSERT_MSG(pMemory != nullptr, "VirtualMemoryAllocator::Allocate: Out of address space");
+
+    if (largePageMode != LargePageMode::Explicit)
+    {
+        NativeCommit(pMemory, alignedCommitByteSize);
+    }
 
     VMHeader *pReturnedAddress = reinterpret_cast<VMHeader*>(reinterpret_cast<uint8_t*>(pMemory) + requiredOverhead);
 
     VMHeader &header = *(pReturnedAddress - 1);
-    header.m_Next = nullptr;
+    header.m_Next.store(nullptr, std::memory_order_relaxed);
     header.m_Size = alignedByteSize;
     header.m_Alignment = alignment;
+    header.m_LargePageMode = largePageMode;
 #ifdef _DEBUG
     header.m_Marker = MARKER;
 #endif
 
+    RegisterOwner(pMemory, alignedByteSize, MemoryOwnerType::VirtualMemoryBlock, pReturnedAddress);
+
+    AddUsedBytes(alignedByteSize);
+    BIOME_TRACE_ALLOCATION(VirtualMemory, Allocate, pReturnedAddress, alignedByteSize);
+
     return pReturnedAddress;
 }
 
@@ -71,111 +114,211 @@ void VirtualMemoryAllocator::Release(void *pMemory)
 {
     BIOME_ASSERT(pMemory != nullptr);
 
-    std::unique_lock<std::mutex> lock(s_Allocator.m_Mutex);
-    
     VMHeader *pHeader = (reinterpret_cast<VMHeader*>(pMemory) - 1);
+    BIOME_ASSERT_MSG(pHeader->m_Marker != RELEASED_MARKER, "Releasing already released memory");
     BIOME_ASSERT_MSG(pHeader->m_Marker == MARKER, "Invalid address sent to VirtualMemoryAllocator::Release");
-    BIOME_ASSERT_MSG(pHeader->m_Next == nullptr, "Releasing already released memory");
-
-    if (s_Allocator.m_FreeTail)
-    {
-        s_Allocator.m_FreeTail->m_Next = pHeader;
-        s_Allocator.m_FreeTail = pHeader;
-    }
-    else
-    {
-        s_Allocator.m_FreeHead = s_Allocator.m_FreeTail = pHeader;
-    }
 
     // Decommit everything but the minimum required to keep the header alive
     size_t allocationStartOffset = Align(sizeof(VMHeader), pHeader->m_Alignment);
     size_t startAddr = reinterpret_cast<size_t>(reinterpret_cast<uint8_t*>(pMemory) - allocationStartOffset);
     size_t decommitAddr = Align(reinterpret_cast<size_t>(pMemory), s_Allocator.m_AllocationPageSize);
     size_t pinnedByteSize = decommitAddr - startAddr;
-    NativeDecommit(reinterpret_cast<void*>(decommitAddr), pHeader->m_Size - pinnedByteSize);
+    if (pHeader->m_LargePageMode != LargePageMode::Explicit)
+    {
+        NativeDecommit(reinterpret_cast<void*>(decommitAddr), pHeader->m_Size - pinnedByteSize);
+    }
+
+    UnregisterOwner(reinterpret_cast<void*>(startAddr), pHeader->m_Size);
+
+    s_Allocator.m_UsedByteCount.fetch_sub(pHeader->m_Size, std::memory_order_relaxed);
+    s_Allocator.m_ReleaseCount.fetch_add(1, std::memory_order_relaxed);
+    BIOME_TRACE_ALLOCATION(VirtualMemory, Release, pMemory, pHeader->m_Size);
+
+#ifdef _DEBUG
+    pHeader->m_Marker = RELEASED_MARKER;
+#endif
+
+    // The block can be reused by another thread as soon as it is published
+    PushReleasedHeader(pHeader);
 }
 
 void VirtualMemoryAllocator::ForceReleaseToOS(void *pMemory)
 {
-    std::unique_lock<std::mutex> lock(s_Allocator.m_Mutex);
-
-    VMHeader header = *(reinterpret_cast<VMHeader*>(pMemory) - 1);
+    VMHeader &header = *(reinterpret_cast<VMHeader*>(pMemory) - 1);
     size_t allocationStartOffset = Align(sizeof(VMHeader), header.m_Alignment);
     void *pAllocationAddress = reinterpret_cast<uint8_t*>(pMemory) - allocationStartOffset;
+    size_t byteSize = header.m_Size;
 
+    BIOME_ASSERT_MSG(header.m_Marker != RELEASED_MARKER, "Releasing already released memory");
     BIOME_ASSERT_MSG(header.m_Marker == MARKER, "Invalid address sent to VirtualMemoryAllocator::Release");
-    BIOME_ASSERT_MSG(header.m_Next == nullptr, "Releasing already released memory");
 
-    NativeRelease(pAllocationAddress);
+    UnregisterOwner(pAllocationAddress, byteSize);
+
+    s_Allocator.m_UsedByteCount.fetch_sub(byteSize, std::memory_order_relaxed);
+    s_Allocator.m_ReleaseCount.fetch_add(1, std::memory_order_relaxed);
+    BIOME_TRACE_ALLOCATION(VirtualMemory, Release, pMemory, byteSize);
+
+    // A thread that loaded this header from a free bucket before it was reused may still be about
+    // to read its `m_Next`. Wait for in-flight pops to retire before unmapping the header.
+    // Pairs with the fence in FindReleasedMemory: either the pop sees the header gone from its
+    // bucket, or its pending count is seen here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (s_Allocator.m_PendingPopCount.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    NativeRelease(pAllocationAddress, byteSize);
+}
+
+LargePageMode VirtualMemoryAllocator::GetLargePageMode(void *pMemory)
+{
+    const VMHeader &header = *(reinterpret_cast<VMHeader*>(pMemory) - 1);
+    BIOME_ASSERT_MSG(header.m_Marker == MARKER, "Invalid address sent to VirtualMemoryAllocator::GetLargePageMode");
+
+    return header.m_LargePageMode;
+}
+
+AllocatorStats VirtualMemoryAllocator::GetStats()
+{
+    AllocatorStats stats {};
+    stats.m_ReservedByteCount = s_Allocator.m_ReservedByteCount.load(std::memory_order_relaxed);
+    stats.m_UsedByteCount = s_Allocator.m_UsedByteCount.load(std::memory_order_relaxed);
+    stats.m_PeakUsedByteCount = s_Allocator.m_PeakUsedByteCount.load(std::memory_order_relaxed);
+    stats.m_AllocationCount = s_Allocator.m_AllocationCount.load(std::memory_order_relaxed);
+    stats.m_ReleaseCount = s_Allocator.m_ReleaseCount.load(std::memory_order_relaxed);
+
+    for (uint32_t bucketIndex = 0; bucketIndex < FreeBucketCount; ++bucketIndex)
+    {
+        const uint32_t blockCount = s_Allocator.m_FreeBlockCounts[bucketIndex].load(std::memory_order_relaxed);
+        if (blockCount > 0)
+        {
+            stats.m_FreeRangeCount += blockCount;
+            stats.m_LargestFreeBlockByteCount = size_t(1) << bucketIndex;
+        }
+    }
+
+    return stats;
 }
 
 void VirtualMemoryAllocator::Commit(void *pMemory, size_t size)
 {
-    std::unique_lock<std::mutex> lock(s_Allocator.m_Mutex);
     NativeCommit(pMemory, size);
 }
 
 void VirtualMemoryAllocator::Decommit(void *pMemory, size_t size)
 {
-    std::unique_lock<std::mutex> lock(s_Allocator.m_Mutex);
     NativeDecommit(pMemory, size);
 }
 
 void VirtualMemoryAllocator::ForceReleaseToOS(VMHeader *pHeader)
 {
-    BIOME_ASSERT_MSG(pHeader->m_Marker == MARKER, "Invalid address sent to VirtualMemoryAllocator::Release");
+    BIOME_ASSERT_MSG(pHeader->m_Marker == RELEASED_MARKER, "Invalid address sent to VirtualMemoryAllocator::Release");
 
     uint8_t *pMemory = reinterpret_cast<uint8_t*>(pHeader + 1);
     size_t allocationStartOffset = Align(sizeof(VMHeader), pHeader->m_Alignment);
     void *pAllocationAddress = pMemory - allocationStartOffset;
 
-    NativeRelease(pAllocationAddress);
+    NativeRelease(pAllocationAddress, pHeader->m_Size);
 }
 
-VirtualMemoryAllocator::VMHeader* VirtualMemoryAllocator::FindReleasedMemory(size_t byteSize)
+VirtualMemoryAllocator::VMHeader* VirtualMemoryAllocator::FindReleasedMemory(size_t byteSize, LargePageMode largePageMode)
 {
-    VMHeader *pPreviousHeader = nullptr;
-    VMHeader *pHeader = s_Allocator.m_FreeHead;
+    s_Allocator.m_PendingPopCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
 
-    if (pHeader)
+    // Only the bucket of the requested size and the next one can hold blocks of at most
+    // `MaxReuseSizeRatio` times the requested size. A block that does not fit goes back on top of its bucket.
+    const uint32_t firstBucketIndex = FreeBucketIndex(byteSize);
+    const uint32_t lastBucketIndex = std::min(firstBucketIndex + 1, FreeBucketCount - 1);
+    VMHeader *pHeader = nullptr;
+
+    for (uint32_t bucketIndex = firstBucketIndex; pHeader == nullptr && bucketIndex <= lastBucketIndex; ++bucketIndex)
     {
-        if (pHeader->m_Size >= byteSize)
+        pHeader = PopReleasedHeader(FreeBucket(bucketIndex, largePageMode));
+
+        if (pHeader && (pHeader->m_Size < byteSize || pHeader->m_Size > byteSize * MaxReuseSizeRatio))
         {
-            s_Allocator.m_FreeHead = pHeader->m_Next;
+            PushReleasedHeader(pHeader);
+            pHeader = nullptr;
         }
-        else
-        {
-            pPreviousHeader = pHeader;
-            pHeader = pHeader->m_Next;
+    }
 
-            while (pHeader)
-            {
-                if (pHeader->m_Size >= byteSize)
-                {
-                    pPreviousHeader->m_Next = pHeader->m_Next;
-                    pHeader->m_Next = nullptr;
-                    break;
-                }
-                else
-                {
-                    pPreviousHeader = pHeader;
-                    pHeader = pHeader->m_Next;
-                }
-            }
-        }
+    s_Allocator.m_PendingPopCount.fetch_sub(1, std::memory_order_release);
 
-        if (s_Allocator.m_FreeTail == pHeader)
+    return pHeader;
+}
+
+void VirtualMemoryAllocator::PushReleasedHeader(VMHeader *pHeader)
+{
+    std::atomic<uint64_t> &bucket = FreeBucket(FreeBucketIndex(pHeader->m_Size), pHeader->m_LargePageMode);
+    uint64_t head = bucket.load(std::memory_order_relaxed);
+
+    s_Allocator.m_FreeBlockCounts[FreeBucketIndex(pHeader->m_Size)].fetch_add(1, std::memory_order_relaxed);
+
+    do
+    {
+        pHeader->m_Next.store(UntagHead<VMHeader>(head), std::memory_order_relaxed);
+    }
+    while (!bucket.compare_exchange_weak(head, TagHead(head, pHeader), std::memory_order_release, std::memory_order_relaxed));
+}
+
+VirtualMemoryAllocator::VMHeader* VirtualMemoryAllocator::PopReleasedHeader(std::atomic<uint64_t> &bucket)
+{
+    uint64_t head = bucket.load(std::memory_order_acquire);
+
+    while (VMHeader *pHeader = UntagHead<VMHeader>(head))
+    {
+        // May read a header that was popped and reused meanwhile, the tag then fails the exchange
+        VMHeader *pNext = pHeader->m_Next.load(std::memory_order_relaxed);
+
+        if (bucket.compare_exchange_weak(head, TagHead(head, pNext), std::memory_order_acquire, std::memory_order_acquire))
         {
-            s_Allocator.m_FreeTail = pPreviousHeader;
+            s_Allocator.m_FreeBlockCounts[FreeBucketIndex(pHeader->m_Size)].fetch_sub(1, std::memory_order_relaxed);
+            return pHeader;
         }
     }
-    
-    return pHeader;
+
+    return nullptr;
+}
+
+std::atomic<uint64_t>& VirtualMemoryAllocator::FreeBucket(uint32_t bucketIndex, LargePageMode largePageMode)
+{
+    return s_Allocator.m_FreeBuckets[static_cast<uint32_t>(largePageMode)][bucketIndex];
+}
+
+uint32_t VirtualMemoryAllocator::FreeBucketIndex(size_t byteSize)
+{
+    return static_cast<uint32_t>(std::bit_width(byteSize)) - 1;
 }
 
-void* VirtualMemoryAllocator::NativeReserve(size_t byteSize)
+void VirtualMemoryAllocator::AddUsedBytes(size_t byteSize)
 {
-    return VirtualAlloc(NULL, byteSize, MEM_RESERVE, PAGE_READWRITE);
+    const size_t usedByteCount = s_Allocator.m_UsedByteCount.fetch_add(byteSize, std::memory_order_relaxed) + byteSize;
+    size_t peakUsedByteCount = s_Allocator.m_PeakUsedByteCount.load(std::memory_order_relaxed);
+
+    while (peakUsedByteCount < usedByteCount &&
+        !s_Allocator.m_PeakUsedByteCount.compare_exchange_weak(peakUsedByteCount, usedByteCount, std::memory_order_relaxed))
+    {
+    }
+
+    s_Allocator.m_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if PLATFORM_WINDOWS
+
+void* VirtualMemoryAllocator::NativeReserve(size_t byteSize, LargePageMode &largePageMode)
+{
+    largePageMode = LargePageMode::None;
+
+    void *pMemory = VirtualAlloc(NULL, byteSize, MEM_RESERVE, PAGE_READWRITE);
+    if (pMemory)
+    {
+        s_Allocator.m_ReservedByteCount.fetch_add(byteSize, std::memory_order_relaxed);
+    }
+
+    return pMemory;
 }
 
 void VirtualMemoryAllocator::NativeCommit(void* pMemory, size_t size)
@@ -188,7 +331,81 @@ void VirtualMemoryAllocator::NativeDecommit(void* pMemory, size_t size)
     VirtualFree(pMemory, size, MEM_DECOMMIT);
 }
 
-void VirtualMemoryAllocator::NativeRelease(void* pMemory)
+void VirtualMemoryAllocator::NativeRelease(void* pMemory, size_t size)
 {
     VirtualFree(pMemory, 0, MEM_RELEASE);
+    s_Allocator.m_ReservedByteCount.fetch_sub(size, std::memory_order_relaxed);
+}
+
+#elif PLATFORM_LINUX
+
+void* VirtualMemoryAllocator::NativeReserve(size_t byteSize, LargePageMode &largePageMode)
+{
+    if (largePageMode == LargePageMode::Explicit)
+    {
+        // hugetlbfs mappings are naturally aligned on the huge page size. Without MAP_NORESERVE the
+        // whole range is taken from the pool upfront, so an exhausted pool fails here instead of
+        // raising SIGBUS on first touch.
+        void *pMemory = mmap(nullptr, byteSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (pMemory != MAP_FAILED)
+        {
+            s_Allocator.m_ReservedByteCount.fetch_add(byteSize, std::memory_order_relaxed);
+            return pMemory;
+        }
+
+        largePageMode = LargePageMode::Transparent;
+    }
+
+    // Over-reserve to align the range on the allocation granularity, like VirtualAlloc does,
+    // so that two reservations never share a MemoryRegistry granule.
+    size_t alignment = largePageMode == LargePageMode::None ? s_Allocator.m_AllocationGranularity : LargePageSize;
+    size_t paddedByteSize = byteSize + alignment;
+
+    uint8_t *pReservation = static_cast<uint8_t*>(mmap(nullptr, paddedByteSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+    if (pReservation == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    uint8_t *pMemory = reinterpret_cast<uint8_t*>(Align(reinterpret_cast<size_t>(pReservation), alignment));
+    size_t headByteSize = pMemory - pReservation;
+    size_t tailByteSize = paddedByteSize - headByteSize - byteSize;
+
+    if (headByteSize > 0)
+    {
+        munmap(pReservation, headByteSize);
+    }
+
+    if (tailByteSize > 0)
+    {
+        munmap(pMemory + byteSize, tailByteSize);
+    }
+
+    if (largePageMode == LargePageMode::Transparent)
+    {
+        madvise(pMemory, byteSize, MADV_HUGEPAGE);
+    }
+
+    s_Allocator.m_ReservedByteCount.fetch_add(byteSize, std::memory_order_relaxed);
+
+    return pMemory;
 }
+
+void VirtualMemoryAllocator::NativeCommit(void* pMemory, size_t size)
+{
+    mprotect(pMemory, size, PROT_READ | PROT_WRITE);
+}
+
+void VirtualMemoryAllocator::NativeDecommit(void* pMemory, size_t size)
+{
+    madvise(pMemory, size, MADV_DONTNEED);
+    mprotect(pMemory, size, PROT_NONE);
+}
+
+void VirtualMemoryAllocator::NativeRelease(void* pMemory, size_t size)
+{
+    munmap(pMemory, size);
+    s_Allocator.m_ReservedByteCount.fetch_sub(size, std::memory_order_relaxed);
+}
+
+#endif
@@ -1,54 +1,106 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include "biome_core/Memory/AllocatorStats.h"
 
 namespace biome
 {
     namespace memory
     {
+        // Opt-in large page backing for big reservations, such as the thread heaps.
+        //
+        // Transparent asks the kernel to back the range with transparent huge pages when it can.
+        // Explicit maps the range from the hugetlbfs pool, falling back to Transparent when the
+        // pool is empty. Explicit pages are resident from the first touch until the block is
+        // released to the OS: Commit and Decommit must not be called on them.
+        // Both modes are ignored on Windows, where large pages need SeLockMemoryPrivilege and
+        // cannot be reserved without being committed.
+        //
+        enum class LargePageMode : uint8_t
+        {
+            None,
+            Transparent,
+            Explicit,
+            Count
+        };
+
+        // Reserves, commits and releases blocks of virtual memory.
+        //
+        // Released blocks are kept reserved for reuse in lock-free stacks bucketed by the power of two
+        // of their size, so that Allocate and Release never take a lock. A released block is only
+        // reused for requests of at least half its size, so that small requests don't pin large blocks.
+        //
         class VirtualMemoryAllocator
         {
         public:
 
-            static void* Allocate(size_t byteSize, size_t commitByteSize, size_t alignment = sizeof(uintptr_t));
+            static constexpr size_t LargePageSize = size_t(2) * 1024 * 1024;
+
+            static void* Allocate(size_t byteSize, size_t commitByteSize, size_t alignment = sizeof(uintptr_t), LargePageMode largePageMode = LargePageMode::None);
             static void Commit(void *pMemory, size_t size);
             static void Decommit(void *pMemory, size_t size);
             static void Release(void *pMemory);
             static void ForceReleaseToOS(void *pMemory);
+            static LargePageMode GetLargePageMode(void *pMemory);
+
+            // Used bytes are the full reservations of live blocks. Free ranges are the released blocks
+            // kept for reuse, and the largest one is reported as the lower bound of its size bucket.
+            // Committed bytes are left to the owners that commit, such as the thread heaps.
+            static AllocatorStats GetStats();
 
             static uint32_t GetSystemPageSize() { return s_Allocator.m_AllocationPageSize; }
 
         private:
 
             static constexpr size_t MARKER = size_t(0xDEADBEEFBADDEED1);
+            static constexpr size_t RELEASED_MARKER = size_t(0xDEADBEEFBADDEED2);
+            static constexpr uint32_t FreeBucketCount = 64;
+            static constexpr uint32_t LargePageModeCount = static_cast<uint32_t>(LargePageMode::Count);
+            static constexpr size_t MaxReuseSizeRatio = 2;
 
             struct alignas(sizeof(size_t)) VMHeader
             {
-                VMHeader*   m_Next { nullptr };
+                std::atomic<VMHeader*> m_Next { nullptr };
                 size_t      m_Size { 0 };
                 size_t      m_Alignment { 0 };
+                LargePageMode m_LargePageMode { LargePageMode::None };
             #ifdef _DEBUG
                 size_t      m_Marker { MARKER };
             #endif
             };
 
-            static VMHeader* FindReleasedMemory(size_t byteSize);
+            static VMHeader* FindReleasedMemory(size_t byteSize, LargePageMode largePageMode);
             static void ForceReleaseToOS(VMHeader *pHeader);
+            static void PushReleasedHeader(VMHeader *pHeader);
+            static VMHeader* PopReleasedHeader(std::atomic<uint64_t> &bucket);
+            static std::atomic<uint64_t>& FreeBucket(uint32_t bucketIndex, LargePageMode largePageMode);
+            static uint32_t FreeBucketIndex(size_t byteSize);
+            static void AddUsedBytes(size_t byteSize);
 
-            static void* NativeReserve(size_t byteSize);
+            // Updates `largePageMode` to the mode the platform actually reserved the range with
+            static void* NativeReserve(size_t byteSize, LargePageMode &largePageMode);
             static void NativeCommit(void *pMemory, size_t size);
             static void NativeDecommit(void *pMemory, size_t size);
-            static void NativeRelease(void *pMemory);
+            static void NativeRelease(void *pMemory, size_t size);
 
             static VirtualMemoryAllocator s_Allocator;
 
             VirtualMemoryAllocator();
             ~VirtualMemoryAllocator();
 
-            VMHeader*   m_FreeHead { nullptr };
-            VMHeader*   m_FreeTail { nullptr };
-            std::mutex  m_Mutex {};
-            uint32_t    m_AllocationPageSize { 0 };
+            // Bucket heads are a header address tagged in its upper bits with a counter against ABA
+            std::atomic<uint64_t>   m_FreeBuckets[LargePageModeCount][FreeBucketCount] {};
+            // Number of threads that may be reading a released header, see ForceReleaseToOS
+            std::atomic<uint32_t>   m_PendingPopCount { 0 };
+            // Released block count per size bucket, all large page modes included
+            std::atomic<uint32_t>   m_FreeBlockCounts[FreeBucketCount] {};
+            std::atomic<size_t>     m_ReservedByteCount { 0 };
+            std::atomic<size_t>     m_UsedByteCount { 0 };
+            std::atomic<size_t>     m_PeakUsedByteCount { 0 };
+            std::atomic<uint64_t>   m_AllocationCount { 0 };
+            std::atomic<uint64_t>   m_ReleaseCount { 0 };
+            uint32_t                m_AllocationPageSize { 0 };
+            uint32_t                m_AllocationGranularity { 0 };
         };
     }
 }
@@ -1,8 +1,34 @@
 #include <pch.h>
 #include "SystemInfo.h"
 
+#if PLATFORM_LINUX
+    #include <unistd.h>
+#endif
+
 using namespace biome::system;
 
+static void InitFlatTopology(CpuTopology &topology, uint32_t logicalCoreCount)
+{
+    topology = {};
+    topology.m_LogicalCoreCount = std::min(logicalCoreCount, MaxTopologyLogicalCoreCount);
+    topology.m_PhysicalCoreCount = topology.m_LogicalCoreCount;
+    topology.m_NumaNodeCount = 1;
+    topology.m_LastLevelCacheCount = 1;
+    topology.m_CacheLineByteSize = 64;
+
+    for (uint32_t index = 0; index < topology.m_LogicalCoreCount; ++index)
+    {
+        topology.m_LogicalCores[index] = LogicalCoreInfo { index, 0, 0 };
+    }
+}
+
+static uint64_t GetLogicalCoreMask(const CpuTopology &topology)
+{
+    return topology.m_LogicalCoreCount >= 64 ? ~uint64_t(0) : (uint64_t(1) << topology.m_LogicalCoreCount) - 1;
+}
+
+#if PLATFORM_WINDOWS
+
 static CPUArchitecture Convert(WORD arch)
 {
     switch (arch)
@@ -30,3 +56,319 @@ SystemInfo biome::system::GetSystemInfo()
 
     return info;
 }
+
+CpuTopology biome::system::GetCpuTopology()
+{
+    CpuTopology topology;
+    InitFlatTopology(topology, GetSystemInfo().m_LogicalCpuCoreCount);
+
+    // Holds the relations of a few hundred logical cores, no heap needed
+    alignas(SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX) uint8_t buffer[KiB(32)];
+    DWORD byteSize = sizeof(buffer);
+
+    if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer), &byteSize))
+    {
+        return topology;
+    }
+
+    // Only processor group 0 is described, it holds at most 64 logical cores
+    const uint64_t validMask = GetLogicalCoreMask(topology);
+    uint32_t physicalCoreCount = 0;
+    uint32_t numaNodeCount = 0;
+    uint32_t lastLevelCacheCount = 0;
+    BYTE lastCacheLevel = 0;
+
+    for (DWORD offset = 0; offset < byteSize;)
+    {
+        const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& info = *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer + offset);
+        offset += info.Size;
+
+        const GROUP_AFFINITY* pGroupMask = nullptr;
+
+        switch (info.Relationship)
+        {
+        case RelationProcessorCore:
+            pGroupMask = &info.Processor.GroupMask[0];
+            break;
+        case RelationNumaNode:
+            pGroupMask = &info.NumaNode.GroupMask;
+            break;
+        case RelationCache:
+            if (info.Cache.Type == CacheInstruction || info.Cache.Level < lastCacheLevel)
+            {
+                continue;
+            }
+            if (info.Cache.Level > lastCacheLevel)
+            {
+                // A deeper cache level, restart numbering from it
+                lastCacheLevel = info.Cache.Level;
+                lastLevelCacheCount = 0;
+                topology.m_LastLevelCacheByteSize = info.Cache.CacheSize;
+                topology.m_CacheLineByteSize = info.Cache.LineSize;
+            }
+            pGroupMask = &info.Cache.GroupMask;
+            break;
+        default:
+            continue;
+        }
+
+        const uint64_t mask = pGroupMask->Group == 0 ? static_cast<uint64_t>(pGroupMask->Mask) & validMask : 0;
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        for (uint32_t index = 0; index < topology.m_LogicalCoreCount; ++index)
+        {
+            if ((mask & (uint64_t(1) << index)) == 0)
+            {
+                continue;
+            }
+
+            LogicalCoreInfo& core = topology.m_LogicalCores[index];
+            switch (info.Relationship)
+            {
+            case RelationProcessorCore: core.m_PhysicalCoreIndex = physicalCoreCount; break;
+            case RelationNumaNode: core.m_NumaNodeIndex = numaNodeCount; break;
+            default: core.m_LastLevelCacheIndex = lastLevelCacheCount; break;
+            }
+        }
+
+        switch (info.Relationship)
+        {
+        case RelationProcessorCore: ++physicalCoreCount; break;
+        case RelationNumaNode: ++numaNodeCount; break;
+        default: ++lastLevelCacheCount; break;
+        }
+    }
+
+    topology.m_PhysicalCoreCount = std::max(physicalCoreCount, 1u);
+    topology.m_NumaNodeCount = std::max(numaNodeCount, 1u);
+    topology.m_LastLevelCacheCount = std::max(lastLevelCacheCount, 1u);
+
+    return topology;
+}
+
+#elif PLATFORM_LINUX
+
+SystemInfo biome::system::GetSystemInfo()
+{
+    SystemInfo info;
+
+    // Linux maps at page granularity. Use the same 64 KiB reservation granularity as Windows
+    // so the memory registry can keep one owner per granule on both platforms.
+    info.m_AllocationGranularity = static_cast<uint32_t>(KiB(64));
+    info.m_AllocationPageSize = static_cast<uint32_t>(sysconf(_SC_PAGESIZE));
+    info.m_LogicalCpuCoreCount = static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_ONLN));
+
+#if defined(__x86_64__)
+    info.m_CpuArchitecture = CPUArchitecture::x64;
+#elif defined(__aarch64__)
+    info.m_CpuArchitecture = CPUArchitecture::ARM64;
+#else
+    info.m_CpuArchitecture = CPUArchitecture::Unsupported;
+#endif
+
+    return info;
+}
+
+// Reads the first line of a sysfs file
+static bool ReadSysFile(char *pBuffer, size_t bufferSize, const char *pPathFormat, uint32_t index0, uint32_t index1 = 0)
+{
+    char path[256];
+    snprintf(path, sizeof(path), pPathFormat, index0, index1);
+
+    FILE* pFile = fopen(path, "r");
+    if (pFile == nullptr)
+    {
+        return false;
+    }
+
+    const bool hasRead = fgets(pBuffer, static_cast<int>(bufferSize), pFile) != nullptr;
+    fclose(pFile);
+    return hasRead;
+}
+
+// Parses a cpu list such as "0-3,8,10-11"
+static uint64_t ParseCpuList(const char *pList)
+{
+    uint64_t mask = 0;
+
+    while (*pList >= '0' && *pList <= '9')
+    {
+        char* pEnd = nullptr;
+        const unsigned long first = strtoul(pList, &pEnd, 10);
+        unsigned long last = first;
+
+        if (*pEnd == '-')
+        {
+            last = strtoul(pEnd + 1, &pEnd, 10);
+        }
+
+        for (unsigned long cpu = first; cpu <= last && cpu < 64; ++cpu)
+        {
+            mask |= uint64_t(1) << cpu;
+        }
+
+        pList = *pEnd == ',' ? pEnd + 1 : pEnd;
+    }
+
+    return mask;
+}
+
+// Returns the index of `key` in `pKeys`, adding it if needed
+static uint32_t FindOrAddKey(uint64_t *pKeys, uint32_t &keyCount, uint64_t key)
+{
+    for (uint32_t index = 0; index < keyCount; ++index)
+    {
+        if (pKeys[index] == key)
+        {
+            return index;
+        }
+    }
+
+    pKeys[keyCount] = key;
+    return keyCount++;
+}
+
+CpuTopology biome::system::GetCpuTopology()
+{
+    CpuTopology topology;
+    InitFlatTopology(topology, GetSystemInfo().m_LogicalCpuCoreCount);
+
+    char line[256];
+    uint64_t keys[MaxTopologyLogicalCoreCount];
+
+    // Physical cores, identified by package and core id
+    uint32_t physicalCoreCount = 0;
+    for (uint32_t cpu = 0; cpu < topology.m_LogicalCoreCount; ++cpu)
+    {
+        if (!ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu))
+        {
+            physicalCoreCount = 0;
+            break;
+        }
+
+        const uint64_t coreId = strtoull(line, nullptr, 10);
+        const uint64_t packageId = ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu) ? strtoull(line, nullptr, 10) : 0;
+        topology.m_LogicalCores[cpu].m_PhysicalCoreIndex = FindOrAddKey(keys, physicalCoreCount, (packageId << 32) | coreId);
+    }
+
+    // NUMA nodes, node ids can be sparse
+    uint32_t numaNodeCount = 0;
+    for (uint32_t node = 0; node < MaxTopologyLogicalCoreCount; ++node)
+    {
+        if (ReadSysFile(line, sizeof(line), "/sys/devices/system/node/node%u/cpulist", node))
+        {
+            const uint64_t mask = ParseCpuList(line) & GetLogicalCoreMask(topology);
+            for (uint32_t cpu = 0; cpu < topology.m_LogicalCoreCount; ++cpu)
+            {
+                if (mask & (uint64_t(1) << cpu))
+                {
+                    topology.m_LogicalCores[cpu].m_NumaNodeIndex = numaNodeCount;
+                }
+            }
+
+            ++numaNodeCount;
+        }
+    }
+
+    // Last level cache, the deepest data or unified cache of cpu 0
+    uint32_t lastCacheIndex = UINT32_MAX;
+    uint32_t lastCacheLevel = 0;
+    for (uint32_t cacheIndex = 0; ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", 0, cacheIndex); ++cacheIndex)
+    {
+        const uint32_t level = static_cast<uint32_t>(strtoul(line, nullptr, 10));
+        const bool isInstructionCache = ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/cache/index%u/type", 0, cacheIndex) && strncmp(line, "Instruction", 11) == 0;
+
+        if (!isInstructionCache && level > lastCacheLevel)
+        {
+            lastCacheLevel = level;
+            lastCacheIndex = cacheIndex;
+        }
+    }
+
+    uint32_t lastLevelCacheCount = 0;
+    if (lastCacheIndex != UINT32_MAX)
+    {
+        if (ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/cache/index%u/size", 0, lastCacheIndex))
+        {
+            char* pUnit = nullptr;
+            const size_t size = strtoull(line, &pUnit, 10);
+            topology.m_LastLevelCacheByteSize = *pUnit == 'K' ? KiB(size) : *pUnit == 'M' ? MiB(size) : size;
+        }
+
+        if (ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/cache/index%u/coherency_line_size", 0, lastCacheIndex))
+        {
+            topology.m_CacheLineByteSize = static_cast<uint32_t>(strtoul(line, nullptr, 10));
+        }
+
+        // Cpus sharing a cache report the same list, key caches by it
+        for (uint32_t cpu = 0; cpu < topology.m_LogicalCoreCount; ++cpu)
+        {
+            if (!ReadSysFile(line, sizeof(line), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", cpu, lastCacheIndex))
+            {
+                lastLevelCacheCount = 0;
+                break;
+            }
+
+            topology.m_LogicalCores[cpu].m_LastLevelCacheIndex = FindOrAddKey(keys, lastLevelCacheCount, ParseCpuList(line));
+        }
+    }
+
+    // Fall back to the flat layout for the levels which could not be read
+    for (uint32_t cpu = 0; cpu < topology.m_LogicalCoreCount; ++cpu)
+    {
+        LogicalCoreInfo& core = topology.m_LogicalCores[cpu];
+        core.m_PhysicalCoreIndex = physicalCoreCount > 0 ? core.m_PhysicalCoreIndex : cpu;
+        core.m_LastLevelCacheIndex = lastLevelCacheCount > 0 ? core.m_LastLevelCacheIndex : 0;
+    }
+
+    topology.m_PhysicalCoreCount = physicalCoreCount > 0 ? physicalCoreCount : topology.m_LogicalCoreCount;
+    topology.m_NumaNodeCount = std::max(numaNodeCount, 1u);
+    topology.m_LastLevelCacheCount = std::max(lastLevelCacheCount, 1u);
+
+    return topology;
+}
+
+#endif
+
+uint64_t biome::system::GetPhysicalCoreAffinityMask(const CpuTopology &topology, uint32_t firstPhysicalCore, uint32_t physicalCoreCount, bool includeSmtSiblings)
+{
+    uint64_t mask = 0;
+    uint64_t coveredPhysicalCores = 0;
+
+    for (uint32_t index = 0; index < topology.m_LogicalCoreCount; ++index)
+    {
+        const uint32_t physicalCore = topology.m_LogicalCores[index].m_PhysicalCoreIndex;
+
+        if (physicalCore < firstPhysicalCore || physicalCore - firstPhysicalCore >= physicalCoreCount)
+        {
+            continue;
+        }
+
+        const uint64_t physicalCoreBit = uint64_t(1) << (physicalCore % 64);
+        if (includeSmtSiblings || (coveredPhysicalCores & physicalCoreBit) == 0)
+        {
+            mask |= uint64_t(1) << index;
+            coveredPhysicalCores |= physicalCoreBit;
+        }
+    }
+
+    return mask;
+}
+
+uint64_t biome::system::GetNumaNodeAffinityMask(const CpuTopology &topology, uint32_t numaNodeIndex)
+{
+    uint64_t mask = 0;
+
+    for (uint32_t index = 0; index < topology.m_LogicalCoreCount; ++index)
+    {
+        if (topology.m_LogicalCores[index].m_NumaNodeIndex == numaNodeIndex)
+        {
+            mask |= uint64_t(1) << index;
+        }
+    }
+
+    return mask;
+}
@@ -23,5 +23,39 @@ namespace biome
         };
 
         SystemInfo GetSystemInfo();
+
+        // Logical cores beyond this count are left out of the topology, which also matches the
+        // width of the affinity masks
+        constexpr uint32_t MaxTopologyLogicalCoreCount = 64;
+
+        struct LogicalCoreInfo
+        {
+            uint32_t m_PhysicalCoreIndex;
+            uint32_t m_NumaNodeIndex;
+            uint32_t m_LastLevelCacheIndex;
+        };
+
+        // Processor topology, logical cores are indexed by their bit in affinity masks.
+        // Physical cores, NUMA nodes and last level caches are numbered from 0 in the order the
+        // OS reports them. When a level can't be queried, each logical core is reported as its
+        // own physical core, on NUMA node 0 and behind last level cache 0.
+        //
+        struct CpuTopology
+        {
+            LogicalCoreInfo m_LogicalCores[MaxTopologyLogicalCoreCount];
+            uint32_t        m_LogicalCoreCount;
+            uint32_t        m_PhysicalCoreCount;
+            uint32_t        m_NumaNodeCount;
+            uint32_t        m_LastLevelCacheCount;
+            uint32_t        m_CacheLineByteSize;
+            size_t          m_LastLevelCacheByteSize;
+        };
+
+        CpuTopology GetCpuTopology();
+
+        // Logical cores of physical cores [firstPhysicalCore, firstPhysicalCore + physicalCoreCount).
+        // Without `includeSmtSiblings`, only the first logical core of each physical core is kept.
+        uint64_t GetPhysicalCoreAffinityMask(const CpuTopology &topology, uint32_t firstPhysicalCore, uint32_t physicalCoreCount, bool includeSmtSiblings);
+        uint64_t GetNumaNodeAffinityMask(const CpuTopology &topology, uint32_t numaNodeIndex);
     }
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Threading/SpinWait.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        // Bounded multi-producer multi-consumer FIFO queue, Dmitry Vyukov's design.
+        //
+        // Every cell carries a sequence number telling whether it is ready to be written or
+        // read for the current lap around the buffer. Producers and consumers claim a position
+        // with a single compare-exchange on their own counter, then publish the cell by storing
+        // its next sequence number. There is no lock and no contention between a producer and
+        // a consumer working on different cells.
+        //
+        // The capacity is fixed, rounded up to a power of two. `TryPush` returns false when the
+        // queue is full and `TryPop` when it is empty, or when the next item is claimed but not
+        // published yet.
+        //
+        template<typename T, typename AllocatorType = memory::ThreadHeapAllocator>
+        class MpmcQueue
+        {
+        public:
+
+            MpmcQueue() = default;
+            MpmcQueue(uint32_t capacity) { Init(capacity); }
+            ~MpmcQueue();
+
+            MpmcQueue(const MpmcQueue&) = delete;
+            MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+            void        Init(uint32_t capacity);
+
+            template<typename ValueType>
+            bool        TryPush(ValueType &&value);
+            bool        TryPop(T &value);
+
+            // Snapshot only, other threads can change it right away
+            bool        IsEmpty() const;
+            uint32_t    GetCapacity() const { return static_cast<uint32_t>(m_Mask + 1); }
+
+        private:
+
+            struct Cell
+            {
+                std::atomic<size_t>     m_Sequence;
+                alignas(T) uint8_t      m_Storage[sizeof(T)];
+            };
+
+            Cell*                   m_pCells { nullptr };
+            size_t                  m_Mask { 0 };
+
+            // Written by producers and consumers respectively, keep them on separate cache lines
+            uint8_t                 m_Padding0[CacheLineByteSize] {};
+            std::atomic<size_t>     m_EnqueuePosition { 0 };
+            uint8_t                 m_Padding1[CacheLineByteSize] {};
+            std::atomic<size_t>     m_DequeuePosition { 0 };
+            uint8_t                 m_Padding2[CacheLineByteSize] {};
+        };
+    }
+}
+
+using namespace biome::threading;
+
+template<typename T, typename AllocatorType>
+MpmcQueue<T, AllocatorType>::~MpmcQueue()
+{
+    if (m_pCells != nullptr)
+    {
+        // Destroy the values left in the queue
+        const size_t enqueuePosition = m_EnqueuePosition.load(std::memory_order_relaxed);
+        for (size_t position = m_DequeuePosition.load(std::memory_order_relaxed); position < enqueuePosition; ++position)
+        {
+            std::launder(reinterpret_cast<T*>(m_pCells[position & m_Mask].m_Storage))->~T();
+        }
+
+        for (size_t index = 0; index <= m_Mask; ++index)
+        {
+            m_pCells[index].~Cell();
+        }
+
+        AllocatorType::Release(m_pCells);
+    }
+}
+
+template<typename T, typename AllocatorType>
+void MpmcQueue<T, AllocatorType>::Init(uint32_t capacity)
+{
+    BIOME_ASSERT_MSG(m_pCells == nullptr, "MpmcQueue is already initialized");
+    BIOME_ASSERT_MSG(capacity > 0, "MpmcQueue capacity must not be 0");
+
+    // Two cells at least, the sequence numbers of a single cell can't tell full from empty
+    uint32_t powerOfTwoCapacity = 2;
+    while (powerOfTwoCapacity < capacity)
+    {
+        powerOfTwoCapacity <<= 1;
+    }
+
+    m_Mask = static_cast<size_t>(powerOfTwoCapacity) - 1;
+    m_pCells = static_cast<Cell*>(AllocatorType::Allocate(sizeof(Cell) * powerOfTwoCapacity));
+
+    for (uint32_t index = 0; index < powerOfTwoCapacity; ++index)
+    {
+        Cell* pCell = new (m_pCells + index) Cell;
+        pCell->m_Sequence.store(index, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, typename AllocatorType>
+template<typename ValueType>
+bool MpmcQueue<T, AllocatorType>::TryPush(ValueType &&value)
+{
+    size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        Cell& cell = m_pCells[position & m_Mask];
+        const size_t sequence = cell.m_Sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            // The cell is free for this lap, claim it
+            if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                new (cell.m_Storage) T(std::forward<ValueType>(value));
+
+                // Release publishes the value to the consumer reading the sequence
+                cell.m_Sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The cell still holds the value of the previous lap
+            return false;
+        }
+        else
+        {
+            // Another producer claimed the position, catch up
+            position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, typename AllocatorType>
+bool MpmcQueue<T, AllocatorType>::TryPop(T &value)
+{
+    size_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        Cell& cell = m_pCells[position & m_Mask];
+        const size_t sequence = cell.m_Sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                T* pValue = std::launder(reinterpret_cast<T*>(cell.m_Storage));
+                value = std::move(*pValue);
+                pValue->~T();
+
+                // Hands the cell over to the producer of the next lap
+                cell.m_Sequence.store(position + m_Mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Empty, or the producer did not publish the value yet
+            return false;
+        }
+        else
+        {
+            position = m_DequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T, typename AllocatorType>
+bool MpmcQueue<T, AllocatorType>::IsEmpty() const
+{
+    const size_t dequeuePosition = m_DequeuePosition.load(std::memory_order_acquire);
+    const size_t enqueuePosition = m_EnqueuePosition.load(std::memory_order_acquire);
+    return enqueuePosition <= dequeuePosition;
+}
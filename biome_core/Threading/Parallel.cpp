@@ -0,0 +1,108 @@
+#include <pch.h>
+#include "biome_core/Threading/Parallel.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+#include "biome_core/Threading/WorkerTask.h"
+#include "biome_core/Threading/TaskCounter.h"
+#include "biome_core/SystemInfo/SystemInfo.h"
+
+using namespace biome::threading;
+
+namespace
+{
+    struct ChunkQueue
+    {
+        ParallelChunkFunction   m_pChunkFunction;
+        void*                   m_pContext;
+        uint32_t                m_Count;
+        uint32_t                m_GrainSize;
+        uint32_t                m_ChunkCount;
+        std::atomic<uint32_t>   m_NextChunk { 0 };
+    };
+
+    void RunChunks(ChunkQueue &queue, uint32_t runnerIndex)
+    {
+        uint32_t chunkIndex = queue.m_NextChunk.fetch_add(1, std::memory_order_relaxed);
+
+        while (chunkIndex < queue.m_ChunkCount)
+        {
+            const uint32_t begin = chunkIndex * queue.m_GrainSize;
+            const uint32_t end = std::min(queue.m_Count, begin + queue.m_GrainSize);
+            queue.m_pChunkFunction(queue.m_pContext, runnerIndex, begin, end);
+
+            chunkIndex = queue.m_NextChunk.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    class ChunkRunnerTask : public WorkerTask
+    {
+    public:
+
+        ChunkRunnerTask(ChunkQueue* pQueue) : m_pQueue(pQueue) {}
+
+        void DoWork() noexcept override { RunChunks(*m_pQueue, m_RunnerIndex); }
+        void OnWorkDone() noexcept override {}
+
+        ChunkQueue* m_pQueue;
+        uint32_t    m_RunnerIndex { 0 };
+    };
+
+    uint32_t GetLogicalCpuCoreCount()
+    {
+        static const uint32_t s_LogicalCpuCoreCount = std::max(1u, biome::system::GetSystemInfo().m_LogicalCpuCoreCount);
+        return s_LogicalCpuCoreCount;
+    }
+}
+
+ParallelChunking biome::threading::ComputeParallelChunking(const WorkerThreadPool &threadPool, uint32_t count, uint32_t grainSize)
+{
+    if (count == 0)
+    {
+        return ParallelChunking { 1, 0, 1 };
+    }
+
+    if (grainSize == AutomaticGrainSize)
+    {
+        const uint64_t targetChunkCount = static_cast<uint64_t>(GetLogicalCpuCoreCount()) * AutomaticChunksPerCore;
+        grainSize = static_cast<uint32_t>((count + targetChunkCount - 1) / targetChunkCount);
+    }
+
+    const uint32_t chunkCount = static_cast<uint32_t>((static_cast<uint64_t>(count) + grainSize - 1) / grainSize);
+
+    // More tasks than workers of the group running them, plus the calling thread, would only wait for chunks
+    const uint32_t runnerCount = std::min(chunkCount, threadPool.GetGroupWorkerCount(threadPool.GetCurrentGroupIndex()) + 1);
+
+    return ParallelChunking { grainSize, chunkCount, runnerCount };
+}
+
+void biome::threading::RunParallelChunks(WorkerThreadPool &threadPool, uint32_t count, const ParallelChunking &chunking, ParallelChunkFunction pChunkFunction, void *pContext)
+{
+    if (chunking.m_ChunkCount == 0)
+    {
+        return;
+    }
+
+    if (chunking.m_RunnerCount <= 1)
+    {
+        pChunkFunction(pContext, 0, 0, count);
+        return;
+    }
+
+    ChunkQueue queue { pChunkFunction, pContext, count, chunking.m_GrainSize, chunking.m_ChunkCount };
+
+    // The calling thread is runner 0
+    TaskCounter counter;
+    data::StaticArray<ChunkRunnerTask, data::CleanConstructDestruct> runners(chunking.m_RunnerCount - 1, &queue);
+    data::StaticArray<WorkerTask*> runnerTasks(runners.Size());
+
+    for (uint32_t index = 0; index < runners.Size(); ++index)
+    {
+        runners[index].m_RunnerIndex = index + 1;
+        runners[index].SetCounter(&counter);
+        runnerTasks[index] = &runners[index];
+    }
+
+    threadPool.QueueTasks(std::span<WorkerTask* const>(runnerTasks.Data(), runnerTasks.Size()));
+
+    RunChunks(queue, 0);
+    threadPool.WaitFor(counter);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "biome_core/DataStructures/Vector.h"
+#include "biome_core/DataStructures/StaticArray.h"
+#include "biome_core/DataStructures/PackedArray.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        class WorkerThreadPool;
+
+        // Data parallel loops over an index range or the values of a biome container.
+        //
+        // The range is cut in chunks of `grainSize` indices. With `AutomaticGrainSize`, the chunk
+        // size targets `AutomaticChunksPerCore` chunks per logical core, enough to balance uneven
+        // chunks without paying the hand-off cost per index.
+        // The calling thread runs chunks too and the call returns once all of them completed.
+        // Chunks are handed out dynamically to at most one task per worker, so the functions
+        // must not depend on which thread runs which chunk. Calls from inside a task are fine,
+        // the waiting worker keeps running other tasks.
+        //
+        // Reductions combine per-task partial results, so the reduce function must be
+        // associative and commutative; floating point results can vary between runs.
+        // `ParallelSort` sorts chunks concurrently and then merges them pairwise, one parallel
+        // pass per doubling of the sorted run length. It needs a temporary copy of the values.
+        //
+        constexpr uint32_t AutomaticGrainSize = 0;
+        constexpr uint32_t AutomaticChunksPerCore = 4;
+
+        struct ParallelChunking
+        {
+            uint32_t m_GrainSize;
+            uint32_t m_ChunkCount;
+            uint32_t m_RunnerCount;
+        };
+
+        // Called for every chunk with the index of the task running it, in [0, m_RunnerCount)
+        using ParallelChunkFunction = void(*)(void *pContext, uint32_t runnerIndex, uint32_t begin, uint32_t end);
+
+        ParallelChunking ComputeParallelChunking(const WorkerThreadPool &threadPool, uint32_t count, uint32_t grainSize);
+        void RunParallelChunks(WorkerThreadPool &threadPool, uint32_t count, const ParallelChunking &chunking, ParallelChunkFunction pChunkFunction, void *pContext);
+
+        // `function(uint32_t index)`
+        template<typename Function>
+        void ParallelFor(WorkerThreadPool &threadPool, uint32_t count, uint32_t grainSize, Function &&function);
+
+        // `function(ValueType& value)`
+        template<typename ContainerType, typename Function>
+        void ParallelFor(WorkerThreadPool &threadPool, ContainerType &container, uint32_t grainSize, Function &&function);
+
+        // `mapFunction(uint32_t index) -> ResultType`, `reduceFunction(ResultType, ResultType) -> ResultType`
+        template<typename ResultType, typename MapFunction, typename ReduceFunction>
+        ResultType ParallelReduce(WorkerThreadPool &threadPool, uint32_t count, uint32_t grainSize, const ResultType &identity, MapFunction &&mapFunction, ReduceFunction &&reduceFunction);
+
+        // `mapFunction(const ValueType& value) -> ResultType`, `reduceFunction(ResultType, ResultType) -> ResultType`
+        template<typename ResultType, typename ContainerType, typename MapFunction, typename ReduceFunction>
+        ResultType ParallelReduce(WorkerThreadPool &threadPool, const ContainerType &container, uint32_t grainSize, const ResultType &identity, MapFunction &&mapFunction, ReduceFunction &&reduceFunction);
+
+        template<typename ValueType, typename CompareFunction = std::less<>>
+        void ParallelSort(WorkerThreadPool &threadPool, ValueType *pValues, uint32_t count, uint32_t grainSize = AutomaticGrainSize, CompareFunction compareFunction = {});
+
+        template<typename ContainerType, typename CompareFunction = std::less<>>
+        void ParallelSort(WorkerThreadPool &threadPool, ContainerType &container, uint32_t grainSize = AutomaticGrainSize, CompareFunction compareFunction = {});
+    }
+}
+
+#include "Parallel.inl"
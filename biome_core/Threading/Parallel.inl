@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Parallel.h"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+namespace biome
+{
+    namespace threading
+    {
+        // Values and value count of the supported containers
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        ValueType* GetParallelValues(data::Vector<ValueType, CleanConstructDelete, AllocatorType> &container) { return container.Data(); }
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        const ValueType* GetParallelValues(const data::Vector<ValueType, CleanConstructDelete, AllocatorType> &container) { return container.Data(); }
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        uint32_t GetParallelValueCount(const data::Vector<ValueType, CleanConstructDelete, AllocatorType> &container) { return container.Size(); }
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        ValueType* GetParallelValues(data::StaticArray<ValueType, CleanConstructDelete, AllocatorType> &container) { return container.Data(); }
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        const ValueType* GetParallelValues(const data::StaticArray<ValueType, CleanConstructDelete, AllocatorType> &container) { return container.Data(); }
+
+        template<typename ValueType, bool CleanConstructDelete, typename AllocatorType>
+        uint32_t GetParallelValueCount(const data::StaticArray<ValueType, CleanConstructDelete, AllocatorType> &container)
+        {
+            BIOME_ASSERT_MSG(container.Size() <= std::numeric_limits<uint32_t>::max(), "Parallel loops are limited to 32-bit ranges");
+            return static_cast<uint32_t>(container.Size());
+        }
+
+        template<typename ValueType, bool IsThreadSafe>
+        ValueType* GetParallelValues(data::PackedArray<ValueType, IsThreadSafe> &container) { return container.GetIterator(); }
+
+        template<typename ValueType, bool IsThreadSafe>
+        const ValueType* GetParallelValues(const data::PackedArray<ValueType, IsThreadSafe> &container) { return container.GetIterator(); }
+
+        template<typename ValueType, bool IsThreadSafe>
+        uint32_t GetParallelValueCount(const data::PackedArray<ValueType, IsThreadSafe> &container) { return container.Count(); }
+    }
+}
+
+template<typename Function>
+void biome::threading::ParallelFor(WorkerThreadPool &threadPool, uint32_t count, uint32_t grainSize, Function &&function)
+{
+    using FunctionType = std::remove_reference_t<Function>;
+
+    const ParallelChunking chunking = ComputeParallelChunking(threadPool, count, grainSize);
+
+    RunParallelChunks(threadPool, count, chunking, [](void *pContext, uint32_t runnerIndex, uint32_t begin, uint32_t end)
+    {
+        FunctionType& chunkFunction = *static_cast<FunctionType*>(pContext);
+
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            chunkFunction(index);
+        }
+    }, const_cast<void*>(static_cast<const void*>(&function)));
+}
+
+template<typename ContainerType, typename Function>
+void biome::threading::ParallelFor(WorkerThreadPool &threadPool, ContainerType &container, uint32_t grainSize, Function &&function)
+{
+    auto* pValues = GetParallelValues(container);
+
+    ParallelFor(threadPool, GetParallelValueCount(container), grainSize, [pValues, &function](uint32_t index)
+    {
+        function(pValues[index]);
+    });
+}
+
+template<typename ResultType, typename MapFunction, typename ReduceFunction>
+ResultType biome::threading::ParallelReduce(
+    WorkerThreadPool &threadPool,
+    uint32_t count,
+    uint32_t grainSize,
+    const ResultType &identity,
+    MapFunction &&mapFunction,
+    ReduceFunction &&reduceFunction)
+{
+    struct ReduceContext
+    {
+        std::remove_reference_t<MapFunction>*       m_pMapFunction;
+        std::remove_reference_t<ReduceFunction>*    m_pReduceFunction;
+        ResultType*                                 m_pPartialResults;
+    };
+
+    const ParallelChunking chunking = ComputeParallelChunking(threadPool, count, grainSize);
+
+    // One partial result per task, each task only ever touches its own
+    data::StaticArray<ResultType, data::CleanConstructDestruct> partialResults(chunking.m_RunnerCount, identity);
+    ReduceContext context { &mapFunction, &reduceFunction, partialResults.Data() };
+
+    RunParallelChunks(threadPool, count, chunking, [](void *pContext, uint32_t runnerIndex, uint32_t begin, uint32_t end)
+    {
+        ReduceContext& reduceContext = *static_cast<ReduceContext*>(pContext);
+        ResultType& partialResult = reduceContext.m_pPartialResults[runnerIndex];
+
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            partialResult = (*reduceContext.m_pReduceFunction)(partialResult, (*reduceContext.m_pMapFunction)(index));
+        }
+    }, &context);
+
+    ResultType result = identity;
+    for (const ResultType& partialResult : partialResults)
+    {
+        result = reduceFunction(result, partialResult);
+    }
+
+    return result;
+}
+
+template<typename ResultType, typename ContainerType, typename MapFunction, typename ReduceFunction>
+ResultType biome::threading::ParallelReduce(
+    WorkerThreadPool &threadPool,
+    const ContainerType &container,
+    uint32_t grainSize,
+    const ResultType &identity,
+    MapFunction &&mapFunction,
+    ReduceFunction &&reduceFunction)
+{
+    const auto* pValues = GetParallelValues(container);
+
+    return ParallelReduce(threadPool, GetParallelValueCount(container), grainSize, identity, [pValues, &mapFunction](uint32_t index)
+    {
+        return mapFunction(pValues[index]);
+    }, reduceFunction);
+}
+
+template<typename ValueType, typename CompareFunction>
+void biome::threading::ParallelSort(WorkerThreadPool &threadPool, ValueType *pValues, uint32_t count, uint32_t grainSize, CompareFunction compareFunction)
+{
+    const ParallelChunking chunking = ComputeParallelChunking(threadPool, count, grainSize);
+
+    if (chunking.m_ChunkCount <= 1)
+    {
+        std::sort(pValues, pValues + count, compareFunction);
+        return;
+    }
+
+    // Sort every chunk on its own
+    ParallelFor(threadPool, chunking.m_ChunkCount, 1, [&](uint32_t chunkIndex)
+    {
+        const uint32_t begin = chunkIndex * chunking.m_GrainSize;
+        const uint32_t end = std::min(count, begin + chunking.m_GrainSize);
+        std::sort(pValues + begin, pValues + end, compareFunction);
+    });
+
+    // Merge sorted runs pairwise, ping-ponging between the values and a temporary copy
+    data::StaticArray<ValueType, data::CleanConstructDestruct> scratch(count);
+    ValueType* pSource = pValues;
+    ValueType* pDestination = scratch.Data();
+
+    for (uint32_t runLength = chunking.m_GrainSize; runLength < count; runLength = runLength > count / 2 ? count : runLength * 2)
+    {
+        const uint32_t pairLength = runLength > count / 2 ? count : runLength * 2;
+        const uint32_t pairCount = (count + pairLength - 1) / pairLength;
+
+        ParallelFor(threadPool, pairCount, 1, [&](uint32_t pairIndex)
+        {
+            const uint32_t begin = pairIndex * pairLength;
+            const uint32_t middle = std::min(count, begin + runLength);
+            const uint32_t end = std::min(count, begin + pairLength);
+
+            std::merge(
+                std::make_move_iterator(pSource + begin), std::make_move_iterator(pSource + middle),
+                std::make_move_iterator(pSource + middle), std::make_move_iterator(pSource + end),
+                pDestination + begin,
+                compareFunction);
+        });
+
+        std::swap(pSource, pDestination);
+    }
+
+    if (pSource != pValues)
+    {
+        ParallelFor(threadPool, count, AutomaticGrainSize, [&](uint32_t index)
+        {
+            pValues[index] = std::move(pSource[index]);
+        });
+    }
+}
+
+template<typename ContainerType, typename CompareFunction>
+void biome::threading::ParallelSort(WorkerThreadPool &threadPool, ContainerType &container, uint32_t grainSize, CompareFunction compareFunction)
+{
+    ParallelSort(threadPool, GetParallelValues(container), GetParallelValueCount(container), grainSize, compareFunction);
+}
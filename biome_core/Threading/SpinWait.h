@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #include <immintrin.h>
+#elif defined(_M_ARM64)
+    #include <intrin.h>
+#endif
+
+namespace biome
+{
+    namespace threading
+    {
+        // Size used to keep data written by different threads on separate cache lines
+        constexpr size_t CacheLineByteSize = 64;
+
+        // Hints the core that the thread is busy waiting, freeing execution resources for
+        // its hyper-threaded sibling and lowering the cost of leaving the spin loop.
+        inline void CpuPause()
+        {
+#if defined(_M_X64) || defined(__x86_64__)
+            _mm_pause();
+#elif defined(_M_ARM64)
+            __yield();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        // Bounded busy wait used before blocking a thread.
+        //
+        // The first `PauseSpinCount` calls to `Spin` only pause the core, the following ones
+        // yield the rest of the time slice. Once `Spin` returns false, the budget is spent and
+        // the caller should park the thread.
+        //
+        class SpinWait
+        {
+        public:
+
+            static constexpr uint32_t DefaultPauseSpinCount = 64;
+            static constexpr uint32_t DefaultYieldSpinCount = 16;
+
+            SpinWait(uint32_t pauseSpinCount = DefaultPauseSpinCount, uint32_t yieldSpinCount = DefaultYieldSpinCount)
+                : m_PauseSpinCount(pauseSpinCount)
+                , m_SpinCount(pauseSpinCount + yieldSpinCount) {}
+
+            bool Spin()
+            {
+                if (m_Iteration >= m_SpinCount)
+                {
+                    return false;
+                }
+
+                if (m_Iteration < m_PauseSpinCount)
+                {
+                    CpuPause();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+
+                ++m_Iteration;
+                return true;
+            }
+
+            void Reset() { m_Iteration = 0; }
+
+        private:
+
+            uint32_t m_PauseSpinCount { 0 };
+            uint32_t m_SpinCount { 0 };
+            uint32_t m_Iteration { 0 };
+        };
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Threading/SpinWait.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        // Bounded single-producer single-consumer FIFO ring buffer.
+        //
+        // One thread pushes and one thread pops, each owning the index it writes. Both keep a
+        // cached copy of the other side's index and only reload it when the ring looks full,
+        // or empty, so a push or a pop usually touches a single shared cache line.
+        //
+        // The capacity is fixed, rounded up to a power of two. `TryPush` returns false when the
+        // ring is full and `TryPop` when it is empty.
+        //
+        template<typename T, typename AllocatorType = memory::ThreadHeapAllocator>
+        class SpscRing
+        {
+        public:
+
+            SpscRing() = default;
+            SpscRing(uint32_t capacity) { Init(capacity); }
+            ~SpscRing();
+
+            SpscRing(const SpscRing&) = delete;
+            SpscRing& operator=(const SpscRing&) = delete;
+
+            void        Init(uint32_t capacity);
+
+            // Producer thread only
+            template<typename ValueType>
+            bool        TryPush(ValueType &&value);
+
+            // Consumer thread only
+            bool        TryPop(T &value);
+
+            // Snapshot only, other threads can change it right away
+            bool        IsEmpty() const;
+            uint32_t    GetCapacity() const { return static_cast<uint32_t>(m_Mask + 1); }
+
+        private:
+
+            T*                      m_pValues { nullptr };
+            size_t                  m_Mask { 0 };
+
+            // Producer side
+            uint8_t                 m_Padding0[CacheLineByteSize] {};
+            std::atomic<size_t>     m_WriteIndex { 0 };
+            size_t                  m_CachedReadIndex { 0 };
+
+            // Consumer side
+            uint8_t                 m_Padding1[CacheLineByteSize] {};
+            std::atomic<size_t>     m_ReadIndex { 0 };
+            size_t                  m_CachedWriteIndex { 0 };
+            uint8_t                 m_Padding2[CacheLineByteSize] {};
+        };
+    }
+}
+
+using namespace biome::threading;
+
+template<typename T, typename AllocatorType>
+SpscRing<T, AllocatorType>::~SpscRing()
+{
+    if (m_pValues != nullptr)
+    {
+        // Destroy the values left in the ring
+        const size_t writeIndex = m_WriteIndex.load(std::memory_order_relaxed);
+        for (size_t index = m_ReadIndex.load(std::memory_order_relaxed); index < writeIndex; ++index)
+        {
+            m_pValues[index & m_Mask].~T();
+        }
+
+        AllocatorType::Release(m_pValues);
+    }
+}
+
+template<typename T, typename AllocatorType>
+void SpscRing<T, AllocatorType>::Init(uint32_t capacity)
+{
+    BIOME_ASSERT_MSG(m_pValues == nullptr, "SpscRing is already initialized");
+    BIOME_ASSERT_MSG(capacity > 0, "SpscRing capacity must not be 0");
+
+    uint32_t powerOfTwoCapacity = 1;
+    while (powerOfTwoCapacity < capacity)
+    {
+        powerOfTwoCapacity <<= 1;
+    }
+
+    m_Mask = static_cast<size_t>(powerOfTwoCapacity) - 1;
+    m_pValues = static_cast<T*>(AllocatorType::Allocate(sizeof(T) * powerOfTwoCapacity));
+}
+
+template<typename T, typename AllocatorType>
+template<typename ValueType>
+bool SpscRing<T, AllocatorType>::TryPush(ValueType &&value)
+{
+    const size_t writeIndex = m_WriteIndex.load(std::memory_order_relaxed);
+
+    if (writeIndex - m_CachedReadIndex > m_Mask)
+    {
+        // Looks full, check how far the consumer went
+        m_CachedReadIndex = m_ReadIndex.load(std::memory_order_acquire);
+
+        if (writeIndex - m_CachedReadIndex > m_Mask)
+        {
+            return false;
+        }
+    }
+
+    new (m_pValues + (writeIndex & m_Mask)) T(std::forward<ValueType>(value));
+
+    // Release publishes the value to the consumer
+    m_WriteIndex.store(writeIndex + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename AllocatorType>
+bool SpscRing<T, AllocatorType>::TryPop(T &value)
+{
+    const size_t readIndex = m_ReadIndex.load(std::memory_order_relaxed);
+
+    if (readIndex == m_CachedWriteIndex)
+    {
+        // Looks empty, check how far the producer went
+        m_CachedWriteIndex = m_WriteIndex.load(std::memory_order_acquire);
+
+        if (readIndex == m_CachedWriteIndex)
+        {
+            return false;
+        }
+    }
+
+    T& storedValue = m_pValues[readIndex & m_Mask];
+    value = std::move(storedValue);
+    storedValue.~T();
+
+    // Release hands the slot back to the producer
+    m_ReadIndex.store(readIndex + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename AllocatorType>
+bool SpscRing<T, AllocatorType>::IsEmpty() const
+{
+    const size_t readIndex = m_ReadIndex.load(std::memory_order_acquire);
+    const size_t writeIndex = m_WriteIndex.load(std::memory_order_acquire);
+    return writeIndex <= readIndex;
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Threading/WorkerTask.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
+#include "biome_core/Threading/TaskCounter.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        template<typename T = void>
+        class Task;
+
+        // Coroutine based task.
+        //
+        // A `Task` is lazy: its body starts when it is awaited, on the awaiting thread. When it
+        // completes, the awaiting coroutine resumes right away on the thread that completed it.
+        // Tasks move between threads by awaiting something that resumes them elsewhere:
+        // `co_await ScheduleOn(threadPool)` continues on a pool worker, and an
+        // `AsyncFileReader` read continues on a worker once the data is loaded.
+        // A suspended task does not hold any thread, which lets long loading chains overlap
+        // I/O and CPU work.
+        //
+        // `SyncWait` starts a task from regular code and runs pool tasks until it completes.
+        // Coroutine frames are allocated from the thread heap of the thread starting the task.
+        //
+        class TaskPromiseBase
+        {
+        public:
+
+            // Resumes the awaiting coroutine, or signals `SyncWait`, once the task completes
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename PromiseType>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> handle) noexcept
+                {
+                    TaskPromiseBase& promise = handle.promise();
+                    const std::coroutine_handle<> continuation = promise.m_Continuation;
+
+                    if (promise.m_pCompletionCounter != nullptr)
+                    {
+                        // The waiter can destroy the frame as soon as the counter drops, don't touch it afterwards
+                        promise.m_pCompletionCounter->Decrement();
+                    }
+
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() const noexcept
+            {
+                BIOME_FAIL_MSG("Exceptions must not escape a Task");
+                std::terminate();
+            }
+
+            static void* operator new(size_t byteSize) { return memory::ThreadHeapAllocator::Allocate(byteSize); }
+            static void operator delete(void *pMemory) { memory::ThreadHeapAllocator::Release(pMemory); }
+
+            std::coroutine_handle<>     m_Continuation {};
+            TaskCounter*                m_pCompletionCounter { nullptr };
+        };
+
+        template<typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+
+            Task<T> get_return_object() noexcept;
+
+            template<typename ValueType>
+            void return_value(ValueType &&value) { m_Value.emplace(std::forward<ValueType>(value)); }
+
+            T TakeResult()
+            {
+                BIOME_ASSERT_MSG(m_Value.has_value(), "Task result read before the task completed");
+                return std::move(*m_Value);
+            }
+
+        private:
+
+            std::optional<T> m_Value {};
+        };
+
+        template<>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+
+            Task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+            void TakeResult() const noexcept {}
+        };
+
+        template<typename T>
+        class Task
+        {
+        public:
+
+            using promise_type = TaskPromise<T>;
+            using HandleType = std::coroutine_handle<promise_type>;
+
+            Task() = default;
+            explicit Task(HandleType handle) : m_Handle(handle) {}
+            Task(Task &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+            ~Task() { Destroy(); }
+
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+
+            Task& operator=(Task &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    Destroy();
+                    m_Handle = std::exchange(other.m_Handle, nullptr);
+                }
+
+                return *this;
+            }
+
+            bool IsValid() const { return static_cast<bool>(m_Handle); }
+            bool IsDone() const { return m_Handle && m_Handle.done(); }
+
+            // Starts the task, or picks up its result if it already completed
+            auto operator co_await() const noexcept
+            {
+                struct Awaiter
+                {
+                    HandleType m_Handle;
+
+                    bool await_ready() const noexcept { return m_Handle.done(); }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingHandle) noexcept
+                    {
+                        m_Handle.promise().m_Continuation = awaitingHandle;
+                        return m_Handle;
+                    }
+
+                    T await_resume() { return m_Handle.promise().TakeResult(); }
+                };
+
+                BIOME_ASSERT_MSG(m_Handle, "Awaiting an empty Task");
+                return Awaiter { m_Handle };
+            }
+
+        private:
+
+            template<typename ResultType>
+            friend ResultType SyncWait(WorkerThreadPool &threadPool, Task<ResultType> task);
+
+            void Destroy()
+            {
+                if (m_Handle)
+                {
+                    m_Handle.destroy();
+                    m_Handle = nullptr;
+                }
+            }
+
+            HandleType m_Handle {};
+        };
+
+        template<typename T>
+        Task<T> TaskPromise<T>::get_return_object() noexcept
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+
+        // Awaiting it suspends the coroutine and resumes it on a worker of `threadPool`
+        class ScheduleAwaiter : public WorkerTask
+        {
+        public:
+
+            ScheduleAwaiter(WorkerThreadPool &threadPool) : WorkerTask(true), m_ThreadPool(threadPool) {}
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                m_Handle = handle;
+                m_ThreadPool.QueueTask(this);
+            }
+            void await_resume() const noexcept {}
+
+            void DoWork() noexcept override { m_Handle.resume(); }
+            void OnWorkDone() noexcept override {}
+
+        private:
+
+            WorkerThreadPool&           m_ThreadPool;
+            std::coroutine_handle<>     m_Handle {};
+        };
+
+        inline ScheduleAwaiter ScheduleOn(WorkerThreadPool &threadPool)
+        {
+            return ScheduleAwaiter(threadPool);
+        }
+
+        // Starts `task` on the calling thread and runs pool tasks until it completes
+        template<typename ResultType>
+        ResultType SyncWait(WorkerThreadPool &threadPool, Task<ResultType> task)
+        {
+            BIOME_ASSERT_MSG(task.m_Handle && !task.m_Handle.done(), "SyncWait needs a task which did not start");
+
+            TaskCounter counter;
+            counter.Increment();
+            task.m_Handle.promise().m_pCompletionCounter = &counter;
+            task.m_Handle.resume();
+
+            threadPool.WaitFor(counter);
+            return task.m_Handle.promise().TakeResult();
+        }
+    }
+}
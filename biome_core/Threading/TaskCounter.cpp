@@ -0,0 +1,46 @@
+#include <pch.h>
+#include "biome_core/Threading/TaskCounter.h"
+
+using namespace biome::threading;
+
+void TaskCounter::Increment(uint32_t count)
+{
+    m_Value.fetch_add(count, std::memory_order_relaxed);
+}
+
+void TaskCounter::Decrement()
+{
+    uint32_t value = m_Value.load(std::memory_order_relaxed);
+
+    while (value > 1)
+    {
+        if (m_Value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+
+    BIOME_ASSERT_MSG(value == 1, "TaskCounter decremented more times than incremented");
+
+    std::lock_guard<std::mutex> lck(m_Mutex);
+    m_Value.fetch_sub(1, std::memory_order_acq_rel);
+    m_CondValue.notify_all();
+}
+
+bool TaskCounter::IsDone()
+{
+    if (m_Value.load(std::memory_order_acquire) != 0)
+    {
+        return false;
+    }
+
+    // Wait for the last decrement to leave the lock
+    std::lock_guard<std::mutex> lck(m_Mutex);
+    return true;
+}
+
+void TaskCounter::Wait()
+{
+    std::unique_lock<std::mutex> lck(m_Mutex);
+    m_CondValue.wait(lck, [&] { return m_Value.load(std::memory_order_acquire) == 0; });
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace biome
+{
+    namespace threading
+    {
+        // Number of unfinished tasks in a group.
+        //
+        // Tasks are attached with `WorkerTask::SetCounter`, which increments the counter, and
+        // decrement it once they complete. `WorkerThreadPool::WaitFor` waits for the counter to
+        // reach zero while running queued tasks. `Wait` blocks the calling thread instead and
+        // must not be used from a pool worker.
+        //
+        // The last decrement happens under the lock, and `IsDone` takes the lock before
+        // reporting zero, so a counter living on the waiter's stack can be destroyed as soon
+        // as the wait returns.
+        //
+        class TaskCounter
+        {
+        public:
+
+            TaskCounter() = default;
+            TaskCounter(const TaskCounter&) = delete;
+            TaskCounter& operator=(const TaskCounter&) = delete;
+
+            void        Increment(uint32_t count = 1);
+            void        Decrement();
+            bool        IsDone();
+            void        Wait();
+            uint32_t    GetValue() const { return m_Value.load(std::memory_order_acquire); }
+
+        private:
+
+            std::atomic<uint32_t>   m_Value { 0 };
+            std::mutex              m_Mutex {};
+            std::condition_variable m_CondValue {};
+        };
+    }
+}
@@ -0,0 +1,297 @@
+#include <pch.h>
+#include <atomic>
+#include <bit>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "biome_core/Threading/TaskProfiler.h"
+#include "biome_core/Memory/VirtualMemoryAllocator.h"
+
+using namespace biome::threading;
+using namespace biome::memory;
+using namespace biome::time;
+
+namespace
+{
+    struct ProfileEvent
+    {
+        uint64_t                m_BeginTimestamp;
+        uint64_t                m_EndTimestamp;
+        uint64_t                m_Value;
+        const char*             m_pName;
+        TaskProfileEventType    m_Type;
+    };
+
+    // Written by its thread only, read by the dump once profiling stopped
+    struct ThreadTimeline
+    {
+        ProfileEvent*           m_pEvents { nullptr };
+        uint32_t                m_EventCapacity { 0 };
+        std::atomic<uint64_t>   m_NextEventIndex { 0 };
+        uint64_t                m_StealCount { 0 };
+        char                    m_Name[TaskProfiler::MaxThreadNameLength] {};
+    };
+
+    std::atomic<bool>       s_IsRunning { false };
+    // Threads that may be writing to their timeline, see `Stop`
+    std::atomic<uint32_t>   s_PendingWriterCount { 0 };
+    std::atomic<uint32_t>   s_ThreadCount { 0 };
+    ThreadTimeline          s_Timelines[TaskProfiler::MaxThreadCount] {};
+    uint32_t                s_EventCapacity { 0 };
+    uint64_t                s_StartTimestamp { 0 };
+
+    thread_local ThreadTimeline* s_pThreadTimeline { nullptr };
+    // Applied to the thread's timeline by its next event, so that threads which never
+    // record while profiling runs take no timeline
+    thread_local char s_ThreadName[TaskProfiler::MaxThreadNameLength] {};
+    thread_local bool s_HasNewThreadName { false };
+
+    // Only called by a pending writer, see `TaskProfiler::Stop`
+    ThreadTimeline* GetThreadTimeline()
+    {
+        if (s_pThreadTimeline == nullptr)
+        {
+            const uint32_t threadIndex = s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+
+            if (threadIndex >= TaskProfiler::MaxThreadCount)
+            {
+                BIOME_FAIL_MSG("TaskProfiler: Too many profiled threads");
+                s_ThreadCount.fetch_sub(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            s_pThreadTimeline = &s_Timelines[threadIndex];
+        }
+
+        if (s_HasNewThreadName)
+        {
+            memcpy(s_pThreadTimeline->m_Name, s_ThreadName, sizeof(s_ThreadName));
+            s_HasNewThreadName = false;
+        }
+
+        return s_pThreadTimeline;
+    }
+
+    FILE* OpenForWrite(const char *pFilePath)
+    {
+    #if PLATFORM_WINDOWS
+        FILE *pFile = nullptr;
+        return fopen_s(&pFile, pFilePath, "wb") == 0 ? pFile : nullptr;
+    #else
+        return fopen(pFilePath, "wb");
+    #endif
+    }
+
+    // Microseconds since profiling started, Chrome trace events time unit
+    double ToMicroseconds(uint64_t timestamp)
+    {
+        const double ticksPerMicrosecond = static_cast<double>(Timer::GetTimestampFrequency()) / 1000000.0;
+        return static_cast<double>(timestamp - s_StartTimestamp) / ticksPerMicrosecond;
+    }
+
+    const char* GetCategory(TaskProfileEventType type)
+    {
+        switch (type)
+        {
+            case TaskProfileEventType::Task:    return "task";
+            case TaskProfileEventType::Run:     return "run";
+            case TaskProfileEventType::Idle:    return "idle";
+            case TaskProfileEventType::Steal:   return "steal";
+        }
+
+        return "";
+    }
+
+    // Names are identifiers or type names, only quotes and backslashes need escaping
+    void WriteJsonString(FILE *pFile, const char *pString)
+    {
+        fputc('"', pFile);
+
+        for (const char* pChar = pString; *pChar != '\0'; ++pChar)
+        {
+            if (*pChar == '"' || *pChar == '\\')
+            {
+                fputc('\\', pFile);
+            }
+
+            fputc(*pChar, pFile);
+        }
+
+        fputc('"', pFile);
+    }
+
+    void WriteEvent(FILE *pFile, const ProfileEvent &event, uint32_t threadIndex)
+    {
+        if (event.m_Type == TaskProfileEventType::Steal)
+        {
+            // Counter track, one per thread
+            fprintf(pFile, ",\n{\"name\":\"Steals %u\",\"cat\":\"steal\",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"count\":%llu}}",
+                threadIndex, threadIndex, ToMicroseconds(event.m_BeginTimestamp), static_cast<unsigned long long>(event.m_Value));
+            return;
+        }
+
+        fputs(",\n{\"name\":", pFile);
+        WriteJsonString(pFile, event.m_pName);
+        fprintf(pFile, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+            GetCategory(event.m_Type),
+            threadIndex,
+            ToMicroseconds(event.m_BeginTimestamp),
+            ToMicroseconds(event.m_EndTimestamp) - ToMicroseconds(event.m_BeginTimestamp));
+
+        // Tasks queued before profiling started have no queue time
+        if (event.m_Type == TaskProfileEventType::Task && event.m_Value != 0 && event.m_Value <= event.m_BeginTimestamp)
+        {
+            fprintf(pFile, ",\"args\":{\"queue_wait_us\":%.3f}", ToMicroseconds(event.m_BeginTimestamp) - ToMicroseconds(event.m_Value));
+        }
+
+        fputc('}', pFile);
+    }
+}
+
+void TaskProfiler::Start(uint32_t perThreadEventCapacity)
+{
+    BIOME_ASSERT_MSG(!IsRunning(), "TaskProfiler::Start: Already running");
+
+    // Power of two capacity so that the write index wraps with a mask
+    s_EventCapacity = std::bit_ceil(std::max<uint32_t>(perThreadEventCapacity, 1));
+
+    const uint32_t threadCount = std::min(s_ThreadCount.load(std::memory_order_acquire), MaxThreadCount);
+
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+    {
+        // Threads reallocate their buffer on their next event when the capacity changed
+        s_Timelines[threadIndex].m_NextEventIndex.store(0, std::memory_order_relaxed);
+        s_Timelines[threadIndex].m_StealCount = 0;
+    }
+
+    s_StartTimestamp = Timer::GetTimestamp();
+    s_IsRunning.store(true, std::memory_order_release);
+}
+
+void TaskProfiler::Stop()
+{
+    s_IsRunning.store(false, std::memory_order_relaxed);
+
+    // Pairs with the fence in `Record`: either the writer sees profiling stopped,
+    // or its pending count is seen here and its event is complete once it drops
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (s_PendingWriterCount.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+bool TaskProfiler::IsRunning()
+{
+    return s_IsRunning.load(std::memory_order_relaxed);
+}
+
+bool TaskProfiler::DumpChromeTrace(const char *pFilePath)
+{
+    BIOME_ASSERT_MSG(!IsRunning(), "TaskProfiler::DumpChromeTrace: Profiling must be stopped first");
+
+    FILE *pFile = OpenForWrite(pFilePath);
+    if (pFile == nullptr)
+    {
+        return false;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"biome\"}}", pFile);
+
+    const uint32_t threadCount = std::min(s_ThreadCount.load(std::memory_order_acquire), MaxThreadCount);
+
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+    {
+        const ThreadTimeline& timeline = s_Timelines[threadIndex];
+
+        fprintf(pFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", threadIndex);
+        WriteJsonString(pFile, timeline.m_Name[0] != '\0' ? timeline.m_Name : "Thread");
+        fputs("}}", pFile);
+
+        if (timeline.m_pEvents == nullptr)
+        {
+            continue;
+        }
+
+        const uint64_t recordedCount = timeline.m_NextEventIndex.load(std::memory_order_acquire);
+        const uint64_t eventCount = std::min<uint64_t>(recordedCount, timeline.m_EventCapacity);
+
+        for (uint64_t eventIndex = recordedCount - eventCount; eventIndex < recordedCount; ++eventIndex)
+        {
+            WriteEvent(pFile, timeline.m_pEvents[eventIndex & (timeline.m_EventCapacity - 1)], threadIndex);
+        }
+    }
+
+    fputs("\n]}\n", pFile);
+
+    const bool succeeded = ferror(pFile) == 0;
+    fclose(pFile);
+
+    return succeeded;
+}
+
+void TaskProfiler::SetThreadName(const char *pName)
+{
+    snprintf(s_ThreadName, sizeof(s_ThreadName), "%s", pName);
+    s_HasNewThreadName = true;
+}
+
+void TaskProfiler::Record(TaskProfileEventType type, const char *pName, uint64_t beginTimestamp, uint64_t endTimestamp, uint64_t value)
+{
+    if (!s_IsRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    s_PendingWriterCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Stopped meanwhile, the dump or the next `Start` may already read the timeline.
+    // Acquire pairs with `Start` publishing the event capacity.
+    ThreadTimeline* const pTimeline = s_IsRunning.load(std::memory_order_acquire) ? GetThreadTimeline() : nullptr;
+
+    if (pTimeline == nullptr)
+    {
+        s_PendingWriterCount.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    if (pTimeline->m_EventCapacity != s_EventCapacity)
+    {
+        if (pTimeline->m_pEvents != nullptr)
+        {
+            VirtualMemoryAllocator::Release(pTimeline->m_pEvents);
+        }
+
+        const size_t byteSize = s_EventCapacity * sizeof(ProfileEvent);
+        pTimeline->m_pEvents = static_cast<ProfileEvent*>(VirtualMemoryAllocator::Allocate(byteSize, byteSize));
+        pTimeline->m_EventCapacity = s_EventCapacity;
+    }
+
+    // Single writer, a plain load and a release store publish the event to the dump
+    const uint64_t eventIndex = pTimeline->m_NextEventIndex.load(std::memory_order_relaxed);
+    ProfileEvent& event = pTimeline->m_pEvents[eventIndex & (pTimeline->m_EventCapacity - 1)];
+
+    event.m_BeginTimestamp = beginTimestamp;
+    event.m_EndTimestamp = endTimestamp;
+    event.m_Value = (type == TaskProfileEventType::Steal) ? ++pTimeline->m_StealCount : value;
+    event.m_pName = pName;
+    event.m_Type = type;
+
+    pTimeline->m_NextEventIndex.store(eventIndex + 1, std::memory_order_release);
+
+    s_PendingWriterCount.fetch_sub(1, std::memory_order_release);
+}
+
+void TaskProfiler::RecordSteal()
+{
+    if (!s_IsRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // The steal count is read from the timeline by `Record`, under the pending writer count
+    const uint64_t timestamp = Timer::GetTimestamp();
+    Record(TaskProfileEventType::Steal, "Steal", timestamp, timestamp, 0);
+}
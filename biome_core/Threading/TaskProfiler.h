@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Time/Timer.h"
+
+// Compiles task profiling in. Profiling then still has to be started at runtime.
+#ifndef BIOME_TASK_PROFILER
+    #define BIOME_TASK_PROFILER 0
+#endif
+
+namespace biome
+{
+    namespace threading
+    {
+        enum class TaskProfileEventType : uint8_t
+        {
+            // A pool task ran, `m_Value` holds the timestamp it was queued at
+            Task,
+            // A `WorkerThread` run
+            Run,
+            // The thread waited for work
+            Idle,
+            // The thread stole a task, `m_Value` holds its steal count so far
+            Steal
+        };
+
+        // Timeline of what the worker threads do, exported as Chrome trace events.
+        //
+        // Every thread records into its own ring buffer, so recording is a relaxed load when
+        // profiling is stopped, and two timestamp reads plus a 40 bytes write when it runs. The
+        // only shared write is the pending writer count that `Stop` waits on. Once a buffer is
+        // full, the thread overwrites its oldest events. A thread takes a timeline and allocates
+        // its buffer on the first event it records while profiling runs. Timelines are never
+        // released, at most `MaxThreadCount` threads of a process can record.
+        //
+        // `Stop` returns once the events being recorded are complete, the trace can then be
+        // dumped. `Start` and `DumpChromeTrace` must not run concurrently, e.g. call them between
+        // frames. The dump is a JSON object in the Chrome `trace_event` format, which both
+        // chrome://tracing and the Perfetto UI load. Timestamps come from `time::Timer`.
+        //
+        class TaskProfiler
+        {
+        public:
+
+            static constexpr uint32_t MaxThreadCount = 256;
+            static constexpr uint32_t MaxThreadNameLength = 32;
+
+            static void Start(uint32_t perThreadEventCapacity);
+            static void Stop();
+            static bool IsRunning();
+            static bool DumpChromeTrace(const char *pFilePath);
+
+            // Names the calling thread's timeline, can be called before profiling starts.
+            // Takes no timeline, the name is applied by the thread's next event.
+            static void SetThreadName(const char *pName);
+
+            // `pName` must be a string literal, or outlive the trace dump
+            static void Record(TaskProfileEventType type, const char *pName, uint64_t beginTimestamp, uint64_t endTimestamp, uint64_t value);
+            static void RecordSteal();
+
+            // 0 when profiling is stopped, so that scopes started while stopped record nothing
+            static uint64_t GetTimestamp() { return IsRunning() ? time::Timer::GetTimestamp() : 0; }
+        };
+
+        // Records an event covering its lifetime
+        class TaskProfileScope
+        {
+        public:
+
+            TaskProfileScope(TaskProfileEventType type, const char *pName, uint64_t value = 0)
+                : m_pName(pName)
+                , m_Value(value)
+                , m_BeginTimestamp(TaskProfiler::GetTimestamp())
+                , m_Type(type)
+            {
+            }
+
+            ~TaskProfileScope()
+            {
+                if (m_BeginTimestamp != 0)
+                {
+                    TaskProfiler::Record(m_Type, m_pName, m_BeginTimestamp, time::Timer::GetTimestamp(), m_Value);
+                }
+            }
+
+            TaskProfileScope(const TaskProfileScope&) = delete;
+            TaskProfileScope& operator=(const TaskProfileScope&) = delete;
+
+        private:
+
+            const char*             m_pName;
+            uint64_t                m_Value;
+            uint64_t                m_BeginTimestamp;
+            TaskProfileEventType    m_Type;
+        };
+    }
+}
+
+#if BIOME_TASK_PROFILER
+    #define BIOME_PROFILE_THREAD_NAME(name) biome::threading::TaskProfiler::SetThreadName(name)
+    #define BIOME_PROFILE_SCOPE(eventType, name, value)                                                                      \
+        biome::threading::TaskProfileScope CONCAT(taskProfileScope, __LINE__)(                                              \
+            biome::threading::TaskProfileEventType::eventType, (name), (value))
+    #define BIOME_PROFILE_STEAL() biome::threading::TaskProfiler::RecordSteal()
+#else
+    #define BIOME_PROFILE_THREAD_NAME(name)
+    #define BIOME_PROFILE_SCOPE(eventType, name, value)
+    #define BIOME_PROFILE_STEAL()
+#endif
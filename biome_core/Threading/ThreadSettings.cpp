@@ -0,0 +1,89 @@
+#include <pch.h>
+#include "biome_core/Threading/ThreadSettings.h"
+
+#if PLATFORM_LINUX
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+#endif
+
+using namespace biome::threading;
+
+#if PLATFORM_WINDOWS
+
+bool biome::threading::SetCurrentThreadAffinity(uint64_t affinityMask)
+{
+    if (affinityMask == 0)
+    {
+        DWORD_PTR processMask = 0;
+        DWORD_PTR systemMask = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        {
+            return false;
+        }
+
+        affinityMask = processMask;
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(affinityMask)) != 0;
+}
+
+bool biome::threading::SetCurrentThreadPriority(ThreadPriority priority)
+{
+    static constexpr int s_Priorities[] = { THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL };
+    static_assert(BIOME_ARRAY_SIZE(s_Priorities) == static_cast<size_t>(ThreadPriority::Count));
+
+    return SetThreadPriority(GetCurrentThread(), s_Priorities[static_cast<size_t>(priority)]) != 0;
+}
+
+void biome::threading::SetCurrentThreadName(const char *pName)
+{
+    wchar_t name[64];
+    if (MultiByteToWideChar(CP_UTF8, 0, pName, -1, name, static_cast<int>(BIOME_ARRAY_SIZE(name))) > 0)
+    {
+        SetThreadDescription(GetCurrentThread(), name);
+    }
+}
+
+#elif PLATFORM_LINUX
+
+bool biome::threading::SetCurrentThreadAffinity(uint64_t affinityMask)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    // Every configured core, the kernel drops the ones outside of the process cpuset
+    const long cpuCount = affinityMask == 0 ? std::min(sysconf(_SC_NPROCESSORS_CONF), static_cast<long>(CPU_SETSIZE)) : 64;
+
+    for (long cpu = 0; cpu < cpuCount; ++cpu)
+    {
+        if (affinityMask == 0 || (affinityMask & (uint64_t(1) << cpu)))
+        {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+bool biome::threading::SetCurrentThreadPriority(ThreadPriority priority)
+{
+    // Regular threads have no priority of their own on Linux, the thread nice value is used instead
+    static constexpr int s_NiceValues[] = { 5, 0, -5 };
+    static_assert(BIOME_ARRAY_SIZE(s_NiceValues) == static_cast<size_t>(ThreadPriority::Count));
+
+    const pid_t threadId = static_cast<pid_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(threadId), s_NiceValues[static_cast<size_t>(priority)]) == 0;
+}
+
+void biome::threading::SetCurrentThreadName(const char *pName)
+{
+    // Thread names are limited to 15 characters
+    char name[16];
+    snprintf(name, sizeof(name), "%s", pName);
+    pthread_setname_np(pthread_self(), name);
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace biome
+{
+    namespace threading
+    {
+        enum class ThreadPriority
+        {
+            Low,
+            Normal,
+            High,
+            Count
+        };
+
+        // Settings applied to the calling thread. They return false when the OS refuses the
+        // setting, e.g. raising the priority without the required privileges on Linux.
+        //
+        // Affinity masks hold one bit per logical core, see `biome::system::CpuTopology`.
+        // An empty mask leaves the thread free to run on any core.
+        //
+        bool SetCurrentThreadAffinity(uint64_t affinityMask);
+        bool SetCurrentThreadPriority(ThreadPriority priority);
+        void SetCurrentThreadName(const char *pName);
+    }
+}
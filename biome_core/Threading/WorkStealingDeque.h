@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+#include "biome_core/Core/Defines.h"
+#include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Threading/SpinWait.h"
+
+namespace biome
+{
+    namespace threading
+    {
+        // Bounded Chase-Lev work stealing deque.
+        //
+        // The owner thread pushes and pops at the bottom end, in LIFO order, without any
+        // read-modify-write in the common case. Any other thread can steal from the top end,
+        // in FIFO order, with a single compare-exchange. Only a pop racing a steal for the
+        // last item needs the compare-exchange on the owner side.
+        //
+        // The capacity is fixed, rounded up to a power of two. `Push` returns false when the
+        // deque is full so that the owner can hand the item to a shared queue instead, which
+        // avoids the buffer reclamation problem of the growable variant.
+        // `T` is expected to be a small trivially copyable type, usually a pointer.
+        //
+        template<typename T, typename AllocatorType = memory::ThreadHeapAllocator>
+        class WorkStealingDeque
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque items must be trivially copyable");
+
+        public:
+
+            WorkStealingDeque(uint32_t capacity);
+            ~WorkStealingDeque();
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            // Owner thread only
+            bool        Push(T item);
+            bool        Pop(T &item);
+
+            // Any thread
+            bool        Steal(T &item);
+            bool        IsEmpty() const;
+            uint32_t    GetCapacity() const { return static_cast<uint32_t>(m_Mask + 1); }
+
+        private:
+
+            std::atomic<T>*         m_pItems { nullptr };
+            int64_t                 m_Mask { 0 };
+
+            // Top is written by thieves, bottom by the owner, keep them on separate cache lines
+            uint8_t                 m_Padding0[CacheLineByteSize] {};
+            std::atomic<int64_t>    m_Top { 0 };
+            uint8_t                 m_Padding1[CacheLineByteSize] {};
+            std::atomic<int64_t>    m_Bottom { 0 };
+            uint8_t                 m_Padding2[CacheLineByteSize] {};
+        };
+    }
+}
+
+using namespace biome::threading;
+
+template<typename T, typename AllocatorType>
+WorkStealingDeque<T, AllocatorType>::WorkStealingDeque(uint32_t capacity)
+{
+    BIOME_ASSERT_MSG(capacity > 0, "WorkStealingDeque capacity must not be 0");
+
+    uint32_t powerOfTwoCapacity = 1;
+    while (powerOfTwoCapacity < capacity)
+    {
+        powerOfTwoCapacity <<= 1;
+    }
+
+    m_Mask = static_cast<int64_t>(powerOfTwoCapacity) - 1;
+    m_pItems = static_cast<std::atomic<T>*>(AllocatorType::Allocate(sizeof(std::atomic<T>) * powerOfTwoCapacity));
+
+    for (uint32_t index = 0; index < powerOfTwoCapacity; ++index)
+    {
+        new (m_pItems + index) std::atomic<T>();
+    }
+}
+
+template<typename T, typename AllocatorType>
+WorkStealingDeque<T, AllocatorType>::~WorkStealingDeque()
+{
+    if (m_pItems != nullptr)
+    {
+        AllocatorType::Release(m_pItems);
+    }
+}
+
+template<typename T, typename AllocatorType>
+bool WorkStealingDeque<T, AllocatorType>::Push(T item)
+{
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_Top.load(std::memory_order_acquire);
+
+    if (bottom - top > m_Mask)
+    {
+        return false;
+    }
+
+    m_pItems[bottom & m_Mask].store(item, std::memory_order_relaxed);
+
+    // Release publishes the item, and whatever it points to, to the thieves reading bottom
+    m_Bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, typename AllocatorType>
+bool WorkStealingDeque<T, AllocatorType>::Pop(T &item)
+{
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+
+    // Orders the bottom reservation before reading top, pairs with the fence in `Steal`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // Empty, restore bottom
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    item = m_pItems[bottom & m_Mask].load(std::memory_order_relaxed);
+
+    if (top == bottom)
+    {
+        // Last item, race thieves for it
+        const bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    return true;
+}
+
+template<typename T, typename AllocatorType>
+bool WorkStealingDeque<T, AllocatorType>::Steal(T &item)
+{
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    // The slot can be overwritten by a push once top moves, so read it before claiming it
+    const T candidate = m_pItems[top & m_Mask].load(std::memory_order_relaxed);
+
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // Lost against another thief or the owner's last pop
+        return false;
+    }
+
+    item = candidate;
+    return true;
+}
+
+template<typename T, typename AllocatorType>
+bool WorkStealingDeque<T, AllocatorType>::IsEmpty() const
+{
+    const int64_t top = m_Top.load(std::memory_order_acquire);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+    return top >= bottom;
+}
@@ -0,0 +1,35 @@
+#include <pch.h>
+#include "biome_core/Threading/WorkerTask.h"
+#include "biome_core/Threading/TaskCounter.h"
+
+using namespace biome::threading;
+
+void WorkerTask::AddDependency(WorkerTask* const pDependency)
+{
+    BIOME_ASSERT(pDependency != nullptr && pDependency != this);
+    BIOME_ASSERT_MSG(!m_IsDetached && !pDependency->m_IsDetached, "Detached tasks can't be part of a task graph");
+    BIOME_ASSERT_MSG(pDependency->m_ContinuationCount < MaxContinuationCount, "Too many tasks depend on this task");
+
+    pDependency->m_pContinuations[pDependency->m_ContinuationCount++] = this;
+    m_UnfinishedDependencyCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkerTask::SetParent(WorkerTask* const pParent)
+{
+    BIOME_ASSERT(pParent != nullptr && pParent != this);
+    BIOME_ASSERT_MSG(!m_IsDetached && !pParent->m_IsDetached, "Detached tasks can't be part of a task graph");
+    BIOME_ASSERT_MSG(m_pParent == nullptr, "Task already has a parent");
+
+    pParent->m_UnfinishedWorkCount.fetch_add(1, std::memory_order_relaxed);
+    m_pParent = pParent;
+}
+
+void WorkerTask::SetCounter(TaskCounter* const pCounter)
+{
+    BIOME_ASSERT(pCounter != nullptr);
+    BIOME_ASSERT_MSG(!m_IsDetached, "Detached tasks can't be part of a task graph");
+    BIOME_ASSERT_MSG(m_pCounter == nullptr, "Task already has a counter");
+
+    pCounter->Increment();
+    m_pCounter = pCounter;
+}
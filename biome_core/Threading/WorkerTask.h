@@ -1,16 +1,95 @@
 #pragma once
 
+#include <cstdint>
+#include <atomic>
+#include <typeinfo>
+
+#include "biome_core/Threading/TaskProfiler.h"
+
 namespace biome
 {
     namespace threading
     {
+        class TaskCounter;
+        class WorkerThreadPool;
+
+        enum class TaskPriority
+        {
+            Low,
+            Normal,
+            High,
+            Count
+        };
+
+        // Unit of work run by `WorkerThreadPool`.
+        //
+        // Tasks can form a graph:
+        // - `AddDependency` makes the task wait for another task to complete before it runs.
+        //   Queuing a task with unfinished dependencies only marks it ready to run, the pool
+        //   queues it itself when its last dependency completes.
+        // - `SetParent` makes the task a child of a running task, which then only completes once
+        //   all its children have. Children are usually spawned from the parent's `DoWork`.
+        // - `SetCounter` decrements a counter when the task completes, see `WorkerThreadPool::WaitFor`.
+        //
+        // `SetPriority` picks the injection queue of the task, it stays set across runs.
+        //
+        // A task completes once `DoWork` returned and all its children completed. `OnWorkDone` is
+        // then called, after which the task is no longer touched by the pool and can be deleted.
+        // Graph setup must happen before the tasks involved are queued.
+        //
+        // A detached task is not touched by the pool once `DoWork` starts, so `DoWork` may
+        // destroy it. Detached tasks can't be part of a graph and `OnWorkDone` is not called.
+        // They are used to resume coroutines, whose frame holds the task and can be destroyed
+        // by the resumed code.
+        //
         class WorkerTask
         {
         public:
 
+            static constexpr uint32_t MaxContinuationCount = 8;
+
+            WorkerTask() = default;
+            explicit WorkerTask(bool isDetached) : m_IsDetached(isDetached) {}
+
             // These will be called from a worker thread.
             virtual void DoWork() noexcept = 0;
             virtual void OnWorkDone() noexcept = 0;
+
+            // Name of the task on profiler timelines, must outlive the trace dump
+            virtual const char* GetName() const noexcept { return typeid(*this).name(); }
+
+            void AddDependency(WorkerTask* const pDependency);
+            void SetParent(WorkerTask* const pParent);
+            void SetCounter(TaskCounter* const pCounter);
+            void SetPriority(TaskPriority priority) { m_Priority = priority; }
+
+        private:
+
+            friend class WorkerThreadPool;
+
+            // Returns true when the task can run, i.e. it was queued and has no unfinished dependencies
+            bool ReleaseDependency() { return m_UnfinishedDependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+            // Returns true when the task and all its children are done
+            bool ReleaseWork() { return m_UnfinishedWorkCount.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+            // Starts at one for the pending `QueueTask` call
+            std::atomic<uint32_t>   m_UnfinishedDependencyCount { 1 };
+            // Starts at one for the task's own `DoWork`
+            std::atomic<uint32_t>   m_UnfinishedWorkCount { 1 };
+            WorkerTask*             m_pContinuations[MaxContinuationCount] {};
+            uint32_t                m_ContinuationCount { 0 };
+            WorkerTask*             m_pParent { nullptr };
+            TaskCounter*            m_pCounter { nullptr };
+            // Next task in its group's overflow queue
+            WorkerTask*             m_pNextQueued { nullptr };
+            // Worker group the task runs in, set by `QueueTask`
+            uint32_t                m_GroupIndex { 0 };
+            TaskPriority            m_Priority { TaskPriority::Normal };
+            bool                    m_IsDetached { false };
+#if BIOME_TASK_PROFILER
+            // Profiler timestamp of the last time the task was queued
+            uint64_t                m_QueuedTimestamp { 0 };
+#endif
         };
     }
 }
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <thread>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
 #include <type_traits>
 #include <tuple>
 
 #include "biome_core/Memory/ThreadHeapAllocator.h"
+#include "biome_core/Threading/SpinWait.h"
+#include "biome_core/Threading/TaskProfiler.h"
+#include "biome_core/Threading/WorkerThreadPool.h"
 
 namespace biome
 {
@@ -23,6 +25,13 @@ namespace biome
         // calls `Run` with the required arguments. The worker thread then wakes, 
         // executes the function, notify any waiting thread and yields/sleeps/waits again.
         //
+        // Runs are handed over through two atomic run indices, one for the requested runs and
+        // one for the completed ones. Both sides first spin on them for `spinCount` pauses, so
+        // short back to back runs never go through the kernel, and only then block with
+        // `std::atomic::wait`. The worker and the threads calling `Wait` block on different
+        // indices, so a run request only wakes the worker and a completion only wakes waiters.
+        // `Run` waits for the previous run to complete before handing over new arguments.
+        //
         template<typename ReturnType, typename ...ArgumentTypes>
         class WorkerThread<ReturnType(ArgumentTypes...) noexcept>
         {
@@ -33,7 +42,9 @@ namespace biome
             using FunctionPtrType = std::remove_const_t<decltype(fnctPtr)>;
             using CallbackPtrType = std::remove_const_t<decltype(callbackPtr)>;
 
-            WorkerThread(FunctionPtrType threadFunction, size_t heapByteSize, size_t initialCommitByteSize);
+            static constexpr uint32_t DefaultSpinCount = 1024;
+
+            WorkerThread(FunctionPtrType threadFunction, size_t heapByteSize, size_t initialCommitByteSize, uint32_t spinCount = DefaultSpinCount);
             ~WorkerThread();
 
             WorkerThread(const WorkerThread&) = delete;
@@ -50,20 +61,29 @@ namespace biome
 
             static void ThreadMain(WorkerThread *thisThread, size_t heapByteSize, size_t initialCommitByteSize);
 
+            // Spins, then blocks, until `value` differs from `oldValue`, returns the new value
+            template<typename ValueType>
+            static ValueType WaitForChange(const std::atomic<ValueType> &value, ValueType oldValue, uint32_t spinCount);
+
             void Execute();
+            void WaitForRunIndex(uint64_t runIndex) const;
 
             FunctionPtrType m_Function;
             CallbackPtrType m_Callback { nullptr };
             ReturnType m_ReturnedArg {};
             std::tuple<ArgumentTypes...> m_Arguments;
+            uint32_t m_SpinCount;
 
-            std::thread m_Thread;
-            std::mutex m_Mutex {};
-            std::condition_variable m_CondValue {};
+            // Written by the threads calling `Run`, waited on by the worker
+            std::atomic<uint64_t> m_NextRunIndex { 0 };
+            uint8_t m_Padding[CacheLineByteSize] {};
+            // Written by the worker, waited on by the threads calling `Wait`
+            std::atomic<uint64_t> m_RunIndex { 0 };
+            std::atomic<bool> m_IsStarted { false };
+            std::atomic<bool> m_IsStopping { false };
 
-            uint64_t m_RunIndex { 0 };
-            uint64_t m_NextRunIndex { 0 };
-            bool m_Executing { false };
+            // Last, the thread must only start once the other members are initialized
+            std::thread m_Thread;
         };
     }
 }
@@ -72,8 +92,9 @@ using namespace biome::threading;
 using namespace biome::memory;
 
 template<typename ReturnType, typename ...ArgumentTypes>
-WorkerThread<ReturnType(ArgumentTypes...) noexcept>::WorkerThread(FunctionPtrType threadFunction, size_t heapByteSize, size_t initialCommitByteSize)
+WorkerThread<ReturnType(ArgumentTypes...) noexcept>::WorkerThread(FunctionPtrType threadFunction, size_t heapByteSize, size_t initialCommitByteSize, uint32_t spinCount)
     : m_Function(threadFunction)
+    , m_SpinCount(spinCount)
     , m_Thread(ThreadMain, this, heapByteSize, initialCommitByteSize)
 { 
 
@@ -88,25 +109,25 @@ WorkerThread<ReturnType(ArgumentTypes...) noexcept>::~WorkerThread()
 template<typename ReturnType, typename ...ArgumentTypes>
 void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Init()
 {
-    std::unique_lock<std::mutex> lck(m_Mutex);
-    m_CondValue.wait(lck, [&]{ return m_Executing; });
+    WaitForChange(m_IsStarted, false, m_SpinCount);
 }
 
 template<typename ReturnType, typename ...ArgumentTypes>
 void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Shutdown()
 {
+    if (!m_Thread.joinable())
     {
-        std::lock_guard<std::mutex> lck(m_Mutex);
-        m_Executing = false;
-        ++m_NextRunIndex;
+        return;
     }
 
-    m_CondValue.notify_all();
+    // Let a pending run complete, then wake the worker one last time
+    WaitForRunIndex(m_NextRunIndex.load(std::memory_order_relaxed));
 
-    if (m_Thread.joinable())
-    {
-        m_Thread.join();
-    }
+    m_IsStopping.store(true, std::memory_order_relaxed);
+    m_NextRunIndex.fetch_add(1, std::memory_order_release);
+    m_NextRunIndex.notify_one();
+
+    m_Thread.join();
 }
 
 template<typename ReturnType, typename ...ArgumentTypes>
@@ -118,58 +139,100 @@ void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Run(ArgumentTypes... a
 template<typename ReturnType, typename ...ArgumentTypes>
 void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Run(CallbackPtrType callbackFunction, ArgumentTypes... args)
 {
-    {
-        std::lock_guard<std::mutex> lck(m_Mutex);
-        m_Arguments = std::make_tuple(args...);
-        m_Callback = callbackFunction;
-        ++m_NextRunIndex;
-    }
-    
-    m_CondValue.notify_all();
+    // The worker reads the arguments while it runs, don't overwrite them under its feet
+    const uint64_t nextRunIndex = m_NextRunIndex.load(std::memory_order_relaxed);
+    WaitForRunIndex(nextRunIndex);
+
+    m_Arguments = std::make_tuple(args...);
+    m_Callback = callbackFunction;
+
+    // Release publishes the arguments to the worker
+    m_NextRunIndex.store(nextRunIndex + 1, std::memory_order_release);
+    m_NextRunIndex.notify_one();
 }
 
 template<typename ReturnType, typename ...ArgumentTypes>
 ReturnType WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Wait()
 {
-    std::unique_lock<std::mutex> lck(m_Mutex);
-    m_CondValue.wait(lck, [&] { return m_RunIndex == m_NextRunIndex; });
+    WaitForRunIndex(m_NextRunIndex.load(std::memory_order_relaxed));
     return m_ReturnedArg;
 }
 
+template<typename ReturnType, typename ...ArgumentTypes>
+void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::WaitForRunIndex(uint64_t runIndex) const
+{
+    uint64_t completedRunIndex = m_RunIndex.load(std::memory_order_acquire);
+
+    while (completedRunIndex != runIndex)
+    {
+        completedRunIndex = WaitForChange(m_RunIndex, completedRunIndex, m_SpinCount);
+    }
+}
+
+template<typename ReturnType, typename ...ArgumentTypes>
+template<typename ValueType>
+ValueType WorkerThread<ReturnType(ArgumentTypes...) noexcept>::WaitForChange(const std::atomic<ValueType> &value, ValueType oldValue, uint32_t spinCount)
+{
+    SpinWait spinWait(spinCount);
+    ValueType newValue = value.load(std::memory_order_acquire);
+
+    while (newValue == oldValue)
+    {
+        if (!spinWait.Spin())
+        {
+            value.wait(oldValue, std::memory_order_acquire);
+        }
+
+        newValue = value.load(std::memory_order_acquire);
+    }
+
+    return newValue;
+}
+
 template<typename ReturnType, typename ...ArgumentTypes>
 void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::ThreadMain(WorkerThread *thisThread, size_t heapByteSize, size_t initialCommitByteSize)
 {
     BIOME_ASSERT_ALWAYS_EXEC(ThreadHeapAllocator::Initialize(heapByteSize, initialCommitByteSize));
+    BIOME_PROFILE_THREAD_NAME("WorkerThread");
     thisThread->Execute();
 }
 
 template<typename ReturnType, typename ...ArgumentTypes>
 void WorkerThread<ReturnType(ArgumentTypes...) noexcept>::Execute()
 {
-    {
-        std::lock_guard<std::mutex> execLock(m_Mutex);
-        m_Executing = true;
-    }
-    
-    m_CondValue.notify_all();
+    m_IsStarted.store(true, std::memory_order_release);
+    m_IsStarted.notify_all();
 
-    std::unique_lock<std::mutex> lck(m_Mutex);
-    m_CondValue.wait(lck, [&] { return m_RunIndex < m_NextRunIndex; });
+    uint64_t runIndex = 0;
 
-    while (m_Executing)
+    while (true)
     {
-        m_ReturnedArg = std::apply(m_Function, m_Arguments);
+        {
+            BIOME_PROFILE_SCOPE(Idle, "Idle", 0);
+            runIndex = WaitForChange(m_NextRunIndex, runIndex, m_SpinCount);
+        }
 
-        if (m_Callback) 
+        if (m_IsStopping.load(std::memory_order_relaxed))
         {
-            (*m_Callback)(this, m_ReturnedArg);
+            break;
         }
 
-        m_RunIndex = m_NextRunIndex;
+        {
+            BIOME_PROFILE_SCOPE(Run, "WorkerThread run", 0);
+            m_ReturnedArg = std::apply(m_Function, m_Arguments);
+
+            if (m_Callback) 
+            {
+                (*m_Callback)(this, m_ReturnedArg);
+            }
+        }
 
-        m_CondValue.notify_all();
-        m_CondValue.wait(lck, [&] { return m_RunIndex < m_NextRunIndex; });
+        // Release publishes the returned value to the waiting threads
+        m_RunIndex.store(runIndex, std::memory_order_release);
+        m_RunIndex.notify_all();
     }
 
+    // The function may have waited on a pool, which keeps a scratch arena in the heap
+    WorkerThreadPool::ReleaseThreadScratchArena();
     ThreadHeapAllocator::Shutdown();
 }
\ No newline at end of file
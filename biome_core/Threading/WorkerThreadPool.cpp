@@ -1,90 +1,562 @@
 #include <pch.h>
 #include "biome_core/Threading/WorkerThreadPool.h"
 #include "biome_core/Threading/WorkerTask.h"
+#include "biome_core/Threading/TaskCounter.h"
+
+#include <array>
+#include <cstring>
 
 using namespace biome::threading;
+using namespace biome::memory;
+
+thread_local WorkerThreadPool::Worker* WorkerThreadPool::s_pCurrentWorker = nullptr;
+thread_local ScopedArena* WorkerThreadPool::s_pScratchArena = nullptr;
+thread_local ScopedArena* WorkerThreadPool::s_pWaitScratchArena = nullptr;
+
+namespace
+{
+    uint32_t NextRandom(uint32_t &state)
+    {
+        // xorshift32, only used to spread thieves over victims
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
 
-WorkerThreadPool::WorkerThreadPool(const uint32_t threadCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize)
-    : m_AvailableWorkers(threadCount)
-    , m_Workers(threadCount, this, DoWork, perThreadHeapByteSize, perThreadInitialCommitByteSize)
-    , m_TaskQueue(threadCount)
-    , m_Thread(DispatchTasks, this, perThreadHeapByteSize, perThreadInitialCommitByteSize)
+WorkerThreadPool::WorkerThreadPool(const uint32_t threadCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize, uint32_t perThreadDequeCapacity)
+    : WorkerThreadPool(
+        std::array<WorkerGroupDesc, 1> { WorkerGroupDesc { "Worker", threadCount } }.data(),
+        1,
+        perThreadHeapByteSize,
+        perThreadInitialCommitByteSize,
+        perThreadDequeCapacity)
 {
+}
+
+WorkerThreadPool::WorkerThreadPool(const WorkerGroupDesc* pGroupDescs, uint32_t groupCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize, uint32_t perThreadDequeCapacity)
+    : m_Groups(groupCount)
+    , m_Workers(CountThreads(pGroupDescs, groupCount), this, perThreadDequeCapacity)
+{
+    BIOME_ASSERT_MSG(groupCount > 0, "WorkerThreadPool needs at least one worker group");
+
+    // All the deques must exist before any worker starts stealing
+    uint32_t workerIndex = 0;
+
+    for (uint32_t groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+    {
+        const WorkerGroupDesc& desc = pGroupDescs[groupIndex];
+        BIOME_ASSERT_MSG(desc.m_ThreadCount > 0, "Every worker group needs at least one worker");
+
+        WorkerGroup& group = m_Groups[groupIndex];
+        group.m_Desc = desc;
+        group.m_FirstWorkerIndex = workerIndex;
+        group.m_WorkerCount = desc.m_ThreadCount;
+
+        for (TaskQueue& taskQueue : group.m_TaskQueues)
+        {
+            taskQueue.m_Tasks.Init(desc.m_ThreadCount * perThreadDequeCapacity);
+        }
+
+        for (uint32_t index = 0; index < desc.m_ThreadCount; ++index, ++workerIndex)
+        {
+            Worker& worker = m_Workers[workerIndex];
+            worker.m_Index = workerIndex;
+            worker.m_GroupIndex = groupIndex;
+            worker.m_RandomState = 0x9E3779B9u * (workerIndex + 1);
+        }
+    }
+
     for (Worker& worker : m_Workers)
     {
-        m_AvailableWorkers.Add(&worker);
+        worker.m_Thread = std::thread(WorkerMain, &worker, perThreadHeapByteSize, perThreadInitialCommitByteSize);
     }
 }
 
 WorkerThreadPool::~WorkerThreadPool()
 {
-    m_isRunning = false;
-    m_CondValue.notify_all();
-    m_Thread.join();
+    m_isRunning.store(false);
+
+    // A worker checks `m_isRunning` under its group lock before parking
+    for (WorkerGroup& group : m_Groups)
+    {
+        {
+            std::lock_guard<std::mutex> lck(group.m_Mutex);
+        }
+
+        group.m_CondValue.notify_all();
+    }
+
+    for (Worker& worker : m_Workers)
+    {
+        worker.m_Thread.join();
+    }
 }
 
 void WorkerThreadPool::QueueTask(WorkerTask* const pTask)
 {
+    QueueTask(pTask, GetCurrentGroupIndex());
+}
+
+void WorkerThreadPool::QueueTask(WorkerTask* const pTask, uint32_t groupIndex)
+{
+    BIOME_ASSERT_MSG(groupIndex < GetGroupCount(), "Invalid worker group");
+
+    pTask->m_GroupIndex = groupIndex;
+
+    // Tasks waiting on dependencies are pushed by the completion of their last dependency
+    if (pTask->ReleaseDependency())
+    {
+        PushTask(pTask);
+    }
+}
+
+void WorkerThreadPool::QueueTasks(std::span<WorkerTask* const> tasks)
+{
+    QueueTasks(tasks, GetCurrentGroupIndex());
+}
+
+void WorkerThreadPool::QueueTasks(std::span<WorkerTask* const> tasks, uint32_t groupIndex)
+{
+    BIOME_ASSERT_MSG(groupIndex < GetGroupCount(), "Invalid worker group");
+
+    uint32_t readyTaskCount = 0;
+
+    for (WorkerTask* const pTask : tasks)
+    {
+        pTask->m_GroupIndex = groupIndex;
+
+        if (pTask->ReleaseDependency())
+        {
+            EnqueueTask(pTask);
+            ++readyTaskCount;
+        }
+    }
+
+    // A single wake up round for the whole batch
+    if (readyTaskCount > 0)
+    {
+        WakeWorkers(m_Groups[groupIndex], readyTaskCount);
+    }
+}
+
+void WorkerThreadPool::WaitFor(TaskCounter &counter)
+{
+    Worker* pWorker = s_pCurrentWorker;
+    if (pWorker != nullptr && pWorker->m_pThreadPool != this)
     {
-        std::lock_guard<std::mutex> lck(m_Mutex);
-        m_TaskQueue.Add(pTask);
+        pWorker = nullptr;
     }
 
-    m_CondValue.notify_all();
+    SpinWait spinWait;
+
+    // Threads without a scratch arena use the one kept for them, only set for this call
+    bool usesWaitScratchArena = false;
+
+    while (!counter.IsDone())
+    {
+        // Workers only help their own group, other threads help every group
+        WorkerTask* const pTask = pWorker != nullptr ? FindTask(pWorker) : FindTaskInAnyGroup();
+
+        if (pTask != nullptr)
+        {
+            if (s_pScratchArena == nullptr && ThreadHeapAllocator::IsInitialized())
+            {
+                if (s_pWaitScratchArena == nullptr)
+                {
+                    s_pWaitScratchArena = new ScopedArena(m_Groups[DefaultGroupIndex].m_Desc.m_ScratchByteSize);
+                }
+
+                s_pScratchArena = s_pWaitScratchArena;
+                usesWaitScratchArena = true;
+            }
+
+            ExecuteTask(pTask);
+            spinWait.Reset();
+        }
+        else if (!spinWait.Spin())
+        {
+            if (pWorker == nullptr)
+            {
+                // The workers run whatever is left, block instead of burning a core
+                counter.Wait();
+            }
+            else
+            {
+                // A worker never blocks, the tasks it waits for may need it to run
+                spinWait.Reset();
+            }
+        }
+    }
+
+    if (usesWaitScratchArena)
+    {
+        s_pScratchArena = nullptr;
+    }
+}
+
+void WorkerThreadPool::ReleaseThreadScratchArena()
+{
+    BIOME_ASSERT_MSG(s_pWaitScratchArena == nullptr || s_pScratchArena != s_pWaitScratchArena, "The scratch arena is in use by WaitFor");
+
+    delete s_pWaitScratchArena;
+    s_pWaitScratchArena = nullptr;
+}
+
+uint32_t WorkerThreadPool::GetCurrentGroupIndex() const
+{
+    const Worker* const pWorker = s_pCurrentWorker;
+    return (pWorker != nullptr && pWorker->m_pThreadPool == this) ? pWorker->m_GroupIndex : DefaultGroupIndex;
+}
+
+uint32_t WorkerThreadPool::FindGroup(const char *pName) const
+{
+    for (uint32_t groupIndex = 0; groupIndex < GetGroupCount(); ++groupIndex)
+    {
+        if (std::strcmp(m_Groups[groupIndex].m_Desc.m_pName, pName) == 0)
+        {
+            return groupIndex;
+        }
+    }
+
+    return InvalidGroupIndex;
 }
 
-WorkerThreadPool::Worker* WorkerThreadPool::DoWork(Worker* pWorker) noexcept
+uint32_t WorkerThreadPool::CountThreads(const WorkerGroupDesc* pGroupDescs, uint32_t groupCount)
 {
-    pWorker->m_pTask->DoWork();
-    return pWorker;
+    uint32_t threadCount = 0;
+
+    for (uint32_t groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+    {
+        threadCount += pGroupDescs[groupIndex].m_ThreadCount;
+    }
+
+    return threadCount;
 }
 
-void WorkerThreadPool::WorkDone(const WorkerType* pThread, Worker* pWorker) noexcept
+void WorkerThreadPool::PushTask(WorkerTask* const pTask)
 {
-    pWorker->m_pThreadPool->OnWorkDone(pWorker);
+    // The task can run, and be deleted, as soon as it is enqueued
+    WorkerGroup& group = m_Groups[pTask->m_GroupIndex];
+
+    EnqueueTask(pTask);
+    WakeWorkers(group, 1);
 }
 
-void WorkerThreadPool::OnWorkDone(Worker* const pWorker)
+void WorkerThreadPool::EnqueueTask(WorkerTask* const pTask)
 {
-    pWorker->m_pTask->OnWorkDone();
-    pWorker->m_pTask = nullptr;
+    Worker* pWorker = s_pCurrentWorker;
+    WorkerGroup& group = m_Groups[pTask->m_GroupIndex];
+
+#if BIOME_TASK_PROFILER
+    pTask->m_QueuedTimestamp = TaskProfiler::GetTimestamp();
+#endif
 
+    // Normal priority tasks spawned by a task stay local to its worker unless they target
+    // another group or the deque is full
+    const bool isLocalWorker = pWorker != nullptr && pWorker->m_pThreadPool == this && pWorker->m_GroupIndex == pTask->m_GroupIndex;
+
+    if (pTask->m_Priority == TaskPriority::Normal && isLocalWorker && pWorker->m_Deque.Push(pTask))
     {
-        std::lock_guard<std::mutex> lck(m_Mutex);
-        m_AvailableWorkers.Add(pWorker);
+        return;
     }
 
-    m_CondValue.notify_all();
+    TaskQueue& taskQueue = group.m_TaskQueues[static_cast<uint32_t>(pTask->m_Priority)];
+
+    if (!taskQueue.m_Tasks.TryPush(pTask))
+    {
+        std::lock_guard<std::mutex> lck(group.m_Mutex);
+
+        if (taskQueue.m_pLastOverflowTask != nullptr)
+        {
+            taskQueue.m_pLastOverflowTask->m_pNextQueued = pTask;
+        }
+        else
+        {
+            taskQueue.m_pFirstOverflowTask = pTask;
+        }
+
+        taskQueue.m_pLastOverflowTask = pTask;
+        taskQueue.m_OverflowTaskCount.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
-void WorkerThreadPool::DispatchTasks(WorkerThreadPool* pThreadPool, size_t heapByteSize, size_t initialCommitByteSize)
+void WorkerThreadPool::WorkerMain(Worker* pWorker, size_t heapByteSize, size_t initialCommitByteSize)
 {
+    const WorkerGroup& group = pWorker->m_pThreadPool->m_Groups[pWorker->m_GroupIndex];
+
+    char threadName[64];
+    snprintf(threadName, sizeof(threadName), "%s %u", group.m_Desc.m_pName, pWorker->m_Index - group.m_FirstWorkerIndex);
+
+    SetCurrentThreadName(threadName);
+    BIOME_PROFILE_THREAD_NAME(threadName);
+    SetCurrentThreadAffinity(group.m_Desc.m_AffinityMask);
+    SetCurrentThreadPriority(group.m_Desc.m_Priority);
+
     BIOME_ASSERT_ALWAYS_EXEC(ThreadHeapAllocator::Initialize(heapByteSize, initialCommitByteSize));
-    pThreadPool->m_isRunning = true;
-    pThreadPool->OnDispatchTasks();
+
+    {
+        // Allocated from the worker's heap, released before the heap shuts down
+        ScopedArena scratchArena(group.m_Desc.m_ScratchByteSize);
+
+        s_pCurrentWorker = pWorker;
+        s_pScratchArena = &scratchArena;
+
+        pWorker->m_pThreadPool->RunWorker(pWorker);
+
+        s_pScratchArena = nullptr;
+        s_pCurrentWorker = nullptr;
+    }
+
+    ThreadHeapAllocator::Shutdown();
 }
 
-void WorkerThreadPool::OnDispatchTasks()
+void WorkerThreadPool::RunWorker(Worker* const pWorker)
 {
-    std::unique_lock<std::mutex> lck(m_Mutex);
+    WorkerGroup& group = m_Groups[pWorker->m_GroupIndex];
+    SpinWait spinWait;
 
-    while (m_isRunning)
+    while (true)
     {
-        if (m_TaskQueue.Size() > 0 && m_AvailableWorkers.Size() > 0)
+        WorkerTask* pTask = FindTask(pWorker);
+
+        if (pTask != nullptr)
+        {
+            ExecuteTask(pTask);
+            spinWait.Reset();
+        }
+        else if (!m_isRunning.load(std::memory_order_acquire))
         {
-            WorkerTask* pTask = m_TaskQueue.PopBack();
-            Worker* pWorker = m_AvailableWorkers.PopBack();
+            // Queues are drained, nothing can be queued anymore
+            break;
+        }
+        else if (!spinWait.Spin())
+        {
+            Park(group);
+            spinWait.Reset();
+        }
+    }
+}
+
+ScopedArena& WorkerThreadPool::GetScratchArena()
+{
+    BIOME_ASSERT_MSG(s_pScratchArena != nullptr, "The calling thread has no scratch arena, see WorkerThreadPool::SetThreadScratchArena");
+    return *s_pScratchArena;
+}
+
+void WorkerThreadPool::ExecuteTask(WorkerTask* const pTask)
+{
+    // Covers the completion too, and never touches the task once it ends
+    BIOME_PROFILE_SCOPE(Task, pTask->GetName(), pTask->m_QueuedTimestamp);
+
+    ScopedArena* const pScratchArena = s_pScratchArena;
+    const ScopedArena::Marker scratchMarker = pScratchArena != nullptr ? pScratchArena->GetMarker() : ScopedArena::Marker {};
+    const bool isDetached = pTask->m_IsDetached;
+
+    if (isDetached)
+    {
+        // The task can be destroyed or queued again by `DoWork`, make it ready first
+        pTask->m_UnfinishedDependencyCount.store(1, std::memory_order_relaxed);
+    }
+
+    pTask->DoWork();
+
+    if (pScratchArena != nullptr)
+    {
+        pScratchArena->Rewind(scratchMarker);
+    }
+
+    if (!isDetached && pTask->ReleaseWork())
+    {
+        CompleteTask(pTask);
+    }
+}
 
-            lck.unlock();
+void WorkerThreadPool::CompleteTask(WorkerTask* pTask)
+{
+    while (pTask != nullptr)
+    {
+        // The task can be deleted or queued again from `OnWorkDone`, copy its links and
+        // reset it first
+        WorkerTask* pContinuations[WorkerTask::MaxContinuationCount];
+        const uint32_t continuationCount = pTask->m_ContinuationCount;
+        std::copy_n(pTask->m_pContinuations, continuationCount, pContinuations);
+        WorkerTask* const pParent = pTask->m_pParent;
+        TaskCounter* const pCounter = pTask->m_pCounter;
+
+        pTask->m_UnfinishedDependencyCount.store(1, std::memory_order_relaxed);
+        pTask->m_UnfinishedWorkCount.store(1, std::memory_order_relaxed);
+        pTask->m_ContinuationCount = 0;
+        pTask->m_pParent = nullptr;
+        pTask->m_pCounter = nullptr;
+
+        pTask->OnWorkDone();
+
+        // Continuations run in the group they were queued to
+        for (uint32_t index = 0; index < continuationCount; ++index)
+        {
+            if (pContinuations[index]->ReleaseDependency())
             {
-                pWorker->m_pTask = pTask;
-                pWorker->m_WorkerThread.Run(WorkDone, pWorker);
+                PushTask(pContinuations[index]);
             }
-            lck.lock();
+        }
+
+        if (pCounter != nullptr)
+        {
+            pCounter->Decrement();
+        }
+
+        // The last child to complete completes its parent
+        pTask = (pParent != nullptr && pParent->ReleaseWork()) ? pParent : nullptr;
+    }
+}
+
+WorkerTask* WorkerThreadPool::FindTask(Worker* const pWorker)
+{
+    WorkerGroup& group = m_Groups[pWorker->m_GroupIndex];
+    WorkerTask* pTask = PopInjectedTask(group, TaskPriority::High);
+
+    if (pTask != nullptr || pWorker->m_Deque.Pop(pTask))
+    {
+        return pTask;
+    }
+
+    pTask = PopInjectedTask(group, TaskPriority::Normal);
+    pTask = pTask != nullptr ? pTask : StealTask(group, pWorker, NextRandom(pWorker->m_RandomState));
+
+    return pTask != nullptr ? pTask : PopInjectedTask(group, TaskPriority::Low);
+}
+
+WorkerTask* WorkerThreadPool::FindTaskInAnyGroup()
+{
+    for (WorkerGroup& group : m_Groups)
+    {
+        WorkerTask* pTask = PopInjectedTask(group, TaskPriority::High);
+        pTask = pTask != nullptr ? pTask : PopInjectedTask(group, TaskPriority::Normal);
+        pTask = pTask != nullptr ? pTask : StealTask(group, nullptr, 0);
+        pTask = pTask != nullptr ? pTask : PopInjectedTask(group, TaskPriority::Low);
+
+        if (pTask != nullptr)
+        {
+            return pTask;
+        }
+    }
+
+    return nullptr;
+}
+
+WorkerTask* WorkerThreadPool::PopInjectedTask(WorkerGroup &group, TaskPriority priority)
+{
+    TaskQueue& taskQueue = group.m_TaskQueues[static_cast<uint32_t>(priority)];
+    WorkerTask* pTask = nullptr;
+
+    if (taskQueue.m_Tasks.TryPop(pTask))
+    {
+        return pTask;
+    }
+
+    if (taskQueue.m_OverflowTaskCount.load(std::memory_order_relaxed) == 0)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lck(group.m_Mutex);
+
+    pTask = taskQueue.m_pFirstOverflowTask;
+
+    if (pTask == nullptr)
+    {
+        return nullptr;
+    }
+
+    taskQueue.m_pFirstOverflowTask = pTask->m_pNextQueued;
+    taskQueue.m_pLastOverflowTask = taskQueue.m_pFirstOverflowTask != nullptr ? taskQueue.m_pLastOverflowTask : nullptr;
+    pTask->m_pNextQueued = nullptr;
+
+    taskQueue.m_OverflowTaskCount.fetch_sub(1, std::memory_order_relaxed);
+    return pTask;
+}
+
+WorkerTask* WorkerThreadPool::StealTask(const WorkerGroup &group, const Worker* const pThief, uint32_t firstVictim)
+{
+    for (uint32_t offset = 0; offset < group.m_WorkerCount; ++offset)
+    {
+        Worker& victim = m_Workers[group.m_FirstWorkerIndex + (firstVictim + offset) % group.m_WorkerCount];
+
+        WorkerTask* pTask = nullptr;
+        if (&victim != pThief && victim.m_Deque.Steal(pTask))
+        {
+            BIOME_PROFILE_STEAL();
+            return pTask;
+        }
+    }
+
+    return nullptr;
+}
+
+bool WorkerThreadPool::HasQueuedTasks(const WorkerGroup &group) const
+{
+    for (const TaskQueue& taskQueue : group.m_TaskQueues)
+    {
+        if (!taskQueue.m_Tasks.IsEmpty() || taskQueue.m_OverflowTaskCount.load(std::memory_order_relaxed) > 0)
+        {
+            return true;
+        }
+    }
+
+    for (uint32_t index = 0; index < group.m_WorkerCount; ++index)
+    {
+        if (!m_Workers[group.m_FirstWorkerIndex + index].m_Deque.IsEmpty())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkerThreadPool::Park(WorkerGroup &group)
+{
+    std::unique_lock<std::mutex> lck(group.m_Mutex);
+
+    // Announce the worker before checking the queues one last time. A submitter pushes first
+    // and reads the parked count second, so either it sees this worker or this check sees its task.
+    group.m_ParkedWorkerCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_isRunning.load(std::memory_order_relaxed) && !HasQueuedTasks(group))
+    {
+        BIOME_PROFILE_SCOPE(Idle, "Idle", 0);
+        group.m_CondValue.wait(lck);
+    }
+
+    group.m_ParkedWorkerCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WorkerThreadPool::WakeWorkers(WorkerGroup &group, uint32_t taskCount)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint32_t parkedWorkerCount = group.m_ParkedWorkerCount.load(std::memory_order_relaxed);
+
+    if (parkedWorkerCount > 0)
+    {
+        // Taking the lock guarantees the parked workers are either waiting or still checking the queues
+        {
+            std::lock_guard<std::mutex> lck(group.m_Mutex);
+        }
+
+        if (taskCount >= parkedWorkerCount)
+        {
+            group.m_CondValue.notify_all();
         }
         else
         {
-            m_CondValue.wait(lck);
+            for (uint32_t index = 0; index < taskCount; ++index)
+            {
+                group.m_CondValue.notify_one();
+            }
         }
     }
 }
@@ -1,56 +1,176 @@
 #pragma once
 
-#include "biome_core/Threading/WorkerThread.h"
-#include "biome_core/DataStructures/Vector.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <span>
+
+#include "biome_core/Threading/WorkStealingDeque.h"
+#include "biome_core/Threading/MpmcQueue.h"
+#include "biome_core/Threading/ThreadSettings.h"
+#include "biome_core/Threading/WorkerTask.h"
+#include "biome_core/Memory/ScopedArena.h"
 #include "biome_core/DataStructures/StaticArray.h"
 
 namespace biome
 {
     namespace threading
     {
-        class WorkerTask;
+        class TaskCounter;
+
+        struct WorkerGroupDesc
+        {
+            static constexpr size_t DefaultScratchByteSize = MiB(1);
+
+            // Used to name the threads, must outlive the pool
+            const char*     m_pName { "Worker" };
+            uint32_t        m_ThreadCount { 0 };
+            // Logical cores the group's workers may run on, 0 for any core
+            uint64_t        m_AffinityMask { 0 };
+            ThreadPriority  m_Priority { ThreadPriority::Normal };
+            // Size of each worker's scratch arena, see `WorkerThreadPool::GetScratchArena`
+            size_t          m_ScratchByteSize { DefaultScratchByteSize };
+        };
 
+        // Work stealing thread pool.
+        //
+        // Every worker owns a deque of tasks. Tasks queued from a worker, i.e. from inside
+        // `WorkerTask::DoWork`, go to that worker's deque and are run in LIFO order while they
+        // are still hot in cache. Tasks queued from any other thread go to a shared injection
+        // queue, a lock-free `MpmcQueue` sized like the group's deques, which only falls back to
+        // a locked overflow list when full. An idle worker first pops its own deque, then takes from the injection queue
+        // and then steals the oldest task of another worker, starting from a random victim.
+        //
+        // Injection queues are FIFO, one per `TaskPriority`. High priority tasks are taken even
+        // before the worker's own deque and low priority ones only once nothing else can be
+        // found. Tasks which are not of normal priority always go through the injection queues.
+        // `QueueTasks` submits a batch and wakes as many parked workers as tasks became ready.
+        //
+        // Every worker owns a `ScopedArena` for the temporary memory of the task it runs,
+        // reachable from `DoWork` through `GetScratchArena`. The arena is rewound when `DoWork`
+        // returns, so allocations are pointer bumps which are never released one by one.
+        // Rewinding rather than resetting keeps the allocations of a task waiting further up the
+        // stack in `WaitFor`. Threads which are not workers get an arena for the tasks they run in
+        // `WaitFor` on their first call, kept until `ReleaseThreadScratchArena`, unless they set
+        // one with `SetThreadScratchArena`.
+        //
+        // A worker that finds nothing spins for a short while before parking on a condition
+        // variable, and submitters only take the lock to wake a worker when one is parked.
+        // Tasks still queued when the pool is destroyed are run before the workers exit.
+        //
+        // Tasks with dependencies, children or counters form a graph, see `WorkerTask`.
+        // `WaitFor` runs queued tasks on the calling thread until a counter reaches zero, so a
+        // task can wait for the work it spawned without taking a worker away from the pool.
+        //
+        // Workers are split in named groups, each with its own injection queue, affinity mask
+        // and priority, e.g. render workers pinned to physical cores and a low priority group
+        // for asset streaming. A task runs in the group it is queued to and workers only steal
+        // within their group. `QueueTask` without a group keeps the task in the group of the
+        // calling worker, or uses group 0 from other threads. Threads which are not workers
+        // help every group in `WaitFor`.
+        //
         class WorkerThreadPool
         {
         public:
 
-            WorkerThreadPool(const uint32_t threadCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize);
+            static constexpr uint32_t DefaultDequeCapacity = 1024;
+            static constexpr uint32_t DefaultGroupIndex = 0;
+            static constexpr uint32_t InvalidGroupIndex = std::numeric_limits<uint32_t>::max();
+
+            // Single group of `threadCount` workers
+            WorkerThreadPool(const uint32_t threadCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize, uint32_t perThreadDequeCapacity = DefaultDequeCapacity);
+            WorkerThreadPool(const WorkerGroupDesc* pGroupDescs, uint32_t groupCount, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize, uint32_t perThreadDequeCapacity = DefaultDequeCapacity);
             ~WorkerThreadPool();
 
-            void QueueTask(WorkerTask* const pTask);
+            WorkerThreadPool(const WorkerThreadPool&) = delete;
+            WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
 
-        private:
+            void        QueueTask(WorkerTask* const pTask);
+            void        QueueTask(WorkerTask* const pTask, uint32_t groupIndex);
+            void        QueueTasks(std::span<WorkerTask* const> tasks);
+            void        QueueTasks(std::span<WorkerTask* const> tasks, uint32_t groupIndex);
+            void        WaitFor(TaskCounter &counter);
+            uint32_t    GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.Size()); }
+            uint32_t    GetGroupCount() const { return static_cast<uint32_t>(m_Groups.Size()); }
+            uint32_t    GetGroupWorkerCount(uint32_t groupIndex) const { return m_Groups[groupIndex].m_WorkerCount; }
+            // Group of the calling worker, `DefaultGroupIndex` from other threads
+            uint32_t    GetCurrentGroupIndex() const;
+            uint32_t    FindGroup(const char *pName) const;
 
-            struct Worker;
-            static Worker* DoWork(Worker* worker) noexcept;
-            using WorkerType = WorkerThread<decltype(DoWork)>;
-            using WorkerFnctPtrType = decltype(&DoWork);
+            // Scratch arena of the calling thread, its allocations are valid until `DoWork` returns
+            static memory::ScopedArena& GetScratchArena();
+            static bool                 HasScratchArena() { return s_pScratchArena != nullptr; }
+            // Lets a thread which is not a worker, but runs tasks in `WaitFor`, provide a scratch arena
+            static void                 SetThreadScratchArena(memory::ScopedArena *pScratchArena) { s_pScratchArena = pScratchArena; }
+            // Releases the scratch arena `WaitFor` created for the calling thread, if any.
+            // It lives in the thread heap, release it before shutting the heap down.
+            static void                 ReleaseThreadScratchArena();
 
-            static void WorkDone(const WorkerType* pThread, Worker* pWorker) noexcept;
-            static void DispatchTasks(WorkerThreadPool* pThreadPool, size_t perThreadHeapByteSize, size_t perThreadInitialCommitByteSize);
+        private:
 
             struct Worker
             {
-                Worker(WorkerThreadPool* pThreadPool, WorkerFnctPtrType workerFnct, size_t heapByteSize, size_t initialCommitByteSize)
+                Worker(WorkerThreadPool* pThreadPool, uint32_t dequeCapacity)
                     : m_pThreadPool(pThreadPool)
-                    , m_WorkerThread(workerFnct, heapByteSize, initialCommitByteSize)
-                    , m_pTask(nullptr) {}
+                    , m_Deque(dequeCapacity) {}
 
-                WorkerThreadPool* m_pThreadPool;
-                WorkerType m_WorkerThread;
-                WorkerTask* m_pTask;
+                WorkerThreadPool*               m_pThreadPool;
+                WorkStealingDeque<WorkerTask*>  m_Deque;
+                std::thread                     m_Thread {};
+                uint32_t                        m_Index { 0 };
+                uint32_t                        m_GroupIndex { 0 };
+                uint32_t                        m_RandomState { 0 };
             };
 
-            void OnWorkDone(Worker* const pWorker);
-            void OnDispatchTasks();
+            struct TaskQueue
+            {
+                MpmcQueue<WorkerTask*>              m_Tasks {};
+                // Intrusive FIFO through `WorkerTask::m_pNextQueued`, used once `m_Tasks` is full.
+                // Guarded by the group mutex.
+                WorkerTask*                         m_pFirstOverflowTask { nullptr };
+                WorkerTask*                         m_pLastOverflowTask { nullptr };
+                std::atomic<uint32_t>               m_OverflowTaskCount { 0 };
+            };
+
+            struct WorkerGroup
+            {
+                WorkerGroupDesc                     m_Desc {};
+                uint32_t                            m_FirstWorkerIndex { 0 };
+                uint32_t                            m_WorkerCount { 0 };
+                TaskQueue                           m_TaskQueues[static_cast<uint32_t>(TaskPriority::Count)] {};
+                std::condition_variable             m_CondValue {};
+                std::mutex                          m_Mutex {};
+                std::atomic<uint32_t>               m_ParkedWorkerCount { 0 };
+            };
+
+            static uint32_t CountThreads(const WorkerGroupDesc* pGroupDescs, uint32_t groupCount);
+            static void WorkerMain(Worker* pWorker, size_t heapByteSize, size_t initialCommitByteSize);
+
+            void        RunWorker(Worker* const pWorker);
+            void        PushTask(WorkerTask* const pTask);
+            void        EnqueueTask(WorkerTask* const pTask);
+            void        ExecuteTask(WorkerTask* const pTask);
+            void        CompleteTask(WorkerTask* pTask);
+            WorkerTask* FindTask(Worker* const pWorker);
+            WorkerTask* FindTaskInAnyGroup();
+            WorkerTask* PopInjectedTask(WorkerGroup &group, TaskPriority priority);
+            WorkerTask* StealTask(const WorkerGroup &group, const Worker* const pThief, uint32_t firstVictim);
+            bool        HasQueuedTasks(const WorkerGroup &group) const;
+            void        Park(WorkerGroup &group);
+            void        WakeWorkers(WorkerGroup &group, uint32_t taskCount);
+
+            biome::data::StaticArray<WorkerGroup, biome::data::CleanConstructDestruct> m_Groups;
+            biome::data::StaticArray<Worker, biome::data::CleanConstructDestruct> m_Workers;
+            std::atomic<bool> m_isRunning { true };
 
-            biome::data::Vector<Worker*> m_AvailableWorkers;
-            biome::data::StaticArray<Worker> m_Workers;
-            biome::data::Vector<WorkerTask*> m_TaskQueue;
-            std::condition_variable m_CondValue {};
-            std::mutex m_Mutex {};
-            bool m_isRunning { false };
-            std::thread m_Thread;
+            // Worker owning the calling thread, null on threads which are not pool workers
+            thread_local static Worker* s_pCurrentWorker;
+            // Scratch arena of the calling thread, owned by `WorkerMain` on workers
+            thread_local static memory::ScopedArena* s_pScratchArena;
+            // Created by the first `WaitFor` of a thread without scratch arena, reused by the next ones
+            thread_local static memory::ScopedArena* s_pWaitScratchArena;
         };
     }
 }
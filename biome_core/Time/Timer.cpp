@@ -82,3 +82,15 @@ void Timer::Reset()
 {
 	pImpl->Reset();
 }
+
+uint64_t Timer::GetTimestamp()
+{
+	return static_cast<uint64_t>(TimerImpl::GetCurrentTime().QuadPart);
+}
+
+uint64_t Timer::GetTimestampFrequency()
+{
+	// Fixed at boot, query it once
+	static const uint64_t frequency = static_cast<uint64_t>(TimerImpl::GetFrequency().QuadPart);
+	return frequency;
+}
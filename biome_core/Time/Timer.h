@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 namespace biome::time
@@ -15,6 +16,11 @@ namespace biome::time
 		float GetElapsedSecondsSinceLastCall() const;
 		void Reset();
 
+		// Raw high resolution timestamp, in ticks of `GetTimestampFrequency` per second.
+		// Only meaningful relative to other timestamps of the same process.
+		static uint64_t GetTimestamp();
+		static uint64_t GetTimestampFrequency();
+
 	private:
 
 		struct TimerImpl;
@@ -12,7 +12,7 @@ namespace biome::render
     struct RenderPass
     {
         ShaderResourceLayoutHandle m_resourceLayout { Handle_NULL };
-        TextureHandle m_renderTargets[8] { Handle_NULL };
+        TextureHandle m_renderTargets[8] {};
         DescriptorHeapHandle m_descriptorHeap { Handle_NULL };
 
         biome::rhi::Rectangle scissorRect;
@@ -10,8 +10,8 @@ namespace biome::render
     struct RenderUnit
     {
         GfxPipelineHandle m_psoHdl { Handle_NULL };
-        BufferHandle m_indexBufferHdl { Handle_NULL };
-        BufferHandle m_vertexBufferHdl { Handle_NULL };
+        BufferHandle m_indexBufferHdl {};
+        BufferHandle m_vertexBufferHdl {};
         Matrix4x4 m_world {};
     };
 }
\ No newline at end of file
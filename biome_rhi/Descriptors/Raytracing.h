@@ -5,8 +5,8 @@ namespace biome::rhi::descriptors
     struct RayTracingInstanceDesc
     {
         Matrix4x4 m_Transform { math::IdentifyMatrix() };
-        BufferHandle m_IndexBuffer { Handle_NULL };
-        BufferHandle m_VertexPosBuffer { Handle_NULL };
+        BufferHandle m_IndexBuffer {};
+        BufferHandle m_VertexPosBuffer {};
         bool m_IsOpaque { true };
     };
 }
\ No newline at end of file
@@ -6,12 +6,20 @@
 #include "biome_core/Core/Defines.h"
 #include "biome_core/Math/Math.h"
 #include "biome_core/Handle/Handle.h"
+#include "biome_core/Handle/GenerationalHandle.h"
 #include "biome_core/DataStructures/StaticArray.h"
 
 namespace biome
 {
     namespace rhi
     {
+        namespace resources
+        {
+            struct Buffer;
+            struct Texture;
+            struct RtAccelerationStructure;
+        }
+
         struct alignas(sizeof(uintptr_t)) BasicHandle
         {
             uintptr_t m_handle { Handle_NULL };
@@ -45,8 +53,11 @@ namespace biome
         #define DefineHandle(name) \
             struct name : BasicHandle { name() = default; name(uintptr_t hdl) : BasicHandle(hdl){} }
 
-        DefineHandle(TextureHandle);
-        DefineHandle(BufferHandle);
+        // Resources owned by a device live in its handle tables, see `GpuDevice`
+        using TextureHandle = GenerationalHandle<resources::Texture>;
+        using BufferHandle = GenerationalHandle<resources::Buffer>;
+        using AccelerationStructureHandle = GenerationalHandle<resources::RtAccelerationStructure>;
+
         DefineHandle(GpuDeviceHandle);
         DefineHandle(CommandQueueHandle);
         DefineHandle(CommandBufferHandle);
@@ -56,7 +67,6 @@ namespace biome
         DefineHandle(GfxPipelineHandle);
         DefineHandle(ComputePipelineHandle);
         DefineHandle(DescriptorHeapHandle);
-        DefineHandle(AccelerationStructureHandle);
 
         typedef uintptr_t WindowHandle;
         typedef uintptr_t AppHandle;
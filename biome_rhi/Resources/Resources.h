@@ -1,20 +1,28 @@
 #pragma once
 
+#include <mutex>
+#include <span>
 #include "biome_rhi/Resources/ResourceHandles.h"
 #include "biome_rhi/Systems/SystemEnums.h"
 #include "biome_rhi/Descriptors/Formats.h"
 #include "biome_core/DataStructures/StaticArray.h"
 #include "biome_core/DataStructures/Vector.h"
+#include "biome_core/DataStructures/HandleTable.h"
 #include "biome_core/Memory/MemoryOffsetAllocator.h"
+#include "biome_core/Memory/SubAllocator.h"
 
 namespace biome::rhi
 {
     namespace resources
     {
+        struct GpuDevice;
+
         struct DescriptorHeap
         {
             ComPtr<ID3D12DescriptorHeap>    m_pDescriptorHeap { nullptr };
             MemoryOffsetAllocator           m_OffsetAllocator {};
+            // Descriptors are taken and released by textures created and destroyed from any thread
+            std::mutex                      m_Mutex {};
         };
 
         struct DescriptorHandle
@@ -34,6 +42,8 @@ namespace biome::rhi
 
         struct SwapChain
         {
+            // Owns the back buffer textures, destroyed with the swap chain
+            GpuDevice*                              m_pDevice { nullptr };
             ComPtr<IDXGISwapChain1>                 m_pSwapChain { nullptr };
             biome::data::StaticArray<TextureHandle> m_backBuffers {};
             uint32_t                                m_pixelWidth { 0 };
@@ -44,6 +54,7 @@ namespace biome::rhi
         {
             typedef biome::data::StaticArray<ComPtr<ID3D12CommandAllocator>, CleanConstructDestruct> AllocatorArray;
 
+            GpuDevice*                          m_pDevice { nullptr };
             DescriptorHeap*                     m_pViewDescriptorHeap { nullptr };
             AllocatorArray                      m_cmdAllocators {};
             ComPtr<ID3D12GraphicsCommandList7>  m_pCmdList { nullptr };
@@ -63,6 +74,11 @@ namespace biome::rhi
         struct Texture : public Resource
         {
             D3D12_CPU_DESCRIPTOR_HANDLE m_cbdbHandle {};
+            // Heap of `m_cbdbHandle`, the RTV or the DSV heap, null when the texture has neither view
+            DescriptorHeap* m_pCbdbHeap { nullptr };
+            uint32_t m_cbdbHeapOffset { 0 };
+            bool m_hasSrv { false };
+            bool m_hasUav { false };
             D3D12_BARRIER_ACCESS m_currentAccess { D3D12_BARRIER_ACCESS_COMMON };
             D3D12_BARRIER_LAYOUT m_currentLayout { D3D12_BARRIER_LAYOUT_COMMON };
             D3D12_SUBRESOURCE_FOOTPRINT m_footprint {};
@@ -82,6 +98,9 @@ namespace biome::rhi
         struct GpuDevice
         {
             static constexpr uint32_t                       UploadHeapByteSize = MiB(128);
+            static constexpr uint32_t                       MaxBufferCount = 16384;
+            static constexpr uint32_t                       MaxTextureCount = 8192;
+            static constexpr uint32_t                       MaxRtAccelerationStructureCount = 1024;
 
             ComPtr<ID3D12Device10>                          m_pDevice { nullptr };
             DescriptorHeap                                  m_RtvDescriptorHeap {};
@@ -92,9 +111,14 @@ namespace biome::rhi
         #ifdef _DEBUG
             ComPtr<IDXGIDebug>                              m_pDebug { nullptr };
         #endif
-            biome::data::StaticArray<CommandQueueHandle>    m_CommandQueues {};
-            biome::data::StaticArray<UploadHeap>            m_UploadHeaps {};
+            biome::memory::SubAllocator                     m_QueuesAndHeapsAllocation {};
+            std::span<CommandQueueHandle>                   m_CommandQueues {};
+            std::span<UploadHeap>                           m_UploadHeaps {};
             biome::data::Vector<CommandBuffer*>             m_CommandBuffers {};
+            // Resources may be created and destroyed from any thread
+            biome::data::HandleTable<Buffer, true>          m_Buffers {};
+            biome::data::HandleTable<Texture, true>         m_Textures {};
+            biome::data::HandleTable<RtAccelerationStructure, true> m_RtAccelerationStructures {};
             CommandBuffer                                   m_DmaCommandBuffer {};
             uint64_t                                        m_currentFrame { 0 };
             HANDLE                                          m_fenceEvent {};
@@ -161,32 +185,20 @@ namespace biome::rhi
         return hdl;
     }
 
-    inline Buffer* ToType(BufferHandle hdl)
-    {
-        Buffer* pBuffer;
-        AsType(pBuffer, hdl);
-        return pBuffer;
-    }
-
-    inline BufferHandle ToHandle(Buffer* pBuffer)
+    // Null for a null or stale handle
+    inline Buffer* ToType(const GpuDevice* pDevice, BufferHandle hdl)
     {
-        BufferHandle hdl;
-        AsHandle(pBuffer, hdl);
-        return hdl;
+        return pDevice->m_Buffers.Get(hdl);
     }
 
-    inline Texture* ToType(TextureHandle hdl)
+    inline Texture* ToType(const GpuDevice* pDevice, TextureHandle hdl)
     {
-        Texture* pTexture;
-        AsType(pTexture, hdl);
-        return pTexture;
+        return pDevice->m_Textures.Get(hdl);
     }
 
-    inline TextureHandle ToHandle(Texture* pTexture)
+    inline RtAccelerationStructure* ToType(const GpuDevice* pDevice, AccelerationStructureHandle hdl)
     {
-        TextureHandle hdl;
-        AsHandle(pTexture, hdl);
-        return hdl;
+        return pDevice->m_RtAccelerationStructures.Get(hdl);
     }
 
     inline DescriptorHeap* ToType(DescriptorHeapHandle hdl)
@@ -30,7 +30,7 @@ namespace biome::rhi
         template<typename HandleType>
         struct TransitionBarrier
         {
-            HandleType      m_ResourceHdl { Handle_NULL };
+            HandleType      m_ResourceHdl {};
             ResourceStates  m_BeforeState { ResourceStates::Unknown };
             ResourceStates  m_AfterState { ResourceStates::Unknown };
             uint32_t        m_SubRscIndex { 0 };
@@ -39,8 +39,8 @@ namespace biome::rhi
         template<typename HandleType>
         struct AliasingBarrier
         {
-            HandleType  m_ResourceBeforeHdl { Handle_NULL };
-            HandleType  m_ResourceAfterHdl { Handle_NULL };
+            HandleType  m_ResourceBeforeHdl {};
+            HandleType  m_ResourceAfterHdl {};
         };
 
         using TextureTransitionBarrier  = TransitionBarrier<TextureHandle>;
@@ -100,7 +100,7 @@ void commands::SetDescriptorHeaps(CommandBufferHandle cmdBufferHdl)
 void commands::SetGraphicsConstantBuffer(const CommandBufferHandle cmdBufferHdl, const BufferHandle cbvHandle, const uint32_t index)
 {
     CommandBuffer* pCmdBuffer = AsType<CommandBuffer>(cmdBufferHdl);
-    Buffer* pBuffer = AsType<Buffer>(cbvHandle);
+    Buffer* pBuffer = ToType(pCmdBuffer->m_pDevice, cbvHandle);
     pCmdBuffer->m_pCmdList->SetGraphicsRootConstantBufferView(index, pBuffer->m_pResource->GetGPUVirtualAddress());
 }
 
@@ -164,7 +164,7 @@ void commands::DrawIndexedInstanced(
 void commands::ClearDepthStencil(CommandBufferHandle cmdBufferHdl, TextureHandle depthStencilHdl)
 {
     CommandBuffer* pCmdBuffer = AsType<CommandBuffer>(cmdBufferHdl);
-    Texture* pDepthStencilTexture = AsType<Texture>(depthStencilHdl);
+    Texture* pDepthStencilTexture = ToType(pCmdBuffer->m_pDevice, depthStencilHdl);
 
     constexpr D3D12_CLEAR_FLAGS clearFlags = D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL;
     pCmdBuffer->m_pCmdList->ClearDepthStencilView(pDepthStencilTexture->m_cbdbHandle, clearFlags, 1.f, 0, 0, nullptr);
@@ -175,8 +175,7 @@ void commands::ClearRenderTarget(CommandBufferHandle cmdBufferHdl, TextureHandle
     CommandBuffer* pCmdBuffer;
     AsType(pCmdBuffer, cmdBufferHdl);
 
-    Texture* pTexture;
-    AsType(pTexture, renderTargetHdl);
+    Texture* pTexture = ToType(pCmdBuffer->m_pDevice, renderTargetHdl);
 
     pCmdBuffer->m_pCmdList->ClearRenderTargetView(pTexture->m_cbdbHandle, clearColor.f, 0, nullptr);
 }
@@ -184,7 +183,7 @@ void commands::ClearRenderTarget(CommandBufferHandle cmdBufferHdl, TextureHandle
 void commands::SetIndexBuffer(CommandBufferHandle cmdBufferHdl, BufferHandle indexBufferHdl)
 {
     CommandBuffer* const pCmdBuffer = AsType<CommandBuffer>(cmdBufferHdl);
-    Buffer* const pIndexBuffer = AsType<Buffer>(indexBufferHdl);
+    Buffer* const pIndexBuffer = ToType(pCmdBuffer->m_pDevice, indexBufferHdl);
 
     D3D12_INDEX_BUFFER_VIEW ibvDesc = {};
     ibvDesc.BufferLocation = pIndexBuffer->m_pResource->GetGPUVirtualAddress();
@@ -216,7 +215,7 @@ void commands::SetVertexBuffers(
     for (uint32_t i = 0; i < bufferCount; ++i)
     {
         const uint32_t slotIndex = startSlot + i;
-        Buffer* const pVertexBuffer = AsType<Buffer>(pVertexBufferHdls[i]);
+        Buffer* const pVertexBuffer = ToType(pCmdBuffer->m_pDevice, pVertexBufferHdls[i]);
 
         vbv[i].BufferLocation = pVertexBuffer->m_pResource->GetGPUVirtualAddress();
         vbv[i].SizeInBytes = pVertexBuffer->m_byteSize;
@@ -251,14 +250,14 @@ void commands::OMSetRenderTargets(
 
     for (uint32_t i = 0; i < rtCount; ++i)
     {
-        Texture* pRt = AsType<Texture>(pRenderTargets[i]);
+        Texture* pRt = ToType(pCmdBuffer->m_pDevice, pRenderTargets[i]);
         rtDescriptors[i] = pRt->m_cbdbHandle;
     }
 
     D3D12_CPU_DESCRIPTOR_HANDLE* pDsDescriptor = nullptr;
     if (pDepthStencil != nullptr)
     {
-        Texture* pDs = AsType<Texture>(*pDepthStencil);
+        Texture* pDs = ToType(pCmdBuffer->m_pDevice, *pDepthStencil);
         pDsDescriptor = &pDs->m_cbdbHandle;
     }
 
@@ -318,8 +317,7 @@ void commands::ResourceTransition(CommandBufferHandle cmdBufferHdl, const Textur
     {
         const TextureStateTransition& transition = transitions[i];
 
-        Texture* pTexture;
-        AsType(pTexture, transition.m_textureHdl);
+        Texture* pTexture = ToType(pCmdBuffer->m_pDevice, transition.m_textureHdl);
 
         D3D12_RESOURCE_BARRIER& barrier = pBarriers[i];
         barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -342,7 +340,7 @@ void commands::CopyBuffer(
     const uint32_t byteSize)
 {
     CommandBuffer* pCmdBuffer = AsType<CommandBuffer>(cmdBufferHdl);
-    Buffer* pSrcBuffer = AsType<Buffer>(srcHdl);
-    Buffer* pDstBuffer = AsType<Buffer>(dstHdl);
+    Buffer* pSrcBuffer = ToType(pCmdBuffer->m_pDevice, srcHdl);
+    Buffer* pDstBuffer = ToType(pCmdBuffer->m_pDevice, dstHdl);
     pCmdBuffer->m_pCmdList->CopyBufferRegion(pDstBuffer->m_pResource.Get(), dstOffset, pSrcBuffer->m_pResource.Get(), srcOffset, byteSize);
 }
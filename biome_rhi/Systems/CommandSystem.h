@@ -72,7 +72,7 @@ namespace biome::rhi
 
         struct TextureStateTransition
         {
-            TextureHandle m_textureHdl { Handle_NULL };
+            TextureHandle m_textureHdl {};
             ResourceState m_before {};
             ResourceState m_after {};
         };
@@ -521,7 +521,7 @@ namespace
     static ID3D12CommandQueue* GetCommandQueue(GpuDevice* pGpuDevice, CommandType type)
     {
         const uint32_t queueIndex = static_cast<uint32_t>(type);
-        BIOME_ASSERT(queueIndex < pGpuDevice->m_CommandQueues.Size());
+        BIOME_ASSERT(queueIndex < pGpuDevice->m_CommandQueues.size());
         return AsType<ID3D12CommandQueue>(pGpuDevice->m_CommandQueues[queueIndex]);
     }
 
@@ -545,11 +545,46 @@ namespace
             cmdAllocators[i] = CreateCommandAllocator(pDevice, cmdType);
         }
 
+        cmdBuffer.m_pDevice = pGpuDevice;
         cmdBuffer.m_type = type;
         cmdBuffer.m_pCmdList = CreateCommandList(pDevice, cmdAllocators[0].Get(), cmdType);
         cmdBuffer.m_cmdAllocators = std::move(cmdAllocators);
         cmdBuffer.m_pViewDescriptorHeap = &pGpuDevice->m_ResourceViewHeap;
     }
+
+    // Releases the descriptors of the texture along with it, the GPU must be done with both
+    static void DestroyTextureAndViews(GpuDevice* pGpuDevice, TextureHandle textureHdl)
+    {
+        // Back buffers which failed to be created are left null
+        if (textureHdl.IsNull())
+        {
+            return;
+        }
+
+        Texture* const pTexture = ToType(pGpuDevice, textureHdl);
+
+        if (pTexture == nullptr)
+        {
+            return;
+        }
+
+        if (pTexture->m_hasSrv)
+        {
+            util::ReleaseDescriptor(pGpuDevice->m_ResourceViewHeap, pTexture->m_srvHeapOffset);
+        }
+
+        if (pTexture->m_hasUav)
+        {
+            util::ReleaseDescriptor(pGpuDevice->m_ResourceViewHeap, pTexture->m_uavHeapOffset);
+        }
+
+        if (pTexture->m_pCbdbHeap != nullptr)
+        {
+            util::ReleaseDescriptor(*pTexture->m_pCbdbHeap, pTexture->m_cbdbHeapOffset);
+        }
+
+        pGpuDevice->m_Textures.Destroy(textureHdl);
+    }
 }
 
 void device::StartFrame(GpuDeviceHandle deviceHdl)
@@ -780,6 +815,9 @@ GpuDeviceHandle device::CreateDevice(const uint32_t framesOfLatency, const bool
     pGpuDevice->m_pCopyFence = pCopyFence;
     pGpuDevice->m_fenceEvent = fenceEvent;
     pGpuDevice->m_framesOfLatency = framesOfLatency;
+    pGpuDevice->m_Buffers.Init(GpuDevice::MaxBufferCount);
+    pGpuDevice->m_Textures.Init(GpuDevice::MaxTextureCount);
+    pGpuDevice->m_RtAccelerationStructures.Init(GpuDevice::MaxRtAccelerationStructureCount);
 
     const size_t rtvDescriptorCount = rtvHeapDesc.NumDescriptors;
     const size_t rtvDescriptorSize = pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
@@ -803,28 +841,30 @@ GpuDeviceHandle device::CreateDevice(const uint32_t framesOfLatency, const bool
     pGpuDevice->m_pDebug = pDxgiDebug;
 #endif
 
-    StaticArray<UploadHeap> uploadHeaps(framesOfLatency + 1);
-    for (size_t i = 0; i < uploadHeaps.Size(); ++i)
+    // Upload heaps and command queues share a single allocation
+    const size_t queueTypeCount = static_cast<size_t>(CommandType::Count);
+    memory::SubAllocator& queuesAndHeapsAllocation = pGpuDevice->m_QueuesAndHeapsAllocation;
+    const memory::SubRange<UploadHeap> uploadHeapsRange = queuesAndHeapsAllocation.Accumulate<UploadHeap>(framesOfLatency + 1);
+    const memory::SubRange<CommandQueueHandle> commandQueuesRange = queuesAndHeapsAllocation.Accumulate<CommandQueueHandle>(queueTypeCount);
+    queuesAndHeapsAllocation.Allocate();
+
+    pGpuDevice->m_UploadHeaps = queuesAndHeapsAllocation.Get(uploadHeapsRange);
+    for (UploadHeap& uploadHeap : pGpuDevice->m_UploadHeaps)
     {
-        uploadHeaps[i].m_heapByteSize = GpuDevice::UploadHeapByteSize;
-        uploadHeaps[i].m_currentUploadHeapIndex = 0;
-        uploadHeaps[i].m_currentUploadHeapOffset = 0;
-        BIOME_ASSERT_ALWAYS_EXEC(SUCCEEDED(AddUploadBuffer(pDevice.Get(), uploadHeaps[i])));
+        new (&uploadHeap) UploadHeap();
+        uploadHeap.m_heapByteSize = GpuDevice::UploadHeapByteSize;
+        uploadHeap.m_currentUploadHeapIndex = 0;
+        uploadHeap.m_currentUploadHeapOffset = 0;
+        BIOME_ASSERT_ALWAYS_EXEC(SUCCEEDED(AddUploadBuffer(pDevice.Get(), uploadHeap)));
     }
 
-    pGpuDevice->m_UploadHeaps = std::move(uploadHeaps);
-
-    const size_t queueTypeCount = static_cast<size_t>(CommandType::Count);
-    StaticArray<CommandQueueHandle> commandQueues(queueTypeCount);
-
+    pGpuDevice->m_CommandQueues = queuesAndHeapsAllocation.Get(commandQueuesRange);
     for (size_t queueIndex = 0; queueIndex < queueTypeCount; ++queueIndex)
     {
         const CommandType cmdType = static_cast<CommandType>(queueIndex);
-        commandQueues[queueIndex] = CreateCommandQueue(pGpuDevice, cmdType);
+        pGpuDevice->m_CommandQueues[queueIndex] = CreateCommandQueue(pGpuDevice, cmdType);
     }
 
-    pGpuDevice->m_CommandQueues = std::move(commandQueues);
-
     FillCommandBuffer(pGpuDevice, CommandType::Copy, pGpuDevice->m_DmaCommandBuffer);
 
     AsHandle(pGpuDevice, deviceHdl);
@@ -890,6 +930,7 @@ SwapChainHandle device::CreateSwapChain(
             swapChainDesc.SampleDesc.Count = 1;
 
             SwapChain* pInternalSwapChain = new SwapChain();
+            pInternalSwapChain->m_pDevice = pGpuDevice;
             pInternalSwapChain->m_pixelWidth = pixelWidth;
             pInternalSwapChain->m_pixelHeight = pixelHeight;
 
@@ -908,17 +949,31 @@ SwapChainHandle device::CreateSwapChain(
                 StaticArray<TextureHandle> backBufferHandles(backBufferCount);
                 for (uint32_t i = 0; i < backBufferCount; ++i)
                 {
+                    // Stays null when the buffer can't be retrieved, `DestroySwapChain` skips it
+                    backBufferHandles[i] = TextureHandle();
+
                     ID3D12Resource* pResource;
                     const HRESULT hr = pInternalSwapChain->m_pSwapChain->GetBuffer(i, IID_PPV_ARGS(&pResource));
                     if (SUCCEEDED(hr))
                     {
+                        const TextureHandle textureHdl = pGpuDevice->m_Textures.Create();
+                        Texture* pTexture = ToType(pGpuDevice, textureHdl);
+
+                        if (pTexture == nullptr)
+                        {
+                            pResource->Release();
+                            continue;
+                        }
+
                         const DescriptorHandle rtvHandle = util::GetDescriptorHandle(pGpuDevice->m_RtvDescriptorHeap);
                         pGpuDevice->m_pDevice->CreateRenderTargetView(pResource, nullptr, rtvHandle.m_cpuHandle);
 
-                        Texture* pTexture = new Texture();
-                        pTexture->m_pResource = pResource;
+                        // `GetBuffer` already added the reference the texture keeps
+                        pTexture->m_pResource.Attach(pResource);
                         pTexture->m_cbdbHandle = rtvHandle.m_cpuHandle;
-                        AsHandle(pTexture, backBufferHandles[i]);
+                        pTexture->m_pCbdbHeap = &pGpuDevice->m_RtvDescriptorHeap;
+                        pTexture->m_cbdbHeapOffset = rtvHandle.m_heapOffset;
+                        backBufferHandles[i] = textureHdl;
                     }
                 }
 
@@ -957,7 +1012,7 @@ TextureHandle device::GetBackBuffer(GpuDeviceHandle deviceHdl, SwapChainHandle h
         return pInternalSwapChain->m_backBuffers[index];
     }
 
-    return Handle_NULL;
+    return {};
 }
 
 bool device::IsRaytracingSupported(GpuDeviceHandle deviceHdl)
@@ -1201,7 +1256,6 @@ BufferHandle device::CreateBuffer(
     const uint32_t stride,
     const Format format)
 {
-    BufferHandle bufferHdl = Handle_NULL;
     GpuDevice* pDevice = ToType(deviceHdl);
 
     // TODO: Use placed resources
@@ -1221,7 +1275,13 @@ BufferHandle device::CreateBuffer(
 
     constexpr D3D12_RESOURCE_STATES nativeRscState = D3D12_RESOURCE_STATE_COMMON;
 
-    std::unique_ptr<Buffer> spBuffer = std::make_unique<Buffer>();
+    const BufferHandle bufferHdl = pDevice->m_Buffers.Create();
+    Buffer* pBuffer = ToType(pDevice, bufferHdl);
+
+    if (pBuffer == nullptr)
+    {
+        return {};
+    }
 
     D3D12_HEAP_PROPERTIES heapProps;
     heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
@@ -1236,19 +1296,19 @@ BufferHandle device::CreateBuffer(
         &rscDesc,
         nativeRscState,
         nullptr,
-        IID_PPV_ARGS(spBuffer->m_pResource.ReleaseAndGetAddressOf()));
+        IID_PPV_ARGS(pBuffer->m_pResource.ReleaseAndGetAddressOf()));
 
     if (FAILED(hr))
     {
-        return bufferHdl;
+        pDevice->m_Buffers.Destroy(bufferHdl);
+        return {};
     }
 
-    spBuffer->m_byteSize = bufferByteSize;
-    spBuffer->m_format = format;
-    spBuffer->m_stride = stride;
+    pBuffer->m_byteSize = bufferByteSize;
+    pBuffer->m_format = format;
+    pBuffer->m_stride = stride;
 
-    Buffer* pBuffer = spBuffer.release();
-    return ToHandle(pBuffer);
+    return bufferHdl;
 }
 
 TextureHandle device::CreateTexture(
@@ -1286,7 +1346,13 @@ TextureHandle device::CreateTexture(
 
     D3D12_RESOURCE_STATES nativeRscState = D3D12_RESOURCE_STATE_COMMON;
 
-    std::unique_ptr<Texture> spTexture = std::make_unique<Texture>();
+    const TextureHandle textureHdl = pDevice->m_Textures.Create();
+    Texture* pTexture = ToType(pDevice, textureHdl);
+
+    if (pTexture == nullptr)
+    {
+        return {};
+    }
 
     D3D12_HEAP_PROPERTIES heapProps;
     heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
@@ -1318,10 +1384,10 @@ TextureHandle device::CreateTexture(
 
     D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint {};
     pDevice->m_pDevice->GetCopyableFootprints(&rscDesc, 0, 1, 0, &footprint, nullptr, nullptr, nullptr);
-    spTexture->m_footprint = footprint.Footprint;
+    pTexture->m_footprint = footprint.Footprint;
 
     const D3D12_RESOURCE_ALLOCATION_INFO allocInfo = pDevice->m_pDevice->GetResourceAllocationInfo(0, 1, &rscDesc);
-    spTexture->m_byteSize = static_cast<uint32_t>(allocInfo.SizeInBytes);
+    pTexture->m_byteSize = static_cast<uint32_t>(allocInfo.SizeInBytes);
 
     const HRESULT hr = pDevice->m_pDevice->CreateCommittedResource(
         &heapProps,
@@ -1329,11 +1395,12 @@ TextureHandle device::CreateTexture(
         &rscDesc,
         nativeRscState,
         pClearValue,
-        IID_PPV_ARGS(spTexture->m_pResource.ReleaseAndGetAddressOf()));
+        IID_PPV_ARGS(pTexture->m_pResource.ReleaseAndGetAddressOf()));
 
     if (FAILED(hr))
     {
-        return Handle_NULL;
+        pDevice->m_Textures.Destroy(textureHdl);
+        return {};
     }
 
     if (allowSrv)
@@ -1348,8 +1415,9 @@ TextureHandle device::CreateTexture(
         srvDesc.Texture2D.ResourceMinLODClamp = 0.f;
 
         const DescriptorHandle srvHandle = util::GetDescriptorHandle(pDevice->m_ResourceViewHeap);
-        pDevice->m_pDevice->CreateShaderResourceView(spTexture->m_pResource.Get(), &srvDesc, srvHandle.m_cpuHandle);
-        spTexture->m_srvHeapOffset = srvHandle.m_heapOffset;
+        pDevice->m_pDevice->CreateShaderResourceView(pTexture->m_pResource.Get(), &srvDesc, srvHandle.m_cpuHandle);
+        pTexture->m_srvHeapOffset = srvHandle.m_heapOffset;
+        pTexture->m_hasSrv = true;
     }
 
     if (allowUav)
@@ -1361,25 +1429,29 @@ TextureHandle device::CreateTexture(
         uavDesc.Texture2D.PlaneSlice = 0;
 
         const DescriptorHandle uavHandle = util::GetDescriptorHandle(pDevice->m_ResourceViewHeap);
-        pDevice->m_pDevice->CreateUnorderedAccessView(spTexture->m_pResource.Get(), nullptr, &uavDesc, uavHandle.m_cpuHandle);
-        spTexture->m_uavHeapOffset = uavHandle.m_heapOffset;
+        pDevice->m_pDevice->CreateUnorderedAccessView(pTexture->m_pResource.Get(), nullptr, &uavDesc, uavHandle.m_cpuHandle);
+        pTexture->m_uavHeapOffset = uavHandle.m_heapOffset;
+        pTexture->m_hasUav = true;
     }
 
     if (allowDsv)
     {
         const DescriptorHandle dsvHandle = util::GetDescriptorHandle(pDevice->m_DsvDescriptorHeap);
-        pDevice->m_pDevice->CreateDepthStencilView(spTexture->m_pResource.Get(), nullptr, dsvHandle.m_cpuHandle);
-        spTexture->m_cbdbHandle = dsvHandle.m_cpuHandle;
+        pDevice->m_pDevice->CreateDepthStencilView(pTexture->m_pResource.Get(), nullptr, dsvHandle.m_cpuHandle);
+        pTexture->m_cbdbHandle = dsvHandle.m_cpuHandle;
+        pTexture->m_pCbdbHeap = &pDevice->m_DsvDescriptorHeap;
+        pTexture->m_cbdbHeapOffset = dsvHandle.m_heapOffset;
     }
     else if (allowRtv)
     {
         const DescriptorHandle rtvHandle = util::GetDescriptorHandle(pDevice->m_RtvDescriptorHeap);
-        pDevice->m_pDevice->CreateRenderTargetView(spTexture->m_pResource.Get(), nullptr, rtvHandle.m_cpuHandle);
-        spTexture->m_cbdbHandle = rtvHandle.m_cpuHandle;
+        pDevice->m_pDevice->CreateRenderTargetView(pTexture->m_pResource.Get(), nullptr, rtvHandle.m_cpuHandle);
+        pTexture->m_cbdbHandle = rtvHandle.m_cpuHandle;
+        pTexture->m_pCbdbHeap = &pDevice->m_RtvDescriptorHeap;
+        pTexture->m_cbdbHeapOffset = rtvHandle.m_heapOffset;
     }
 
-    Texture* pTexture = spTexture.release();
-    return AsHandle<TextureHandle>(pTexture);
+    return textureHdl;
 }
 
 AccelerationStructureHandle device::CreateRtAccelerationStructure(
@@ -1387,13 +1459,19 @@ AccelerationStructureHandle device::CreateRtAccelerationStructure(
     const RayTracingInstanceDesc* const pRtInstances,
     const uint32_t instanceCount)
 {
-    std::unique_ptr<RtAccelerationStructure> spAs = std::make_unique<RtAccelerationStructure>();
+    GpuDevice* pDevice = ToType(deviceHdl);
+    const AccelerationStructureHandle asHdl = pDevice->m_RtAccelerationStructures.Create();
+
+    if (ToType(pDevice, asHdl) == nullptr)
+    {
+        return {};
+    }
 
     for (uint32_t i = 0; i < instanceCount; ++i)
     {
         const RayTracingInstanceDesc& rtDesc = pRtInstances[i];
-        const Buffer* const pIndexBuffer = AsType<Buffer>(rtDesc.m_IndexBuffer);
-        const Buffer* const pVertexPosBuffer = AsType<Buffer>(rtDesc.m_VertexPosBuffer);
+        const Buffer* const pIndexBuffer = ToType(pDevice, rtDesc.m_IndexBuffer);
+        const Buffer* const pVertexPosBuffer = ToType(pDevice, rtDesc.m_VertexPosBuffer);
 
         D3D12_RAYTRACING_GEOMETRY_DESC geometryDesc = {};
         geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
@@ -1424,26 +1502,25 @@ AccelerationStructureHandle device::CreateRtAccelerationStructure(
 	topLevelInputs.NumDescs = instanceCount;
 	topLevelInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
 
-    RtAccelerationStructure* pAs = spAs.release();
-    return AsHandle<AccelerationStructureHandle>(pAs);
+    return asHdl;
 }
 
 ShaderResourceViewHandle device::GetTextureSrv(const GpuDeviceHandle deviceHdl, const TextureHandle hdl)
 {
-    Texture* pTexture = ToType(hdl);
+    Texture* pTexture = ToType(ToType(deviceHdl), hdl);
     return pTexture->m_srvHeapOffset;
 }
 
 UnorderedAccessViewHandle device::GetTextureUav(const GpuDeviceHandle deviceHdl, const TextureHandle hdl)
 {
-    Texture* pTexture = ToType(hdl);
+    Texture* pTexture = ToType(ToType(deviceHdl), hdl);
     return pTexture->m_uavHeapOffset;
 }
 
 void* device::MapBuffer(GpuDeviceHandle deviceHdl, BufferHandle hdl)
 {
     GpuDevice* pGpuDevice = ToType(deviceHdl);
-    Buffer* pBuffer = ToType(hdl);
+    Buffer* pBuffer = ToType(pGpuDevice, hdl);
 
     const uint64_t currentFrame = pGpuDevice->m_currentFrame;
     const uint64_t currentUploadHeapIndex = currentFrame % (pGpuDevice->m_framesOfLatency + 1);
@@ -1467,7 +1544,7 @@ void* device::MapBuffer(GpuDeviceHandle deviceHdl, BufferHandle hdl)
 void device::UnmapBuffer(GpuDeviceHandle deviceHdl, BufferHandle hdl)
 {
     GpuDevice* pGpuDevice = ToType(deviceHdl);
-    Buffer* pBuffer = ToType(hdl);
+    Buffer* pBuffer = ToType(pGpuDevice, hdl);
 
     pBuffer->m_currentUploadHeap->Unmap(0, nullptr);
 
@@ -1487,7 +1564,7 @@ void device::UnmapBuffer(GpuDeviceHandle deviceHdl, BufferHandle hdl)
 void* device::MapTexture(GpuDeviceHandle deviceHdl, TextureHandle hdl)
 {
     GpuDevice* pGpuDevice = ToType(deviceHdl);
-    Texture* pTexture = ToType(hdl);
+    Texture* pTexture = ToType(pGpuDevice, hdl);
 
     const uint64_t currentFrame = pGpuDevice->m_currentFrame;
     const uint64_t currentUploadHeapIndex = currentFrame % (pGpuDevice->m_framesOfLatency + 1);
@@ -1512,7 +1589,7 @@ void* device::MapTexture(GpuDeviceHandle deviceHdl, TextureHandle hdl)
 void device::UnmapTexture(GpuDeviceHandle deviceHdl, TextureHandle hdl)
 {
     GpuDevice* pGpuDevice = ToType(deviceHdl);
-    Texture* pTexture = ToType(hdl);
+    Texture* pTexture = ToType(pGpuDevice, hdl);
 
     pTexture->m_currentUploadHeap->Unmap(0, nullptr);
 
@@ -1587,6 +1664,11 @@ void device::DestroyDevice(GpuDeviceHandle hdl)
 
     pDevice->m_CommandBuffers.Clear();
 
+    for (UploadHeap& uploadHeap : pDevice->m_UploadHeaps)
+    {
+        uploadHeap.~UploadHeap();
+    }
+
 #ifdef _DEBUG
     ComPtr<IDXGIDebug> pDebug = pDevice->m_pDebug;
 #endif
@@ -1608,9 +1690,17 @@ void device::DestroyCommandQueue(CommandQueueHandle hdl)
     pCmdQueue->Release();
 }
 
-void device::DestroySwapChain(SwapChainHandle /*hdl*/)
+void device::DestroySwapChain(SwapChainHandle hdl)
 {
+    SwapChain* pInternalSwapChain;
+    AsType(pInternalSwapChain, hdl);
+
+    for (const TextureHandle backBufferHdl : pInternalSwapChain->m_backBuffers)
+    {
+        DestroyTextureAndViews(pInternalSwapChain->m_pDevice, backBufferHdl);
+    }
 
+    delete pInternalSwapChain;
 }
 
 void device::DestroyShaderResourceLayout(ShaderResourceLayoutHandle /*hdl*/)
@@ -1637,12 +1727,20 @@ void device::DestroyDescriptorHeap(DescriptorHeapHandle /*hdl*/)
 
 void device::DestroyBuffer(GpuDeviceHandle deviceHdl, BufferHandle bufferHdl)
 {
-    // TODO
+    GpuDevice* pDevice = ToType(deviceHdl);
+    pDevice->m_Buffers.Destroy(bufferHdl);
 }
 
 void device::DestroyTexture(GpuDeviceHandle deviceHdl, TextureHandle textureHdl)
 {
-    // TODO
+    GpuDevice* pDevice = ToType(deviceHdl);
+    DestroyTextureAndViews(pDevice, textureHdl);
+}
+
+void device::DestroyRtAccelerationStructure(GpuDeviceHandle deviceHdl, AccelerationStructureHandle asHdl)
+{
+    GpuDevice* pDevice = ToType(deviceHdl);
+    pDevice->m_RtAccelerationStructures.Destroy(asHdl);
 }
 
 void device::SignalFence(FenceHandle /*fenceHdl*/)
@@ -77,6 +77,9 @@ namespace biome::rhi
         void*                       MapTexture(GpuDeviceHandle deviceHdl, TextureHandle hdl);
         void                        UnmapTexture(GpuDeviceHandle deviceHdl, TextureHandle hdl);
 
+        // Resources are released immediately, along with their descriptors. The caller must make
+        // sure the GPU is done with them first, e.g. with `DrainPipeline` or once the frames of
+        // latency which used them have completed.
         void                        DestroyDevice(GpuDeviceHandle hdl);
         void                        DestroyCommandQueue(CommandQueueHandle hdl);
         void                        DestroySwapChain(SwapChainHandle hdl);
@@ -86,6 +89,7 @@ namespace biome::rhi
         void                        DestroyDescriptorHeap(DescriptorHeapHandle hdl);
         void                        DestroyBuffer(GpuDeviceHandle deviceHdl, BufferHandle bufferHdl);
         void                        DestroyTexture(GpuDeviceHandle deviceHdl, TextureHandle textureHdl);
+        void                        DestroyRtAccelerationStructure(GpuDeviceHandle deviceHdl, AccelerationStructureHandle asHdl);
 
         void                        SignalFence(FenceHandle fenceHdl);
         void                        GPUWaitOnFence(FenceHandle fenceHdl);
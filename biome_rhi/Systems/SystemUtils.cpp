@@ -6,7 +6,11 @@ using namespace biome::rhi::resources;
 
 DescriptorHandle util::GetDescriptorHandle(DescriptorHeap& heap)
 {
-	const INT heapOffset = static_cast<INT>(heap.m_OffsetAllocator.AllocatePages(1));
+	INT heapOffset = 0;
+	{
+		std::lock_guard<std::mutex> lck(heap.m_Mutex);
+		heapOffset = static_cast<INT>(heap.m_OffsetAllocator.AllocatePages(1));
+	}
 
 	DescriptorHandle descriptorHdl = {};
 	descriptorHdl.m_heapOffset = static_cast<uint32_t>(heapOffset);
@@ -29,5 +33,11 @@ void util::ReleaseDescriptorHandle(DescriptorHeap& heap, DescriptorHandle& handl
 	const uint64_t startHandleOffset = heap.m_pDescriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
 	const uint64_t offset = handleOffset - startHandleOffset;
 	BIOME_ASSERT(offset == handle.m_heapOffset);
-	heap.m_OffsetAllocator.Release(offset);
+	ReleaseDescriptor(heap, handle.m_heapOffset);
+}
+
+void util::ReleaseDescriptor(DescriptorHeap& heap, uint32_t heapOffset)
+{
+	std::lock_guard<std::mutex> lck(heap.m_Mutex);
+	BIOME_ASSERT_ALWAYS_EXEC(heap.m_OffsetAllocator.Release(heapOffset));
 }
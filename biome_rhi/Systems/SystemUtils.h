@@ -8,5 +8,6 @@ namespace biome::rhi
 	{
 		resources::DescriptorHandle GetDescriptorHandle(resources::DescriptorHeap& heap);
 		void ReleaseDescriptorHandle(resources::DescriptorHeap& heap, resources::DescriptorHandle& handle);
+		void ReleaseDescriptor(resources::DescriptorHeap& heap, uint32_t heapOffset);
 	}
 }
\ No newline at end of file